@@ -0,0 +1,225 @@
+#include "aadhar_index.h"
+#include "field_rules.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace {
+
+// Returns the number of bits of the largest Aadhar ID of the active rule set.
+constexpr int AadharKeyBits()
+{
+  uint64_t largest = 1;
+  for (size_t i = 0; i < ActiveRules::kAadhar.maxLength; i++)
+  {
+    largest *= 10;
+  }
+  int bits = 0;
+  for (largest -= 1; largest != 0; largest >>= 1)
+  {
+    bits++;
+  }
+  return bits;
+}
+
+// Radix sort parameters: passes of 11 bits cover the key, 4 passes for the
+// 40 bits of a 12 digit ID.
+const int kRadixBits = 11;
+const size_t kBuckets = size_t{1} << kRadixBits;
+const int kPasses = (AadharKeyBits() + kRadixBits - 1) / kRadixBits;
+
+// Rolls smaller than this are sorted on the calling thread.
+const size_t kParallelThreshold = 1 << 16;
+
+struct KeyedPosition {
+  uint64_t key;
+  uint32_t position;
+};
+
+// Runs work(t) for every t in [0, threads) and waits for all of them.
+template <typename Work>
+void RunParallel(unsigned threads, Work work)
+{
+  std::vector<std::thread> workers;
+  for (unsigned t = 1; t < threads; t++)
+  {
+    workers.emplace_back(work, t);
+  }
+  work(0);
+  for (auto& worker : workers)
+  {
+    worker.join();
+  }
+}
+
+}  // namespace
+
+// Packs a numeric Aadhar ID into an integer key.
+//
+// Args:
+//   aadhar: A validated Aadhar ID.
+//
+// Returns:
+//   The ID as an integer; keys order the same way as the IDs.
+uint64_t PackAadhar(std::string_view aadhar)
+{
+  uint64_t key = 0;
+  for (char c : aadhar)
+  {
+    key = key * 10 + static_cast<uint64_t>(c - '0');
+  }
+  return key;
+}
+
+
+// Unpacks a key made by PackAadhar.
+//
+// Args:
+//   key: A packed Aadhar ID.
+//
+// Returns:
+//   The Aadhar ID, padded with leading zeros to the fixed Aadhar length.
+std::string UnpackAadhar(uint64_t key)
+{
+  std::string aadhar(ActiveRules::kAadhar.maxLength, '0');
+  for (size_t i = aadhar.size(); i-- > 0 && key > 0; key /= 10)
+  {
+    aadhar[i] = static_cast<char>('0' + key % 10);
+  }
+  return aadhar;
+}
+
+
+// Computes the order that sorts the keys, using a parallel LSD radix sort.
+//
+// Args:
+//   keys: Packed Aadhar IDs.
+//
+// Returns:
+//   The positions of the keys in ascending key order.
+std::vector<uint32_t> RadixSortOrder(const std::vector<uint64_t>& keys)
+{
+  size_t n = keys.size();
+  std::vector<KeyedPosition> items(n), scratch(n);
+  for (size_t i = 0; i < n; i++)
+  {
+    items[i] = {keys[i], static_cast<uint32_t>(i)};
+  }
+
+  unsigned threads = 1;
+  if (n >= kParallelThreshold)
+  {
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  size_t chunk = (n + threads - 1) / threads;
+  std::vector<size_t> counts(threads * kBuckets);
+
+  for (int pass = 0; pass < kPasses; pass++)
+  {
+    int shift = pass * kRadixBits;
+    auto digit = [shift](uint64_t key) { return (key >> shift) & (kBuckets - 1); };
+
+    // Per thread histograms of the current digit:
+    std::fill(counts.begin(), counts.end(), 0);
+    RunParallel(threads, [&](unsigned t) {
+      size_t* histogram = &counts[t * kBuckets];
+      for (size_t i = t * chunk; i < std::min(n, (t + 1) * chunk); i++)
+      {
+        histogram[digit(items[i].key)]++;
+      }
+    });
+
+    // Exclusive prefix sum in (bucket, thread) order keeps the sort stable:
+    size_t sum = 0;
+    bool single = false;
+    for (size_t b = 0; b < kBuckets; b++)
+    {
+      size_t bucket = 0;
+      for (unsigned t = 0; t < threads; t++)
+      {
+        size_t count = counts[t * kBuckets + b];
+        counts[t * kBuckets + b] = sum;
+        sum += count;
+        bucket += count;
+      }
+      single = single || bucket == n;
+    }
+    if (single)
+    {
+      continue;  // Every key has the same digit, the pass would not move anything.
+    }
+
+    RunParallel(threads, [&](unsigned t) {
+      size_t* offsets = &counts[t * kBuckets];
+      for (size_t i = t * chunk; i < std::min(n, (t + 1) * chunk); i++)
+      {
+        scratch[offsets[digit(items[i].key)]++] = items[i];
+      }
+    });
+    items.swap(scratch);
+  }
+
+  std::vector<uint32_t> order(n);
+  for (size_t i = 0; i < n; i++)
+  {
+    order[i] = items[i].position;
+  }
+  return order;
+}
+
+
+// Finds a key in a sorted key vector by interpolation search. Falls back to
+// bisection when the keys are too skewed for interpolation to make progress.
+//
+// Args:
+//   keys: Packed Aadhar IDs in ascending order.
+//   key: The packed Aadhar ID to find.
+//
+// Returns:
+//   The position of the key, or -1 if it is not present.
+long InterpolationSearch(const std::vector<uint64_t>& keys, uint64_t key)
+{
+  if (keys.empty())
+  {
+    return -1;
+  }
+
+  size_t low = 0, high = keys.size() - 1;
+  int probes = 0;
+  while (low <= high && key >= keys[low] && key <= keys[high])
+  {
+    size_t mid;
+    if (keys[high] == keys[low])
+    {
+      mid = low;
+    }
+    else if (++probes <= 8)
+    {
+      // Estimate the position from the key's place between the bounds:
+      long double fraction = static_cast<long double>(key - keys[low]) / (keys[high] - keys[low]);
+      mid = low + static_cast<size_t>(fraction * (high - low));
+    }
+    else
+    {
+      mid = low + (high - low) / 2;
+    }
+
+    if (keys[mid] == key)
+    {
+      return static_cast<long>(mid);
+    }
+    if (keys[mid] < key)
+    {
+      low = mid + 1;
+    }
+    else
+    {
+      if (mid == 0)
+      {
+        break;
+      }
+      high = mid - 1;
+    }
+  }
+  return -1;
+}
@@ -0,0 +1,51 @@
+#ifndef AADHAR_INDEX
+#define AADHAR_INDEX
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Packs a numeric Aadhar ID into an integer key.
+//
+// Args:
+//   aadhar: A validated Aadhar ID.
+//
+// Returns:
+//   The ID as an integer; keys order the same way as the IDs.
+uint64_t PackAadhar(std::string_view aadhar);
+
+
+// Unpacks a key made by PackAadhar.
+//
+// Args:
+//   key: A packed Aadhar ID.
+//
+// Returns:
+//   The Aadhar ID, padded with leading zeros to the fixed Aadhar length.
+std::string UnpackAadhar(uint64_t key);
+
+
+// Computes the order that sorts the keys, using a parallel LSD radix sort.
+//
+// Args:
+//   keys: Packed Aadhar IDs.
+//
+// Returns:
+//   The positions of the keys in ascending key order.
+std::vector<uint32_t> RadixSortOrder(const std::vector<uint64_t>& keys);
+
+
+// Finds a key in a sorted key vector by interpolation search. Falls back to
+// bisection when the keys are too skewed for interpolation to make progress.
+//
+// Args:
+//   keys: Packed Aadhar IDs in ascending order.
+//   key: The packed Aadhar ID to find.
+//
+// Returns:
+//   The position of the key, or -1 if it is not present.
+long InterpolationSearch(const std::vector<uint64_t>& keys, uint64_t key);
+
+#endif
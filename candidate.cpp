@@ -9,7 +9,7 @@
 //   reg: The candidate's region ID.
 //   votes: The initial number of votes (default: 0).
 Candidate::Candidate(const std::string& id, const std::string& name, const std::string& symbol,
-                     const std::string& regionCode, int votes)
+                     const std::string& regionCode, int64_t votes)
     : candidateID(id), candidateName(name), partySymbol(symbol), regionID(regionCode), numOfVotes(votes) {
 }
 
@@ -18,10 +18,10 @@ std::string Candidate::GetCandidateID() const { return candidateID; }
 std::string Candidate::GetCandidateName() const { return candidateName; }
 std::string Candidate::GetPartySymbol() const { return partySymbol; }
 std::string Candidate::GetRegion() const { return regionID; }
-int Candidate::GetNumOfVotes() const { return numOfVotes; }
+int64_t Candidate::GetNumOfVotes() const { return numOfVotes; }
 
 void Candidate::SetCandidateID(const std::string& id) { candidateID = id; }
 void Candidate::SetCandidateName(const std::string& name) { candidateName= name; }
 void Candidate::SetPartySymbol(const std::string& symbol) { partySymbol= symbol; }
 void Candidate::SetRegion(const std::string& regionCode) { regionID= regionCode; }
-void Candidate::SetVotes(int votes) { numOfVotes = votes; }
+void Candidate::SetVotes(int64_t votes) { numOfVotes = votes; }
@@ -1,6 +1,7 @@
 #ifndef CANDIDATE 
 #define CANDIDATE
 
+#include <cstdint>
 #include <string>
 
 class Candidate {
@@ -14,20 +15,20 @@ public:
     //   reg: The candidate's region ID.
     //   votes: The initial number of votes (default: 0).
     Candidate(const std::string& id, const std::string& name, const std::string& symbol,
-              const std::string& regionCode, int votes = 0);
+              const std::string& regionCode, int64_t votes = 0);
 
     // Getters and setters for candidate properties.
     std::string GetCandidateID() const;
     std::string GetCandidateName() const;
     std::string GetPartySymbol() const;
     std::string GetRegion() const;
-    int GetNumOfVotes() const;
+    int64_t GetNumOfVotes() const;
 
     void SetCandidateID(const std::string& id);
     void SetCandidateName(const std::string& name);
     void SetPartySymbol(const std::string& symbol);
     void SetRegion(const std::string& regionCode);
-    void SetVotes(int votes);
+    void SetVotes(int64_t votes);
 
 private:
     // Candidate attributes.
@@ -35,7 +36,7 @@ private:
     std::string candidateName;
     std::string partySymbol;
     std::string regionID;
-    int numOfVotes;
+    int64_t numOfVotes;
 };
 
 #endif
@@ -0,0 +1,119 @@
+#include "candidate_index.h"
+
+#include <algorithm>
+#include <cctype>
+
+namespace {
+
+// Score of a match, by how it matched.
+const double kExactIDScore = 1000;
+const double kPrefixScore[] = {300, 200, 200};  // By field: ID, name, symbol.
+const double kTrigramScore = 100;
+
+std::string Lower(const std::string& text)
+{
+  std::string lower(text);
+  for (char& c : lower)
+  {
+    c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+  }
+  return lower;
+}
+
+uint32_t Trigram(const std::string& text, size_t i)
+{
+  return (uint32_t{static_cast<unsigned char>(text[i])} << 16) |
+         (uint32_t{static_cast<unsigned char>(text[i + 1])} << 8) |
+         uint32_t{static_cast<unsigned char>(text[i + 2])};
+}
+
+}  // namespace
+
+// Rebuilds the index over a candidate list.
+void CandidateSearchIndex::Build(const std::vector<Candidate>& candidates)
+{
+  terms.clear();
+  trigrams.clear();
+  terms.reserve(candidates.size() * 3);
+
+  for (uint32_t position = 0; position < candidates.size(); position++)
+  {
+    const Candidate& candidate = candidates[position];
+    std::string fields[] = {Lower(candidate.GetCandidateID()), Lower(candidate.GetCandidateName()),
+                            Lower(candidate.GetPartySymbol())};
+    for (uint32_t field = kID; field <= kSymbol; field++)
+    {
+      const std::string& value = fields[field];
+      terms.emplace_back(value, position * 4 + field);
+      for (size_t i = 0; i + 3 <= value.size(); i++)
+      {
+        std::vector<uint32_t>& postings = trigrams[Trigram(value, i)];
+        if (postings.empty() || postings.back() != position)
+        {
+          postings.push_back(position);
+        }
+      }
+    }
+  }
+  std::sort(terms.begin(), terms.end());
+}
+
+// Finds the candidates that best match a query.
+std::vector<size_t> CandidateSearchIndex::Search(const std::string& query, size_t limit) const
+{
+  std::string lower = Lower(query);
+  std::unordered_map<uint32_t, double> scores;
+  if (lower.empty())
+  {
+    return {};
+  }
+
+  // Prefix and exact matches:
+  auto it = std::lower_bound(terms.begin(), terms.end(), std::make_pair(lower, uint32_t{0}));
+  for (; it != terms.end() && it->first.compare(0, lower.size(), lower) == 0; ++it)
+  {
+    uint32_t position = it->second / 4;
+    uint32_t field = it->second % 4;
+    double score = (field == kID && it->first == lower) ? kExactIDScore : kPrefixScore[field];
+    scores[position] = std::max(scores[position], score);
+  }
+
+  // Fuzzy matches by the share of the query's trigrams a candidate contains:
+  if (lower.size() >= 3)
+  {
+    std::unordered_map<uint32_t, int> shared;
+    size_t total = lower.size() - 2;
+    for (size_t i = 0; i < total; i++)
+    {
+      auto postings = trigrams.find(Trigram(lower, i));
+      if (postings != trigrams.end())
+      {
+        for (uint32_t position : postings->second)
+        {
+          shared[position]++;
+        }
+      }
+    }
+    for (const auto& entry : shared)
+    {
+      scores[entry.first] += kTrigramScore * std::min<size_t>(entry.second, total) / total;
+    }
+  }
+
+  // Rank the best matches, ties in list order:
+  std::vector<std::pair<double, uint32_t>> ranked;
+  ranked.reserve(scores.size());
+  for (const auto& entry : scores)
+  {
+    ranked.emplace_back(-entry.second, entry.first);
+  }
+  size_t count = std::min(limit, ranked.size());
+  std::partial_sort(ranked.begin(), ranked.begin() + count, ranked.end());
+
+  std::vector<size_t> matches;
+  for (size_t i = 0; i < count; i++)
+  {
+    matches.push_back(ranked[i].second);
+  }
+  return matches;
+}
@@ -0,0 +1,46 @@
+#ifndef CANDIDATE_INDEX
+#define CANDIDATE_INDEX
+
+#include "candidate.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Search index over candidate ID, name and party symbol for operator lookup.
+//
+// Prefix matches are found by binary search over the sorted, lower-cased field
+// values; fuzzy matches by counting shared trigrams through posting lists.
+// Exact ID matches rank first, then prefix matches, then trigram overlap.
+class CandidateSearchIndex {
+public:
+    // Rebuilds the index over a candidate list.
+    //
+    // Args:
+    //   candidates: The candidates to index; results refer to their positions.
+    void Build(const std::vector<Candidate>& candidates);
+
+    // Finds the candidates that best match a query.
+    //
+    // Args:
+    //   query: Part of a candidate ID, name or party symbol, in any case.
+    //   limit: The maximum number of matches to return.
+    //
+    // Returns:
+    //   Positions in the indexed candidate list, best match first.
+    std::vector<size_t> Search(const std::string& query, size_t limit) const;
+
+private:
+    enum Field : uint32_t { kID = 0, kName = 1, kSymbol = 2 };
+
+    // Sorted (lower-cased field value, position * 4 + field) pairs.
+    std::vector<std::pair<std::string, uint32_t>> terms;
+
+    // Trigram -> positions of the candidates whose fields contain it.
+    std::unordered_map<uint32_t, std::vector<uint32_t>> trigrams;
+};
+
+#endif
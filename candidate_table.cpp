@@ -0,0 +1,45 @@
+#include "candidate_table.h"
+
+#include <algorithm>
+
+// Returns the candidate with an ID, or nullptr if there is none.
+const Candidate* CandidateTable::Find(const std::string& id) const
+{
+  auto it = std::find_if(candidates.begin(), candidates.end(),
+                         [&id](const Candidate& candidate) { return candidate.GetCandidateID() == id; });
+  return it == candidates.end() ? nullptr : &*it;
+}
+
+Candidate* CandidateTable::Find(const std::string& id)
+{
+  return const_cast<Candidate*>(static_cast<const CandidateTable*>(this)->Find(id));
+}
+
+VersionedCandidateTable::VersionedCandidateTable() : current(std::make_shared<CandidateTable>()) {}
+
+// Returns the current version of the table.
+std::shared_ptr<const CandidateTable> VersionedCandidateTable::Current() const
+{
+  return std::atomic_load(&current);
+}
+
+// Publishes a new version with an edit applied.
+bool VersionedCandidateTable::Edit(const std::function<bool(CandidateTable&)>& edit)
+{
+  while (true)
+  {
+    std::shared_ptr<const CandidateTable> base = Current();
+    auto next = std::make_shared<CandidateTable>(*base);
+    if (!edit(*next))
+    {
+      return false;
+    }
+    next->version = base->version + 1;
+
+    // Publish only if no other edit was published since the copy was taken:
+    if (std::atomic_compare_exchange_strong(&current, &base, std::shared_ptr<const CandidateTable>(std::move(next))))
+    {
+      return true;
+    }
+  }
+}
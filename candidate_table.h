@@ -0,0 +1,57 @@
+#ifndef CANDIDATE_TABLE
+#define CANDIDATE_TABLE
+
+#include "candidate.h"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+// One immutable version of the valid candidate table.
+struct CandidateTable {
+    uint64_t version = 0;
+    std::vector<Candidate> candidates;
+    std::set<std::string> ids;      // Candidate IDs in use.
+    std::set<std::string> symbols;  // Party symbols in use.
+
+    // Returns the candidate with an ID, or nullptr if there is none.
+    const Candidate* Find(const std::string& id) const;
+    Candidate* Find(const std::string& id);
+};
+
+
+// Candidate table published as immutable versions.
+//
+// Readers load the current version with an atomic pointer read and keep it
+// alive for as long as they hold it, so they never block and never see an
+// edit half applied. Editors apply their change to a copy of the current
+// version and publish it with an atomic compare-and-swap; if another edit was
+// published in between, the change is reapplied to a copy of the newer one.
+class VersionedCandidateTable {
+public:
+    VersionedCandidateTable();
+
+    VersionedCandidateTable(const VersionedCandidateTable&) = delete;
+    VersionedCandidateTable& operator=(const VersionedCandidateTable&) = delete;
+
+    // Returns the current version of the table.
+    std::shared_ptr<const CandidateTable> Current() const;
+
+    // Publishes a new version with an edit applied.
+    //
+    // Args:
+    //   edit: Applies the edit to a copy of the current version. It may run
+    //         more than once and returns false to abandon the edit.
+    //
+    // Returns:
+    //   true if the edit was published, false if it was abandoned.
+    bool Edit(const std::function<bool(CandidateTable&)>& edit);
+
+private:
+    std::shared_ptr<const CandidateTable> current;  // Accessed with std::atomic_load/store.
+};
+
+#endif
@@ -0,0 +1,316 @@
+#include "credential.h"
+#include "field_parser.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace {
+
+typedef std::array<uint8_t, 32> Block;
+
+// Number of random blocks mixed into each block per round.
+const uint32_t kDelta = 3;
+
+// Minimal SHA-256 (FIPS 180-4).
+class Sha256 {
+public:
+  void Update(const uint8_t* data, size_t length)
+  {
+    total += length;
+    while (length > 0)
+    {
+      size_t take = std::min(length, sizeof(buffer) - used);
+      std::memcpy(buffer + used, data, take);
+      used += take;
+      data += take;
+      length -= take;
+      if (used == sizeof(buffer))
+      {
+        Compress(buffer);
+        used = 0;
+      }
+    }
+  }
+
+  void Update(uint64_t value)
+  {
+    uint8_t bytes[8];
+    for (int i = 0; i < 8; i++)
+    {
+      bytes[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+    Update(bytes, sizeof(bytes));
+  }
+
+  Block Final()
+  {
+    uint64_t bits = total * 8;
+    uint8_t pad = 0x80;
+    Update(&pad, 1);
+    pad = 0;
+    while (used != 56)
+    {
+      Update(&pad, 1);
+    }
+    uint8_t length[8];
+    for (int i = 0; i < 8; i++)
+    {
+      length[i] = static_cast<uint8_t>(bits >> (56 - 8 * i));
+    }
+    Update(length, sizeof(length));
+
+    Block digest;
+    for (int i = 0; i < 8; i++)
+    {
+      for (int j = 0; j < 4; j++)
+      {
+        digest[i * 4 + j] = static_cast<uint8_t>(state[i] >> (24 - 8 * j));
+      }
+    }
+    return digest;
+  }
+
+private:
+  static uint32_t Rotate(uint32_t x, int n) { return (x >> n) | (x << (32 - n)); }
+
+  void Compress(const uint8_t* chunk)
+  {
+    static const uint32_t k[64] = {
+      0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+      0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+      0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+      0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+      0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+      0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+      0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+      0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+    uint32_t w[64];
+    for (int i = 0; i < 16; i++)
+    {
+      w[i] = (uint32_t{chunk[4 * i]} << 24) | (uint32_t{chunk[4 * i + 1]} << 16) |
+             (uint32_t{chunk[4 * i + 2]} << 8) | uint32_t{chunk[4 * i + 3]};
+    }
+    for (int i = 16; i < 64; i++)
+    {
+      uint32_t s0 = Rotate(w[i - 15], 7) ^ Rotate(w[i - 15], 18) ^ (w[i - 15] >> 3);
+      uint32_t s1 = Rotate(w[i - 2], 17) ^ Rotate(w[i - 2], 19) ^ (w[i - 2] >> 10);
+      w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+    uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+    for (int i = 0; i < 64; i++)
+    {
+      uint32_t s1 = Rotate(e, 6) ^ Rotate(e, 11) ^ Rotate(e, 25);
+      uint32_t choice = (e & f) ^ (~e & g);
+      uint32_t t1 = h + s1 + choice + k[i] + w[i];
+      uint32_t s0 = Rotate(a, 2) ^ Rotate(a, 13) ^ Rotate(a, 22);
+      uint32_t majority = (a & b) ^ (a & c) ^ (b & c);
+      uint32_t t2 = s0 + majority;
+      h = g;
+      g = f;
+      f = e;
+      e = d + t1;
+      d = c;
+      c = b;
+      b = a;
+      a = t1 + t2;
+    }
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
+  }
+
+  uint32_t state[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                       0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+  uint8_t buffer[64];
+  size_t used = 0;
+  uint64_t total = 0;
+};
+
+// Balloon hashing (Boneh, Corrigan-Gibbs, Schechter) over SHA-256.
+Block Balloon(const std::string& password, const std::array<uint8_t, 16>& salt,
+              uint32_t spaceCost, uint32_t timeCost)
+{
+  std::vector<Block> blocks(spaceCost);
+  uint64_t counter = 0;
+
+  // Expand the password and salt into the buffer:
+  Sha256 first;
+  first.Update(counter++);
+  first.Update(reinterpret_cast<const uint8_t*>(password.data()), password.size());
+  first.Update(salt.data(), salt.size());
+  blocks[0] = first.Final();
+  for (uint32_t m = 1; m < spaceCost; m++)
+  {
+    Sha256 expand;
+    expand.Update(counter++);
+    expand.Update(blocks[m - 1].data(), blocks[m - 1].size());
+    blocks[m] = expand.Final();
+  }
+
+  // Mix each block with its predecessor and with pseudo-random other blocks:
+  for (uint32_t t = 0; t < timeCost; t++)
+  {
+    for (uint32_t m = 0; m < spaceCost; m++)
+    {
+      const Block& previous = blocks[(m + spaceCost - 1) % spaceCost];
+      Sha256 mix;
+      mix.Update(counter++);
+      mix.Update(previous.data(), previous.size());
+      mix.Update(blocks[m].data(), blocks[m].size());
+      blocks[m] = mix.Final();
+
+      for (uint32_t i = 0; i < kDelta; i++)
+      {
+        Sha256 index;
+        index.Update(counter++);
+        index.Update(salt.data(), salt.size());
+        index.Update((uint64_t{t} << 32) | m);
+        index.Update(i);
+        Block choice = index.Final();
+        uint64_t other = 0;
+        for (int j = 0; j < 8; j++)
+        {
+          other |= uint64_t{choice[j]} << (8 * j);
+        }
+        other %= spaceCost;
+
+        Sha256 random;
+        random.Update(counter++);
+        random.Update(blocks[m].data(), blocks[m].size());
+        random.Update(blocks[other].data(), blocks[other].size());
+        blocks[m] = random.Final();
+      }
+    }
+  }
+  return blocks[spaceCost - 1];
+}
+
+std::string ToHex(const uint8_t* data, size_t length)
+{
+  static const char digits[] = "0123456789abcdef";
+  std::string text;
+  for (size_t i = 0; i < length; i++)
+  {
+    text += digits[data[i] >> 4];
+    text += digits[data[i] & 0xf];
+  }
+  return text;
+}
+
+bool FromHex(std::string_view text, uint8_t* data, size_t length)
+{
+  if (text.size() != length * 2)
+  {
+    return false;
+  }
+  for (size_t i = 0; i < text.size(); i++)
+  {
+    char c = text[i];
+    int value = (c >= '0' && c <= '9') ? c - '0' : (c >= 'a' && c <= 'f') ? c - 'a' + 10 : -1;
+    if (value < 0)
+    {
+      return false;
+    }
+    data[i / 2] = static_cast<uint8_t>(i % 2 == 0 ? value << 4 : data[i / 2] | value);
+  }
+  return true;
+}
+
+}  // namespace
+
+// Creates a record for a password with a fresh random salt.
+CredentialRecord CredentialRecord::Create(const std::string& password, uint32_t spaceCost, uint32_t timeCost)
+{
+  CredentialRecord record;
+  record.spaceCost = std::min(std::max<uint32_t>(spaceCost, 1), kMaxSpaceCost);
+  record.timeCost = std::min(std::max<uint32_t>(timeCost, 1), kMaxTimeCost);
+
+  std::random_device random;
+  for (size_t i = 0; i < record.salt.size(); i += 4)
+  {
+    uint32_t value = random();
+    std::memcpy(record.salt.data() + i, &value, 4);
+  }
+
+  record.hash = Balloon(password, record.salt, record.spaceCost, record.timeCost);
+  return record;
+}
+
+// Parses the text form of a record.
+bool CredentialRecord::Parse(const std::string& text, CredentialRecord& record)
+{
+  CsvFields fields(text, '$');
+  std::string_view scheme, space, time, salt, hash;
+  int64_t spaceCost = 0, timeCost = 0;
+  if (!fields.Next(scheme) || scheme != "balloon" ||
+      !fields.Next(space) || !fields.Next(time) || !fields.Next(salt) || !fields.Next(hash) ||
+      !ParseCount(space, spaceCost) || !ParseCount(time, timeCost))
+  {
+    return false;
+  }
+  if (spaceCost == 0 || timeCost == 0 || spaceCost > kMaxSpaceCost || timeCost > kMaxTimeCost)
+  {
+    return false;
+  }
+  record.spaceCost = static_cast<uint32_t>(spaceCost);
+  record.timeCost = static_cast<uint32_t>(timeCost);
+
+  return FromHex(salt, record.salt.data(), record.salt.size()) &&
+         FromHex(hash, record.hash.data(), record.hash.size());
+}
+
+std::string CredentialRecord::ToString() const
+{
+  return "balloon$" + std::to_string(spaceCost) + "$" + std::to_string(timeCost) + "$" +
+         ToHex(salt.data(), salt.size()) + "$" + ToHex(hash.data(), hash.size());
+}
+
+// Checks a password against the record, comparing hashes in constant time.
+bool CredentialRecord::Verify(const std::string& password) const
+{
+  Block candidate = Balloon(password, salt, spaceCost, timeCost);
+  uint8_t difference = 0;
+  for (size_t i = 0; i < hash.size(); i++)
+  {
+    difference |= candidate[i] ^ hash[i];
+  }
+  return difference == 0;
+}
+
+// Picks the space cost that makes hashing with the given time cost take about
+// the target latency on this machine.
+uint32_t CalibrateSpaceCost(double targetMs, uint32_t timeCost, double& measuredMs)
+{
+  std::array<uint8_t, 16> salt{};
+  uint32_t spaceCost = 256;
+  while (true)
+  {
+    auto start = std::chrono::steady_clock::now();
+    Balloon("calibration", salt, spaceCost, timeCost);
+    measuredMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    // Hashing time is linear in the space cost, so scale to the target once
+    // the measurement is long enough to be reliable:
+    if (measuredMs >= 20 || measuredMs >= targetMs || spaceCost >= CredentialRecord::kMaxSpaceCost)
+    {
+      double scaled = spaceCost * targetMs / std::max(measuredMs, 0.001);
+      spaceCost = static_cast<uint32_t>(std::min(std::max(scaled, 16.0), double(CredentialRecord::kMaxSpaceCost)));
+      start = std::chrono::steady_clock::now();
+      Balloon("calibration", salt, spaceCost, timeCost);
+      measuredMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+      return spaceCost;
+    }
+    spaceCost *= 2;
+  }
+}
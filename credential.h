@@ -0,0 +1,80 @@
+#ifndef CREDENTIAL
+#define CREDENTIAL
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+// Salted, memory-hard password verification record.
+//
+// The password is hashed with balloon hashing over SHA-256: spaceCost 32 byte
+// blocks are filled and mixed timeCost times with data-independent random
+// lookups. Only the salt, the cost parameters and the resulting hash are kept,
+// so the password itself is never stored. The text form is
+// "balloon$<spaceCost>$<timeCost>$<salt hex>$<hash hex>".
+class CredentialRecord {
+public:
+    static constexpr uint32_t kDefaultSpaceCost = 8192;  // 256 KiB of blocks.
+    static constexpr uint32_t kDefaultTimeCost = 3;
+
+    // Largest costs a record can have. Parse rejects records above them, so
+    // records are never created with larger costs.
+    static constexpr uint32_t kMaxSpaceCost = uint32_t{1} << 24;  // 512 MiB of blocks.
+    static constexpr uint32_t kMaxTimeCost = 64;
+
+    // Creates a record for a password with a fresh random salt.
+    //
+    // Args:
+    //   password: The password to protect.
+    //   spaceCost: The number of 32 byte blocks the hash fills, clamped to
+    //              1..kMaxSpaceCost.
+    //   timeCost: The number of mixing rounds over the blocks, clamped to
+    //             1..kMaxTimeCost.
+    //
+    // Returns:
+    //   The verification record.
+    static CredentialRecord Create(const std::string& password, uint32_t spaceCost = kDefaultSpaceCost,
+                                   uint32_t timeCost = kDefaultTimeCost);
+
+    // Parses the text form of a record.
+    //
+    // Args:
+    //   text: The text form, as produced by ToString.
+    //   record: Receives the parsed record.
+    //
+    // Returns:
+    //   true if the text is a well-formed record, false otherwise.
+    static bool Parse(const std::string& text, CredentialRecord& record);
+
+    std::string ToString() const;
+
+    // Checks a password against the record, comparing hashes in constant time.
+    //
+    // Args:
+    //   password: The password to check.
+    //
+    // Returns:
+    //   true if the password matches, false otherwise.
+    bool Verify(const std::string& password) const;
+
+private:
+    uint32_t spaceCost = kDefaultSpaceCost;
+    uint32_t timeCost = kDefaultTimeCost;
+    std::array<uint8_t, 16> salt{};
+    std::array<uint8_t, 32> hash{};
+};
+
+
+// Picks the space cost that makes hashing with the given time cost take about
+// the target latency on this machine.
+//
+// Args:
+//   targetMs: The target hashing latency in milliseconds.
+//   timeCost: The time cost to calibrate for.
+//   measuredMs: Receives the measured latency of the chosen cost.
+//
+// Returns:
+//   The space cost in blocks.
+uint32_t CalibrateSpaceCost(double targetMs, uint32_t timeCost, double& measuredMs);
+
+#endif
@@ -4,7 +4,8 @@
 
   // Class representing the core functionality of the election management system.
 
-  // Reads admin credentials from a CSV file, validates them, and stores valid pairs.
+  // Reads admin credentials from a CSV file, validates them, and stores their
+  // verification records. Legacy plaintext rows are replaced by records on disk.
   //
   // Returns:
   //   true if at least one valid admin is found, false otherwise.
@@ -12,7 +13,7 @@
   bool ElectionSystem::AdminCsvCheck() 
   {
     // Open the CSV file containing admin credentials.
-    std::ifstream adminInputFile("Admin.csv"); 
+    std::ifstream adminInputFile(DataPath("Admin.csv")); 
 
     // Check if the file was opened successfully.
     if (!adminInputFile.is_open()) 
@@ -22,39 +23,106 @@
     }
 
     // Process each line in the CSV file.
+    bool upgraded = false;
     std::string line;
     while (std::getline(adminInputFile, line)) 
     {
-      std::istringstream ss(line);
-      std::string username, password, hash;
+      CsvFields fields(line);
+      std::string_view usernameField, secretField, hashField;
+      CredentialRecord record;
 
-      // Extract username, password, and hash from the line.
-      if (std::getline(ss, username, ',') &&
-          std::getline(ss, password, ',') &&
-          std::getline(ss, hash, ',')) 
-       {
-        // Validate the credentials by checking the checksum.
-        if (CalculateCheckSum(username + password) == hash)
+      // Extract username and the password or its verification record from the line.
+      bool complete = fields.Next(usernameField) && fields.Next(secretField);
+      std::string username(usernameField), secret(secretField), hash;
+      if (!complete)
+      {
+        std::cerr << "Invalid Format Skipping line " << line << '\n';
+        if (!line.empty())
+        {
+          adminUnparsedRows.push_back(line);
+        }
+      }
+      else if (fields.Next(hashField))
+      {
+        hash = std::string(hashField);
+        // Legacy row: validate the credentials by checking the checksum and
+        // keep only a verification record of the password.
+        if (CalculateCheckSum(username + secret) == hash)
         {
-          // Store the valid username-password pair.
-          adminValidate[username] = password;
+          adminCredentials[username] = CredentialRecord::Create(secret, adminSpaceCost, adminTimeCost);
+          upgraded = true;
         }
         else
         {
           std::cerr << "checksum does not match\n";
+          adminUnparsedRows.push_back(line);
         }
       } 
+      else if (CredentialRecord::Parse(secret, record))
+      {
+        adminCredentials[username] = record;
+      }
       else
       {
         std::cerr << "Invalid Format Skipping line " << line << '\n';
+        adminUnparsedRows.push_back(line);
       }
     }
 
     // Close the CSV file.
     adminInputFile.close();
 
+    // Remove the plaintext passwords from disk:
+    if (upgraded)
+    {
+      WriteAdminDataToCSV();
+    }
+
     // Return true if at least one valid admin was found.
-    return adminValidate.size() >= 1;
+    return adminCredentials.size() >= 1;
+  }
+
+  // Sets the cost of the verification records created for legacy admin rows.
+  //
+  // Args:
+  //   spaceCost: The number of 32 byte blocks the password hash fills.
+  //   timeCost: The number of mixing rounds over the blocks.
+  void ElectionSystem::SetAdminHashCost(uint32_t spaceCost, uint32_t timeCost)
+  {
+    adminSpaceCost = spaceCost;
+    adminTimeCost = timeCost;
+  }
+
+  // Writes the admin verification records, and the rows that could not be
+  // read, beside Admin.csv and renames them into place.
+  void ElectionSystem::WriteAdminDataToCSV()
+  {
+    std::string path = DataPath("Admin.csv");
+    std::string temporary = path + ".tmp";
+    std::ofstream outputFile(temporary);
+    if (!outputFile.is_open())
+    {
+      std::cerr << "Error opening the output admin file.\n";
+      return;
+    }
+
+    for (const auto& entry : adminCredentials)
+    {
+      outputFile << entry.first << "," << entry.second.ToString() << "\n";
+    }
+
+    // Rows that failed to parse stay for the operator to fix:
+    for (const std::string& row : adminUnparsedRows)
+    {
+      outputFile << row << "\n";
+    }
+
+    outputFile.close();
+    if (!outputFile || std::rename(temporary.c_str(), path.c_str()) != 0)
+    {
+      std::cerr << "Error writing the admin file.\n";
+      std::remove(temporary.c_str());
+    }
   }
 
   // Calculates a simple checksum by shifting each character in the message by a fixed value.
@@ -67,6 +135,7 @@
   std::string ElectionSystem::CalculateCheckSum(const std::string& message) 
 {
    std::string hash = "";
+   hash.reserve(message.size());
    int shift = 5;
 
    for (unsigned char ch : message)
@@ -87,27 +156,31 @@
   //   true if the ID is valid, false otherwise.
 bool ElectionSystem::ValidateCandidateID(const std::string& id)
 {
-    if (idSet.find(id) != idSet.end())
+    return ValidateCandidateID(id, *validCandidates.Current());
+}
+
+  // Validates a candidate ID against a given candidate table version.
+  //
+  // Args:
+  //   id: The candidate ID to validate.
+  //   table: The table the ID must be unique in.
+  //
+  // Returns:
+  //   true if the ID is valid, false otherwise.
+bool ElectionSystem::ValidateCandidateID(const std::string& id, const CandidateTable& table)
+{
+    if (table.ids.find(id) != table.ids.end())
     {
         errorMessage = "Candidate ID already exists. Please enter a different ID.";
         return false;
     }
 
-    if (id.length() < 3 || id.length() > 5 ||
-        !std::any_of(id.begin(), id.end(), ::isdigit) ||
-        !std::any_of(id.begin(), id.end(), ::isalpha))
+    if (!MatchesField<ActiveRules::kCandidateID>(id))
     {
         errorMessage = "Invalid Candidate ID format.";
         return false;
     }
 
-    if (std::none_of(id.begin(), id.end(), ::isdigit) ||
-        std::none_of(id.begin(), id.end(), ::isalpha))
-    {
-        errorMessage = "Candidate ID should contain at least one alpha and one numeric character.";
-        return false;
-    }
-
     errorMessage = "";
     return true;
 }
@@ -121,22 +194,19 @@ bool ElectionSystem::ValidateCandidateID(const std::string& id)
   //   true if the name is valid, false otherwise.
   bool ElectionSystem::ValidateCandidateName(const std::string& name)
   {
-    // Validate the length of the name:
-    // - Must be between 2 and 20 characters.
-    if (name.length() < 2 || name.length() > 20)
-    {
-      // error message about Length.
-      errorMessage =  "Invalid Candidate Name length.";
-      return false;
-    }
-
-    // Validate the format of the name:
-    // - Must consist only of alphabetic characters (A-Z, a-z).
-    if (!std::all_of(name.begin(), name.end(), ::isalpha)) 
+    // Validate the length and the characters of the name (see field_rules.h):
+    switch (CheckField<ActiveRules::kCandidateName>(name))
     {
-      // error message about non-alphabetic characters.
-      errorMessage = "Invalid characters in Candidate Name. Only alphabets are allowed.";
-      return false;
+      case RuleCheck::kOk:
+        break;
+      case RuleCheck::kBadLength:
+        // error message about Length.
+        errorMessage =  "Invalid Candidate Name length.";
+        return false;
+      default:
+        // error message about non-alphabetic characters.
+        errorMessage = "Invalid characters in Candidate Name. Only alphabets are allowed.";
+        return false;
     }
 
     // If all validations pass, the name is considered valid.
@@ -153,29 +223,39 @@ bool ElectionSystem::ValidateCandidateID(const std::string& id)
   // Returns:
   //   true if the symbol is valid, false otherwise.
   bool ElectionSystem:: ValidatePartySymbol(const std::string& symbol)
+  {
+    return ValidatePartySymbol(symbol, *validCandidates.Current());
+  }
+
+  // Validates a party symbol against a given candidate table version.
+  //
+  // Args:
+  //   symbol: The party symbol to validate.
+  //   table: The table the symbol must be unique in.
+  //
+  // Returns:
+  //   true if the symbol is valid, false otherwise.
+  bool ElectionSystem:: ValidatePartySymbol(const std::string& symbol, const CandidateTable& table)
   {
 
     // Validate uniqueness
-    if (symbolSet.find(symbol) != symbolSet.end())
+    if (table.symbols.find(symbol) != table.symbols.end())
     {
       errorMessage =  "Party Symbol already exists. Please enter a different symbol.";
       return false;
     }
-    // Validate the length of the symbol:
-    // - Must be between 2 and 20 characters.
-    if (symbol.length() < 2 || symbol.length() > 20)
-    {
-      errorMessage = "Invalid Party Symbol length.";
-      return false;
-    }
-
-    // Validate the format of the symbol:
-    // - Must consist only of alphabetic characters (A-Z, a-z).
-    if (!std::all_of(symbol.begin(), symbol.end(), ::isalpha)) 
+    // Validate the length and the characters of the symbol (see field_rules.h):
+    switch (CheckField<ActiveRules::kPartySymbol>(symbol))
     {
-      // error message about non-alphabetic characters.
-      errorMessage =  "Invalid characters in Party Symbol. Only alphabets are allowed.";
-      return false;
+      case RuleCheck::kOk:
+        break;
+      case RuleCheck::kBadLength:
+        errorMessage = "Invalid Party Symbol length.";
+        return false;
+      default:
+        // error message about non-alphabetic characters.
+        errorMessage =  "Invalid characters in Party Symbol. Only alphabets are allowed.";
+        return false;
     }
 
     // If all validations pass, the symbol is considered valid.
@@ -193,11 +273,8 @@ bool ElectionSystem::ValidateCandidateID(const std::string& id)
   bool ElectionSystem::ValidateRegionCode(const std::string& code)
   {
     // Validate the format of the code:
-    // - Length must be between 3 and 5 characters.
     // - Must contain at least one digit and one alphabetic character.
-    // Ensure the presence of both a digit and an alphabetic character.
-    if (std::none_of(code.begin(), code.end(), ::isdigit) ||
-       std::none_of(code.begin(), code.end(), ::isalpha)) {
+    if (!MatchesField<ActiveRules::kRegionCode>(code)) {
       // error message about the missing character types.
     errorMessage = "Region Code should contain at least one alpha and one numeric character.";
     return false;
@@ -218,31 +295,9 @@ bool ElectionSystem::ValidateCandidateID(const std::string& id)
   //   true if the string is a valid non-negative integer, false otherwise.
   bool ElectionSystem::IsValidNumber(const std::string& str)
   {
-    // Check for empty string:
-    if (str.empty())
-    {
-      return false;  // Empty string is not a valid number.
-    }
-
-    // Ensure all characters are digits:
-    for (char c : str)
-    {
-      if (!std::isdigit(c))
-      {
-        return false;  // Non-digit character found, invalid number.
-      }
-    }
-
-    // Attempt conversion to integer and check for non-negative value:
-    try 
-    {
-      int value = std::stoi(str);
-      return value >= 0;  // Valid non-negative integer.
-    } 
-    catch (const std::exception& e) 
-    {
-      return false;  // Conversion failed, invalid number.
-    }
+    // Digits only, and small enough to convert (see field_parser.h):
+    int64_t value = 0;
+    return ParseCount(str, value) && value <= std::numeric_limits<int>::max();
   }
 
   
@@ -255,17 +310,8 @@ bool ElectionSystem::ValidateCandidateID(const std::string& id)
   //   The converted non-negative integer value, or 0 if conversion fails.
   int ElectionSystem::Convert2Int(const std::string& str)
   {
-    try
-    {
-      int value = std::stoi(str);  // Attempt to convert the string to an integer.
-      // Ensure the value is non-negative:
-      return value >= 0 ? value : 0;  // Return the value if non-negative, otherwise 0.
-    } 
-    catch (const std::exception& e)
-    {
-      // Conversion failed, return 0 to indicate an invalid or negative value.
-      return 0;
-    }
+    int64_t value = 0;
+    return (ParseCount(str, value) && value <= std::numeric_limits<int>::max()) ? static_cast<int>(value) : 0;
   }
 
     
@@ -275,7 +321,7 @@ bool ElectionSystem::ValidateCandidateID(const std::string& id)
 //   true if at least one valid candidate was found, false otherwise.
 bool ElectionSystem::CandidateCsvCheck() 
 {
-  std::ifstream inputFile("Candidate.csv");
+  std::ifstream inputFile(DataPath("Candidate.csv"));
 
   // Check if the file is open:
   if (!inputFile.is_open()) 
@@ -285,48 +331,317 @@ bool ElectionSystem::CandidateCsvCheck()
     return false;
   }
 
-  // Process each line in the CSV file:
+  // Process each line in the CSV file into a new table version:
+  CandidateTable loaded;
   std::string line;
   while (std::getline(inputFile, line)) 
   {
-    std::istringstream ss(line);
-    std::string id, name, symbol, reg, count;
-
-    // Extract fields from the line:
-    std::getline(ss, id, ',');
-    std::getline(ss, name, ',');
-    std::getline(ss, symbol, ',');
-    std::getline(ss, reg, ',');
-    std::getline(ss, count, ',');
+    // Extract fields from the line; missing fields stay empty:
+    CsvFields fields(line);
+    std::string_view idField, nameField, symbolField, regField, countField;
+    fields.Next(idField) && fields.Next(nameField) && fields.Next(symbolField) &&
+        fields.Next(regField) && fields.Next(countField);
 
     // Handle missing fields:
-    if (id.empty()) {
+    if (idField.empty()) {
       // Skip lines with empty IDs as they are essential for validation.
       continue;
     }
-    if (name.empty()) name = "";
-    if (symbol.empty()) symbol = "";
-    if (reg.empty()) reg = "";
-    if (count.empty() || !IsValidNumber(count)) count = "0";  // Ensure valid count
+    int64_t votes = 0;
+    if (!ParseCount(countField, votes)) votes = 0;  // Ensure valid count
+    std::string id(idField), name(nameField), symbol(symbolField), reg(regField);
 
     // Validate candidate information:
-    if (ValidateCandidateID(id) && ValidateCandidateName(name) &&
-        ValidatePartySymbol(symbol) && ValidateRegionCode(reg)) {
+    if (ValidateCandidateID(id, loaded) && ValidateCandidateName(name) &&
+        ValidatePartySymbol(symbol, loaded) && ValidateRegionCode(reg)) {
       // Create a valid Candidate object and store relevant data:
-      Candidate candidate(id, name, symbol, reg, Convert2Int(count));
-      validCandidateList.push_back(candidate);
-      idSet.insert(id);  // Track unique IDs
-      symbolSet.insert(symbol);  // Track unique symbols
-      votesSet[id] = Convert2Int(count);  // Store vote counts
+      Candidate candidate(id, name, symbol, reg, votes);
+      loaded.candidates.push_back(candidate);
+      loaded.ids.insert(id);  // Track unique IDs
+      loaded.symbols.insert(symbol);  // Track unique symbols
+      votesSet.Set(id, votes);  // Store vote counts
     } else {
       // Create an invalid Candidate object for reporting:
-      Candidate candidate(id, name, symbol, reg, Convert2Int(count));
-      invalidCandidateList.push_back(candidate);
+      Candidate candidate(id, name, symbol, reg, votes);
+      invalidCandidates.Add(candidate, CandidateProblems(candidate, loaded));
     }
   }
 
+  // Publish the loaded table:
+  validCandidates.Edit([&loaded](CandidateTable& table) {
+    table.candidates = loaded.candidates;
+    table.ids = loaded.ids;
+    table.symbols = loaded.symbols;
+    return true;
+  });
+
+  // Keep the rows as read for diffing later edits of the file:
+  if (hotReload) {
+    candidateFileRows = loaded.candidates;
+    std::sort(candidateFileRows.begin(), candidateFileRows.end(), [](const Candidate& a, const Candidate& b) {
+      return a.GetCandidateID() < b.GetCandidateID();
+    });
+  }
+
+  // Bring the vote counts up to date with the votes of earlier sessions:
+  ApplyCandidateDelta();
+
   // Indicate success if at least one valid candidate was found:
-  return validCandidateList.size() >= 1;
+  return loaded.candidates.size() >= 1;
+}
+
+// Loads the ranked ballots of earlier sessions from Ballots.csv, if the
+// contest is ranked.
+//
+// Returns:
+//   true if the ballots were loaded or the contest is not ranked.
+bool ElectionSystem::BallotCsvCheck()
+{
+  if (countMethod == CountMethod::kPlurality) {
+    return true;
+  }
+  size_t rejected = ballots.Load(DataPath("Ballots.csv"));
+  if (rejected > 0) {
+    std::cerr << "Skipped " << rejected << " invalid ballots in the Ballots file.\n";
+  }
+  ballotsSaved = ballots.Size();
+  return true;
+}
+
+
+// Opens the vote journal. A new journal starts with the votes loaded from
+// Candidate.csv carried into it.
+//
+// Returns:
+//   true if the journal is open, false otherwise.
+bool ElectionSystem::VoteJournalCheck()
+{
+  bool created = false;
+  if (!voteJournal.Open(DataPath("Votes.journal"), created)) {
+    std::cerr << "Error opening the vote journal. Votes will not be journaled.\n";
+    return false;
+  }
+  if (created) {
+    for (const auto& count : votesSet.Snapshot().counts) {
+      if (count.second > 0) {
+        voteJournal.RecordCarry(count.first, count.second);
+      }
+    }
+  }
+  return true;
+}
+
+
+// Recounts the vote journal in parallel and cross-checks it against the
+// stored tallies and the number of voters marked as voted.
+//
+// Returns:
+//   true if the audit found no discrepancy, false otherwise.
+bool ElectionSystem::AuditVotes()
+{
+  EnsureVoterRoll();
+  auto start = std::chrono::steady_clock::now();
+  unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+
+  JournalRecount recount;
+  if (!RecountJournal(DataPath("Votes.journal"), threads, recount)) {
+    Err() << "Error opening the vote journal. Run a session first to start it.\n";
+    return false;
+  }
+
+  // Count the voted flags, in slices of the roll on every thread:
+  size_t voted = 0;
+  if (voterStore.IsOpen()) {
+    voted = voterStore.CountVoted();
+  } else {
+    std::vector<size_t> slices(threads);
+    std::vector<std::thread> workers;
+    size_t slice = (validVoterList.size() + threads - 1) / threads;
+    for (unsigned t = 0; t < threads; t++) {
+      workers.emplace_back([&, t]() {
+        size_t end = std::min(validVoterList.size(), (t + 1) * slice);
+        for (size_t i = t * slice; i < end; i++) {
+          slices[t] += validVoterList[i].GetVotingStatus();
+        }
+      });
+    }
+    for (std::thread& worker : workers) {
+      worker.join();
+    }
+    for (size_t count : slices) {
+      voted += count;
+    }
+  }
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  Out() << "Recounted " << recount.records << " journal records on " << recount.threads << " threads in "
+        << seconds << " s\n";
+
+  // Malformed records:
+  size_t discrepancies = 0;
+  for (const JournalProblem& problem : recount.problems) {
+    Out() << "Votes.journal line " << problem.line << ": " << problem.message << '\n';
+    discrepancies++;
+  }
+
+  // Stored tallies against the recount:
+  TallySnapshot stored = votesSet.Snapshot();
+  for (const auto& count : stored.counts) {
+    auto it = recount.candidates.find(count.first);
+    bool journaled = it != recount.candidates.end() && it->second.standing;
+    int64_t recounted = journaled ? it->second.votes : 0;
+    if (recounted != count.second) {
+      Out() << "Candidate " << count.first << ": stored " << count.second << " votes, journal recounts "
+            << recounted;
+      if (it != recount.candidates.end()) {
+        Out() << " (last journal record at line " << it->second.lastLine << ")";
+      }
+      Out() << '\n';
+      discrepancies++;
+    }
+  }
+  std::vector<std::pair<std::string, JournalTotal>> unregistered;
+  for (const auto& entry : recount.candidates) {
+    if (entry.second.standing && !std::binary_search(stored.counts.begin(), stored.counts.end(),
+                                                     std::make_pair(entry.first, INT64_MIN),
+                                                     [](const auto& a, const auto& b) { return a.first < b.first; })) {
+      unregistered.push_back(entry);
+    }
+  }
+  std::sort(unregistered.begin(), unregistered.end(),
+            [](const auto& a, const auto& b) { return a.first < b.first; });
+  for (const auto& entry : unregistered) {
+    Out() << "Candidate " << entry.first << ": not registered, journal recounts " << entry.second.votes
+          << " votes (last journal record at line " << entry.second.lastLine << ")\n";
+    discrepancies++;
+  }
+
+  // Every vote cast marks one voter as voted:
+  if (static_cast<int64_t>(voted) != recount.votesCast) {
+    Out() << "Voter roll: " << voted << " voters marked as voted, journal records " << recount.votesCast
+          << " votes cast\n";
+    discrepancies++;
+  }
+
+  if (discrepancies == 0) {
+    Out() << "Audit passed: " << stored.turnout << " votes match the journal and the voter roll\n";
+    return true;
+  }
+  Out() << "Audit found " << discrepancies << " discrepancies\n";
+  return false;
+}
+
+
+
+// Writes the voter roll to a compressed roll archive.
+//
+// Args:
+//   path: The archive to write.
+//
+// Returns:
+//   true if the archive was written, false otherwise.
+bool ElectionSystem::BackupVoterRoll(const std::string& path)
+{
+  EnsureVoterRoll();
+  auto start = std::chrono::steady_clock::now();
+  RollArchiveWriter archive;
+  if (!archive.Open(path)) {
+    Err() << "Error creating the roll archive " << path << ".\n";
+    return false;
+  }
+
+  // The archive takes voters in ID order, which every roll can give cheaply:
+  if (voterStore.IsOpen()) {
+    voterStore.Visit([&archive](std::string_view aadhar, bool status) { archive.Add(PackAadhar(aadhar), status); });
+  } else if (sortedRoll) {
+    for (size_t i = 0; i < validVoterList.size(); i++) {
+      archive.Add(voterKeys[i], validVoterList[i].GetVotingStatus());
+    }
+  } else {
+    std::vector<uint64_t> keys;
+    keys.reserve(validVoterList.size());
+    for (const Voter& voter : validVoterList) {
+      keys.push_back(PackAadhar(voter.GetAadharID()));
+    }
+    for (uint32_t position : RadixSortOrder(keys)) {
+      archive.Add(keys[position], validVoterList[position].GetVotingStatus());
+    }
+  }
+  uint64_t voters = archive.Size();
+  if (!archive.Close()) {
+    Err() << "Error writing the roll archive " << path << ".\n";
+    return false;
+  }
+
+  uint64_t bytes = archive.Bytes();
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  Out() << "Archived " << voters << " voters in " << bytes << " bytes ("
+        << (voters == 0 ? 0.0 : static_cast<double>(bytes) / voters) << " bytes per voter, "
+        << VoterRecordFile::kRecordSize << " in Voter.csv) in " << seconds << " s\n";
+  return true;
+}
+
+
+// Replaces Voter.csv with the voters of a roll archive.
+//
+// Args:
+//   path: The archive to read.
+//
+// Returns:
+//   true if Voter.csv was replaced, false otherwise.
+bool ElectionSystem::RestoreVoterRoll(const std::string& path)
+{
+  auto start = std::chrono::steady_clock::now();
+  RollArchive archive;
+  if (!archive.Open(path)) {
+    Err() << "Error reading the roll archive " << path << ": missing, incomplete or corrupt.\n";
+    return false;
+  }
+
+  // Decode block by block into sorted fixed-width records, beside Voter.csv:
+  const size_t recordSize = VoterRecordFile::kRecordSize;
+  std::string voterPath = DataPath("Voter.csv");
+  std::string temporary = voterPath + ".tmp";
+  std::ofstream outputFile(temporary, std::ios::binary | std::ios::trunc);
+  std::vector<uint64_t> keys;
+  std::vector<uint8_t> statuses;
+  std::string records;
+  uint64_t keyLimit = 1;  // Keys of fixed-length IDs stay below this.
+  for (size_t digit = 0; digit < VoterRecordFile::kAadharLength; digit++) {
+    keyLimit *= 10;
+  }
+  for (size_t block = 0; block < archive.BlockCount() && outputFile; block++) {
+    archive.DecodeBlock(block, keys, statuses);
+    if (keys.back() >= keyLimit) {
+      Err() << "Error reading the roll archive " << path << ": an Aadhar ID is out of range.\n";
+      outputFile.close();
+      std::remove(temporary.c_str());
+      return false;
+    }
+    records.resize(keys.size() * recordSize);
+    for (size_t i = 0; i < keys.size(); i++) {
+      char* record = &records[i * recordSize];
+      uint64_t key = keys[i];
+      for (size_t digit = VoterRecordFile::kAadharLength; digit-- > 0; key /= 10) {
+        record[digit] = static_cast<char>('0' + key % 10);
+      }
+      record[VoterRecordFile::kAadharLength] = ',';
+      record[VoterRecordFile::kStatusOffset] = statuses[i] ? '1' : '0';
+      record[recordSize - 1] = '\n';
+    }
+    outputFile.write(records.data(), records.size());
+  }
+  outputFile.close();
+  if (!outputFile || std::rename(temporary.c_str(), voterPath.c_str()) != 0) {
+    Err() << "Error writing " << voterPath << ".\n";
+    std::remove(temporary.c_str());
+    return false;
+  }
+
+  // The delta file holds changes to the roll that was replaced:
+  std::remove(DataPath("Voter.delta").c_str());
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  Out() << "Restored " << archive.Size() << " voters to " << voterPath << " in " << seconds << " s\n";
+  return true;
 }
 
   
@@ -336,7 +651,12 @@ bool ElectionSystem::CandidateCsvCheck()
 //   true if at least one valid voter was found, false otherwise.
 bool ElectionSystem::VoterCsvCheck() 
 {
-  std::ifstream inputFile("Voter.csv");
+  voterRollLoaded = true;
+  if (outOfCoreCacheBytes > 0)
+  {
+    return LoadVoterStore();
+  }
+  std::ifstream inputFile(DataPath("Voter.csv"));
 
   // Check if the file is open:
   if (!inputFile.is_open()) 
@@ -349,33 +669,39 @@ bool ElectionSystem::VoterCsvCheck()
   std::string line;
   while (std::getline(inputFile, line)) 
   {
-    std::istringstream ss(line);
-    std::string aadhar, status;
+    CsvFields fields(line);
+    std::string_view aadharField, statusField;
 
     // Extract Aadhar number and status from the line:
-    if (std::getline(ss, aadhar, ',')) 
+    if (fields.Next(aadharField)) 
     {
-      if (std::getline(ss, status, ',')) 
+      // A 12 digit Aadhar ID fits the short string buffer, so this does not allocate:
+      std::string aadhar(aadharField);
+      bool voted = false;
+      if (fields.Next(statusField)) 
       {
         // Validate voter information:
-        if (IsValidAadhar(aadhar) &&  // Ensure valid Aadhar format
+        if (IsAadharFormat(aadhar) &&  // Ensure valid Aadhar format
             (checkAadhar.find(aadhar) == checkAadhar.end()) &&  // Check for duplicates
-            IsValidStatus(status))  // Ensure valid status ("0" or "1")
+            ParseStatus(statusField, voted))  // Ensure valid status ("0" or "1")
         {  
           
             checkAadhar.insert(aadhar);  // Track unique Aadhar numbers
-          bool voted = (status == "1");  // Convert status to boolean
           Voter v(aadhar, voted);  // Create a Voter object
           validVoterList.push_back(v);  // Add to valid voter list
+          if (hotReload && !inPlacePersistence)
+          {
+            voterFileRows.push_back(PackAadhar(aadhar) << 1 | voted);  // Kept for hot reload
+          }
         } 
         else {
           if(!aadhar.empty())
-          invalidVoterList.emplace_back(aadhar, status);  // Add to invalid voter list
+          AddInvalidVoter(aadhar, std::string(statusField));  // Add to invalid voter list
         }
       } else {
         // Handle missing status:
         if(!aadhar.empty())
-        invalidVoterList.emplace_back(aadhar, "");  // Add with empty status
+        AddInvalidVoter(aadhar, "");  // Add with empty status
       }
     } 
     else {
@@ -384,1373 +710,3764 @@ bool ElectionSystem::VoterCsvCheck()
     }
   }
 
-  // Indicate success if at least one valid voter was found:
-  return validVoterList.size() >= 1;
-}
+  std::sort(voterFileRows.begin(), voterFileRows.end());
 
-  
-  
-  bool ElectionSystem:: IsValidAadhar(const std::string& aadhar) {
-    // Check if the string is a positive integer and has a length of 12
-    if(aadhar[0] != '0' && aadhar.length() == 12 && std::all_of(aadhar.begin(), aadhar.end(), ::isdigit))
+  // Bring the roll up to date with the changes of earlier sessions:
+  ApplyVoterDelta();
+
+  // Map the roll for in-place updates when every row is a fixed-width record.
+  // The rows were loaded in file order, so record i is validVoterList[i].
+  if (inPlacePersistence && invalidVoters.Empty() && voterFile.Open(DataPath("Voter.csv")))
+  {
+    if (voterFile.Size() == validVoterList.size())
     {
-      errorMessage = "";
-      return true;
+      // Fold the delta rows into the mapped records:
+      for (size_t i = 0; i < validVoterList.size(); i++)
+      {
+        if (voterFile.GetVotingStatus(i) != validVoterList[i].GetVotingStatus())
+        {
+          voterFile.SetVotingStatus(i, validVoterList[i].GetVotingStatus());
+        }
+      }
+      std::remove(DataPath("Voter.delta").c_str());
+      voterRollChanged = false;
     }
-    
     else
-    { 
-      errorMessage =  "Invalid Aadhar ID ";
-      return false;;
+    {
+      voterFile.Close();
     }
   }
 
- bool ElectionSystem:: IsValidStatus(const std::string& status) {
-    // Check if the string is either "0" or "1" and has a length of 1
-    if(status.length() == 1 && (status == "0" || status == "1"))
+  // Rewrite a roll that cannot be mapped in the fixed-width format on exit:
+  if (inPlacePersistence && !voterFile.IsOpen() && !validVoterList.empty())
+  {
+    voterRollChanged = true;
+  }
+
+  // Order the roll for interpolation search:
+  if (sortedRoll)
+  {
+    SortVoterRoll();
+  }
+
+  // Indicate success if at least one valid voter was found:
+  return validVoterList.size() >= 1;
+}
+
+  // Opens the out-of-core voter roll and folds the voter delta file into it.
+  //
+  // Returns:
+  //   true if at least one valid voter was found, false otherwise.
+  bool ElectionSystem::LoadVoterStore()
+  {
+    std::vector<std::pair<std::string, std::string>> invalid;
+    if (!voterStore.Open(DataPath("Voter.csv"), outOfCoreCacheBytes, invalid))
     {
-      errorMessage = "";
-      return true;
+      std::cerr << "Error opening the Voter file. Please ensure it exists and is accessible.\n";
+      return false;
     }
-    else
+    for (const auto& row : invalid)
     {
-      errorMessage = "Invalid Voting Status ";
-      return false;;
-    } 
- }
-  
-  // Repeatedly prompts the user to enter a valid integer choice.
+      AddInvalidVoter(row.first, row.second);
+    }
+
+    std::ifstream deltaFile(DataPath("Voter.delta"));
+    std::string line;
+    while (std::getline(deltaFile, line))
+    {
+      CsvFields fields(line);
+      std::string_view aadhar, status;
+      bool voted = false;
+      if (fields.Next(aadhar) && fields.Next(status) && ParseStatus(status, voted))
+      {
+        voterStore.SetVotingStatus(std::string(aadhar), voted);
+      }
+    }
+    deltaFile.close();
+
+    // The delta file is removed once Close() has written the rows into the roll.
+    return voterStore.Size() >= 1;
+  }
+
+  // Applies the status changes recorded in the voter delta file to validVoterList.
   //
   // Returns:
-  //   The valid integer entered by the user.
-  int ElectionSystem:: GetChoice() 
+  //   The number of delta rows applied.
+  size_t ElectionSystem::ApplyVoterDelta()
   {
-    while (true) // Loop until valid input is received
-    {  
-      std::cout << "Enter your choice: ";
-      int choice{};
-      std::cin >> choice;
+    std::ifstream deltaFile(DataPath("Voter.delta"));
+    if (!deltaFile.is_open())
+    {
+      return 0;  // No delta from earlier sessions.
+    }
 
-      // Check for input failure:
-      if (!std::cin) {
-        if (std::cin.eof()) {  // If the input stream was closed
-          exit(0);  // Terminate the program
-        } else {  // Handle invalid input
-          std::cin.clear();  // Reset the input stream
-          std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');  // Discard invalid input
-          std::cerr << "Oops, that input is invalid. Please try again.\n";
-        }
-      } else {  // Input is valid
-        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');  // Discard any extra input
-        return choice;  // Return the valid integer
-      }
+    // Index the roll once so that each delta row is applied in O(1).
+    std::unordered_map<std::string, size_t> position;
+    position.reserve(validVoterList.size());
+    for (size_t i = 0; i < validVoterList.size(); i++)
+    {
+      position[validVoterList[i].GetAadharID()] = i;
     }
-  }
 
-  
-// Repeatedly prompts the user to enter a valid string for a given field.
-//
-// Args:
-//   fieldName: The name of the field to prompt for.
-//
-// Returns:
-//   The valid string entered by the user.
-std::string ElectionSystem::GetValidString(const std::string& fieldName) {
-  while (true) {  // Loop until valid input is received
-    std::cout << "Enter " << fieldName << ": ";
-    std::string input;
-    std::getline(std::cin, input);
+    size_t applied = 0;
+    std::string line;
+    while (std::getline(deltaFile, line))
+    {
+      CsvFields fields(line);
+      std::string_view aadhar, status;
+      bool voted = false;
+      if (fields.Next(aadhar) && fields.Next(status) && ParseStatus(status, voted))
+      {
+        auto it = position.find(std::string(aadhar));
+        if (it != position.end())
+        {
+          validVoterList[it->second].SetVotingStatus(voted);
+          if (voterFileWatched && checkpointInterval > 0)
+          {
+            voterFileEdits[PackAadhar(aadhar)] = voted;  // Not in Voter.csv yet
+          }
+          applied++;
+        }
+      }
+    }
+    deltaFile.close();
 
-    // Check for input failure:
-    if (!std::cin) {
-      std::cin.clear();  // Reset the input stream
-      std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');  // Discard invalid input
-      std::cout << "Oops, there was an error. Please try again.\n";
-    } else {  // Input is valid
-      return input;  // Return the valid string
+    // Fold a delta that has grown large back into Voter.csv on the next exit.
+    if (applied > validVoterList.size() / 4)
+    {
+      voterRollChanged = true;
     }
+    return applied;
   }
-}
 
+  // Applies the vote counts recorded in the candidate delta file to the tally.
+  //
+  // Returns:
+  //   The number of delta rows applied.
+  size_t ElectionSystem::ApplyCandidateDelta()
+  {
+    std::ifstream deltaFile(DataPath("Candidate.delta"));
+    if (!deltaFile.is_open())
+    {
+      return 0;  // No delta from earlier sessions.
+    }
 
-// Repeatedly prompts the user to enter a valid character for a given field.
-//
-// Args:
-//   fieldName: The name of the field to prompt for.
-//
-// Returns:
-//   The valid character entered by the user.
-char ElectionSystem:: GetValidChar(const std::string& fieldName) {
-  while (true) {  // Loop until valid input is received
-    std::cout << "Enter " << fieldName << ": ";
-    char input;
-    std::cin >> input;
+    // Later rows hold later counts of the same candidate:
+    std::shared_ptr<const CandidateTable> table = validCandidates.Current();
+    size_t applied = 0;
+    std::string line;
+    while (std::getline(deltaFile, line))
+    {
+      CsvFields fields(line);
+      std::string_view id, count;
+      int64_t votes = 0;
+      if (fields.Next(id) && fields.Next(count) && ParseCount(count, votes) &&
+          table->Find(std::string(id)) != nullptr)
+      {
+        votesSet.Set(std::string(id), votes);
+        applied++;
+      }
+    }
+    deltaFile.close();
 
-    // Check for input failure:
-    if (std::cin.fail()) {
-      std::cin.clear();  // Reset the input stream
-      std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');  // Discard invalid input
-      std::cout << "Oops, there was an error. Please try again.\n";
-    } else {  // Input is valid
-      std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');  // Discard any extra input
-      return input;  // Return the valid character
+    // Fold a delta that has grown longer than the file back into Candidate.csv
+    // on the next exit.
+    if (applied > table->candidates.size())
+    {
+      candidatesChanged = true;
     }
+    return applied;
   }
-}
 
+  // Records a voting status change of an existing voter for delta persistence.
+  //
+  // Args:
+  //   aadhar: The Aadhar ID of the voter whose status changed.
+  //   status: The new voting status.
+  void ElectionSystem::MarkVoterDirty(const std::string& aadhar, bool status)
+  {
+    // Store the status byte straight into the mapped voter file:
+    if (voterFile.IsOpen())
+    {
+      long record = voterFile.Find(aadhar);
+      if (record >= 0)
+      {
+        voterFile.SetVotingStatus(record, status);
+        return;
+      }
+    }
+    dirtyVoters[aadhar] = status;
+  }
 
-// Repeatedly prompts the user for admin credentials until successful or cancelled.
-//
-// Returns:
-//   true if authentication is successful, false if the user cancels.
-bool ElectionSystem::GetAdminAuthenicate() {
-  while (true) {  // Loop until authentication or cancellation
-    // Get valid username and password from user:
-    std::string adminUsername="Admin Username ";
-    std::string adminPassword="Admin Password ";
-    std::string username = GetValidString(adminUsername);
-    std::string password = GetValidString(adminPassword);
+  // Selects between delta persistence and a full voter roll rewrite on exit.
+  //
+  // Args:
+  //   enabled: true to append status and vote count changes to the delta files.
+  void ElectionSystem::SetDeltaPersistence(bool enabled)
+  {
+    deltaPersistence = enabled;
+  }
 
-    // Check for successful authentication:
-    if ( (adminValidate.find(username)!=adminValidate.end() && adminValidate[username] == password) ||  // Check stored credentials
-        (username == "admin" && password == "admin")) {  // Check for default admin
-      return true;  // Authentication successful
-    } else {
-      // Invalid credentials:
-      std::cout << "Invalid Username or Password\n";
-      std::cout << "Do you want to continue? (n for back)\n";
-      std::string characterChoice = "a character";
-      char result = GetValidChar(characterChoice);
-      if (result == 'n') {
-        return false;  // User cancelled
-      }
+  // Selects in-place status updates of the fixed-width voter file.
+  //
+  // Args:
+  //   enabled: true to map Voter.csv and update status bytes in place.
+  void ElectionSystem::SetInPlacePersistence(bool enabled)
+  {
+    inPlacePersistence = enabled;
+  }
+
+  // Selects keeping the voter roll sorted by Aadhar ID for interpolation search.
+  //
+  // Args:
+  //   enabled: true to sort the roll after loading and keep it sorted.
+  void ElectionSystem::SetSortedRoll(bool enabled)
+  {
+    sortedRoll = enabled;
+  }
+
+  // Selects how the contest is counted.
+  //
+  // Args:
+  //   method: The count method; ranked methods ask voters for preferences.
+  //   seats: The number of seats to fill by single transferable vote.
+  void ElectionSystem::SetCountMethod(CountMethod method, size_t seats)
+  {
+    countMethod = method;
+    countSeats = seats;
+  }
+
+  // Selects the out-of-core voter roll, which keeps at most a page cache of the
+  // roll in memory.
+  //
+  // Args:
+  //   cacheBytes: The page cache size; 0 loads the whole roll into memory.
+  void ElectionSystem::SetOutOfCore(size_t cacheBytes)
+  {
+    outOfCoreCacheBytes = cacheBytes;
+  }
+
+  // Returns true if an Aadhar ID is registered, in memory or in the out-of-core roll.
+  bool ElectionSystem::VoterRegistered(const std::string& aadhar)
+  {
+    return voterStore.IsOpen() ? voterStore.Contains(aadhar) : checkAadhar.count(aadhar) != 0;
+  }
+
+  // Records an Aadhar ID as taken. The out-of-core roll tracks its IDs itself.
+  void ElectionSystem::RegisterAadhar(const std::string& aadhar)
+  {
+    if (!voterStore.IsOpen())
+    {
+      checkAadhar.insert(aadhar);
     }
   }
-}
 
+  // Returns the number of registered voters.
+  size_t ElectionSystem::VoterCount() const
+  {
+    return voterStore.IsOpen() ? voterStore.Size() : validVoterList.size();
+  }
 
-// Gathers valid candidate information from the user and adds it to the validCandidateList.
-//
-// Returns:
-//   true if a candidate was successfully added, false if the user cancelled.
-bool ElectionSystem::AddCandidate() 
-{
-  std::string id, name, symbol, regionCode;
+  // Selects reloading Candidate.csv and Voter.csv when other tools change them.
+  //
+  // Args:
+  //   enabled: true to watch the files and apply their changes while running.
+  void ElectionSystem::SetHotReload(bool enabled)
+  {
+    hotReload = enabled;
+  }
 
-  // Get and validate candidate ID:
-  while (true) {
-    std::string candidateIdInput = "Candidate ID (only alphanumeric)";
-    id = GetValidString(candidateIdInput);
-    if (ValidateCandidateID(id)) {  // Ensure valid ID format and uniqueness
-      
-      break;
-    } else {
-      // Handle invalid ID:
-      std::cerr << errorMessage << '\n';
-      std::cout << "Do you want to continue ?  n for back \n";
-      std::string characterChoice = "a character";
-      char result = GetValidChar(characterChoice);
-      if(result == 'n')  return false;  // Offer to try again or cancel
+  // Starts watching the data files for hot reload, before they are loaded.
+  //
+  // Returns:
+  //   true if the files are watched, false if hot reload is off or failed.
+  bool ElectionSystem::WatchDataFiles()
+  {
+    if (!hotReload)
+    {
+      return false;
+    }
+    std::vector<std::string> names{"Candidate.csv"};
+    if (outOfCoreCacheBytes == 0 && !inPlacePersistence)
+    {
+      names.push_back("Voter.csv");
+    }
+    if (!dataWatch.Open(dataDirectory, names))
+    {
+      std::cerr << "Error watching the data files. Edits by other tools will not be reloaded.\n";
+      return false;
     }
+    voterFileWatched = names.size() > 1;
+    return true;
   }
 
-  // Get and validate candidate name:
-  while (true) {
-    std::string candidateNameInput = "Candidate Name (only alphabets )";
-    name = GetValidString(candidateNameInput);
-    if (ValidateCandidateName(name)) 
+  // Applies the edits other tools made to the watched data files since the
+  // last call.
+  void ElectionSystem::ReloadChangedFiles()
+  {
+    // A running checkpoint is replacing the files; they are diffed against
+    // what it wrote once it is collected:
+    ReapCheckpoint(false);
+    std::set<std::string> changed = dataWatch.Changed();
+    pendingReloads.insert(changed.begin(), changed.end());
+    if (checkpointChild > 0)
     {
-      break;
-    } 
-    else 
+      return;
+    }
+
+    for (const std::string& name : pendingReloads)
     {
-      // Handle invalid name:
-      std::cerr << errorMessage << '\n';
-      std::cout << "Do you want to continue ?  n for back \n";
-      std::string characterChoice = "a character";
-      char result = GetValidChar(characterChoice);
-         if(result == 'n')
-         { 
-          // Store partial candidate info if cancelled
-           Candidate candidate(id, "", "", "");
-           invalidCandidateList.push_back(candidate);
-           return false;
-         }
+      // Skip a file a checkpoint wrote that nothing changed since:
+      auto own = ownFileStamps.find(name);
+      if (own != ownFileStamps.end() && own->second == FileStamp(name))
+      {
+        continue;
+      }
+      if (name == "Candidate.csv")
+      {
+        ReloadCandidates();
+      }
+      else if (name == "Voter.csv")
+      {
+        ReloadVoters();
+      }
     }
+    pendingReloads.clear();
   }
 
-  // Get and validate party symbol:
-  while (true) {
-    std::string partySymbolInput = "Party Symbol (only characters )";
-    symbol = GetValidString(partySymbolInput);
-    if (ValidatePartySymbol(symbol)) {  // Ensure valid symbol format and uniqueness
-      
-      break;
-    } else {
-      // Handle invalid symbol:
-      std::cerr << errorMessage << '\n';
-      std::cout << "Do you want to continue ?  n for back \n";
-         std::string characterChoice = "a character";
-         char result = GetValidChar(characterChoice);
-         if(result == 'n')
-         { 
-           Candidate candidate(id, name, "", "");
-           invalidCandidateList.push_back(candidate);
-           return false;
-         }
+  // Returns what identifies the current contents of a data file, or an empty
+  // string if it is missing.
+  std::string ElectionSystem::FileStamp(const std::string& name) const
+  {
+    struct stat info;
+    if (stat(DataPath(name).c_str(), &info) != 0)
+    {
+      return "";
     }
+    return std::to_string(info.st_dev) + ":" + std::to_string(info.st_ino) + ":" + std::to_string(info.st_size) +
+           ":" + std::to_string(info.st_mtim.tv_sec) + "." + std::to_string(info.st_mtim.tv_nsec);
   }
 
-  // Get and validate region ID:
-  while (true) {
-    std::string regionIdInput = "Region ID (only alphanumeric)";
-    regionCode = GetValidString(regionIdInput);
-    if (ValidateRegionCode(regionCode)) {
-      break;
-    } else {
-      // Handle invalid region ID:
-      std::cerr << errorMessage << '\n';
-      std::cout << "Do you want to continue ?  n for back \n";
-         std::string characterChoice = "a character";
-         char result = GetValidChar(characterChoice);
-         if(result == 'n')
-         { 
-           Candidate candidate(id, name, symbol, "");
-           invalidCandidateList.push_back(candidate);
-           return false;
-         }
+  // Brings voterFileRows up to date with roll changes a checkpoint wrote, in
+  // one merge pass.
+  void ElectionSystem::ApplyVoterFileEdits(const std::unordered_map<uint64_t, int>& edits)
+  {
+    if (edits.empty())
+    {
+      return;
+    }
+    std::vector<std::pair<uint64_t, int>> sorted(edits.begin(), edits.end());
+    std::sort(sorted.begin(), sorted.end());
+    std::vector<uint64_t> rows;
+    rows.reserve(voterFileRows.size() + sorted.size());
+    size_t i = 0, j = 0;
+    while (i < voterFileRows.size() || j < sorted.size())
+    {
+      if (j == sorted.size() || (i < voterFileRows.size() && voterFileRows[i] >> 1 < sorted[j].first))
+      {
+        rows.push_back(voterFileRows[i++]);
+        continue;
+      }
+      if (i < voterFileRows.size() && voterFileRows[i] >> 1 == sorted[j].first)
+      {
+        i++;  // Replaced or removed by the edit
+      }
+      if (sorted[j].second >= 0)
+      {
+        rows.push_back(sorted[j].first << 1 | sorted[j].second);
+      }
+      j++;
     }
+    voterFileRows.swap(rows);
   }
 
-  // Create and add the candidate:
-  Candidate candidate(id, name, symbol, regionCode);
-  symbolSet.insert(symbol);  // Track used symbols
-  idSet.insert(id);  // Track used IDs
-  validCandidateList.push_back(candidate);
+  // Diffs Candidate.csv against the rows last read and applies the added,
+  // removed and changed candidates, with validation.
+  void ElectionSystem::ReloadCandidates()
+  {
+    std::ifstream inputFile(DataPath("Candidate.csv"));
+    if (!inputFile.is_open())
+    {
+      return;
+    }
 
-  // Success message:
-  std::cout << "Candidate Added Successfully\n";
-  return true;
-}
+    // Read the rows whose fields are valid on their own:
+    std::vector<Candidate> rows;
+    std::set<std::string> invalidIDs;
+    size_t skipped = 0;
+    const CandidateTable none;
+    std::string line;
+    while (std::getline(inputFile, line))
+    {
+      CsvFields fields(line);
+      std::string_view idField, nameField, symbolField, regField, countField;
+      fields.Next(idField) && fields.Next(nameField) && fields.Next(symbolField) &&
+          fields.Next(regField) && fields.Next(countField);
+      if (idField.empty())
+      {
+        continue;
+      }
+      int64_t votes = 0;
+      if (!ParseCount(countField, votes)) votes = 0;
+      std::string id(idField), name(nameField), symbol(symbolField), reg(regField);
+      if (ValidateCandidateID(id, none) && ValidateCandidateName(name) && ValidatePartySymbol(symbol, none) &&
+          ValidateRegionCode(reg))
+      {
+        rows.emplace_back(id, name, symbol, reg, votes);
+      }
+      else
+      {
+        invalidIDs.insert(id);
+        skipped++;
+      }
+    }
 
-  
-  
-  // Identifies and guides the user to fill missing or invalid information in invalidCandidateList.
-  //
-  // Returns:
-  //   true if candidates were successfully updated, false if the user cancelled.
-  bool ElectionSystem::FillMissingCandidateInfo()
-  {
-      std::vector<Candidate> temp;  // Temporary storage for candidates with missing or invalid data
-      
-      // Identify candidates with missing or invalid data and fill in temp
-      for(auto& candidate :invalidCandidateList)
+    // A candidate whose row turned invalid keeps its last valid row:
+    for (const Candidate& candidate : candidateFileRows)
+    {
+      if (invalidIDs.count(candidate.GetCandidateID()) != 0)
+      {
+        rows.push_back(candidate);
+      }
+    }
+
+    // Sort by ID, keeping the first row of a repeated ID:
+    auto byID = [](const Candidate& a, const Candidate& b) { return a.GetCandidateID() < b.GetCandidateID(); };
+    std::stable_sort(rows.begin(), rows.end(), byID);
+    rows.erase(std::unique(rows.begin(), rows.end(), [](const Candidate& a, const Candidate& b) {
+      return a.GetCandidateID() == b.GetCandidateID();
+    }), rows.end());
+
+    // Sorted merge against the rows last read:
+    std::vector<std::string> removed;
+    std::vector<Candidate> added, changed;
+    size_t voteEdits = 0;
+    size_t i = 0, j = 0;
+    while (i < candidateFileRows.size() || j < rows.size())
+    {
+      if (j == rows.size() || (i < candidateFileRows.size() && byID(candidateFileRows[i], rows[j])))
+      {
+        removed.push_back(candidateFileRows[i++].GetCandidateID());
+      }
+      else if (i == candidateFileRows.size() || byID(rows[j], candidateFileRows[i]))
+      {
+        added.push_back(rows[j++]);
+      }
+      else
       {
-        std::string id = candidate.GetCandidateID();
-        std::string name = candidate.GetCandidateName();
-        std::string symbol = candidate.GetPartySymbol(); 
-        std::string reg = candidate.GetRegion();
-        if (id.empty()||name.empty()||symbol.empty()||reg.empty()|| !ValidateCandidateID(id)
-        ||!ValidateCandidateName(name)
-        ||!ValidatePartySymbol(symbol) 
-        ||!ValidateRegionCode(reg))
+        const Candidate& before = candidateFileRows[i++];
+        const Candidate& after = rows[j++];
+        if (before.GetCandidateName() != after.GetCandidateName() ||
+            before.GetPartySymbol() != after.GetPartySymbol() || before.GetRegion() != after.GetRegion())
         {
-           temp.push_back(candidate);
+          changed.push_back(after);
         }
+        voteEdits += before.GetNumOfVotes() != after.GetNumOfVotes() &&
+                     after.GetNumOfVotes() != votesSet.Get(after.GetCandidateID());
       }
-      if(temp.size() >= 1)
-      std::cout << "Fill missing data or update invalid data \n";
-      else{
-      std::cout << "No need to fill or to update invalid data \n";
-      return false;;
-      }
-      while(true)
+    }
+    candidateFileRows.swap(rows);
+
+    // Apply the diff as one table version:
+    std::vector<std::string> dropped;
+    std::vector<Candidate> joined;
+    size_t edited = 0, rejected = 0;
+    validCandidates.Edit([&](CandidateTable& table) {
+      dropped.clear();
+      joined.clear();
+      edited = rejected = 0;
+      for (const std::string& id : removed)
       {
-       int count = 1;
-       for (auto& candidate : temp) {
-         std::cout << count << " Candidate ID: " << candidate.GetCandidateID()
-                   << " Name: " << candidate.GetCandidateName()
-                   << " Party Symbol: " << candidate.GetPartySymbol()
-                   << " Region ID: " << candidate.GetRegion() << '\n';
-                   count ++;
-       }
-       int candidateChoice =  {GetChoice()};
-       if(candidateChoice >= 1&&candidateChoice < count )
-       {
-         Candidate& modify = temp[candidateChoice-1];
-         std::string mid = modify.GetCandidateID();
-         std::string mname = modify.GetCandidateName();
-         std::string msymbol = modify.GetPartySymbol(); 
-         std::string mreg = modify.GetRegion();
-         int mcount = modify.GetNumOfVotes();
-
-         
-         
-        //Candiadate ID 
-        if (ValidateCandidateID(mid) )
+        Candidate* candidate = table.Find(id);
+        if (candidate != nullptr)
         {
-          
+          table.symbols.erase(candidate->GetPartySymbol());
+          table.candidates.erase(table.candidates.begin() + (candidate - table.candidates.data()));
+          table.ids.erase(id);
+          dropped.push_back(id);
         }
-        else
+      }
+      for (const Candidate& row : changed)
+      {
+        Candidate* candidate = table.Find(row.GetCandidateID());
+        if (candidate == nullptr)
         {
-          std::cerr << errorMessage << '\n';
-          while(true)
-          { 
-              std::string newCandidateIdInput = "New Candidate ID (only alphanumeric) ";
-              mid = GetValidString(newCandidateIdInput);
-              if (ValidateCandidateID(mid) )
-              {
-                 idSet.insert(mid);
-                 modify.SetCandidateID(mid);
-                 //std::cout << "Candidate Information Updated Successfully \n";
-                 break;
-              }
-              else
-              {
-                   std::cout << errorMessage << '\n';
-                   std::cout << "Do you want to continue ?  n for back \n";
-                   std::string characterChoice = "a character";
-                   char result = GetValidChar(characterChoice);
-                   if(result == 'n')
-                    { 
-                        return false;;
-                    }
-             }
+          rejected++;
+          continue;
+        }
+        std::string symbol = candidate->GetPartySymbol();
+        if (symbol != row.GetPartySymbol())
+        {
+          table.symbols.erase(symbol);
+          if (!ValidatePartySymbol(row.GetPartySymbol(), table))
+          {
+            table.symbols.insert(symbol);
+            rejected++;
+            continue;
           }
+          table.symbols.insert(row.GetPartySymbol());
+          candidate->SetPartySymbol(row.GetPartySymbol());
         }
-        
-        //Candidate Name
-        if (ValidateCandidateName(mname) )
+        candidate->SetCandidateName(row.GetCandidateName());
+        candidate->SetRegion(row.GetRegion());
+        edited++;
+      }
+      for (const Candidate& row : added)
+      {
+        if (ValidateCandidateID(row.GetCandidateID(), table) && ValidatePartySymbol(row.GetPartySymbol(), table))
         {
-          
-          
+          table.candidates.push_back(row);
+          table.ids.insert(row.GetCandidateID());
+          table.symbols.insert(row.GetPartySymbol());
+          joined.push_back(row);
         }
         else
         {
-          std::cerr << errorMessage << '\n';
-          while(true)
-          { 
-              std::string  newCandidateNameInput= "New Candidate Name (only characters ) ";
-              mname = GetValidString(newCandidateNameInput);
-              if (ValidateCandidateName(mname) )
-              {
-                 modify.SetCandidateName(mname);
-                 //std::cout << "Candidate Information Updated Successfully \n";
-                 break;
-              }
-              else
-              {
-                   std::cerr << errorMessage << '\n';
-                   std::cout << "Do you want to continue ?  n for back \n";
-                   std::string characterChoice = "a character";
-                   char result = GetValidChar(characterChoice);
-                   if(result == 'n')
-                    { 
-                        return false;;
-                    }
-             }
-          }
+          rejected++;
         }
-        
-        //Candiadate Symbol
-        if (ValidatePartySymbol(msymbol) )
+      }
+      return !dropped.empty() || edited > 0 || !joined.empty();
+    });
+
+    // The tally follows the table. Candidate.delta may still hold counts of a
+    // dropped candidate, so it is folded into Candidate.csv on exit:
+    for (const std::string& id : dropped)
+    {
+      votesSet.Remove(id);
+      voteJournal.RecordRemoval(id);
+      dirtyCandidates.erase(id);
+      candidatesChanged = true;
+    }
+    for (const Candidate& candidate : joined)
+    {
+      votesSet.Add(candidate.GetCandidateID(), candidate.GetNumOfVotes());
+      if (candidate.GetNumOfVotes() > 0)
+      {
+        voteJournal.RecordCarry(candidate.GetCandidateID(), candidate.GetNumOfVotes());
+      }
+    }
+
+    Out() << "Reloaded Candidate.csv: " << joined.size() << " added, " << dropped.size() << " removed, "
+          << edited << " changed";
+    if (skipped + rejected > 0)
+    {
+      Out() << ", " << skipped + rejected << " rows rejected";
+    }
+    if (voteEdits > 0)
+    {
+      Out() << ", " << voteEdits << " vote count edits ignored";
+    }
+    Out() << '\n';
+  }
+
+  // Diffs Voter.csv against the rows last read and applies the added, removed
+  // and changed voters, with validation.
+  void ElectionSystem::ReloadVoters()
+  {
+    EnsureVoterRoll();
+    std::ifstream inputFile(DataPath("Voter.csv"));
+    if (!inputFile.is_open())
+    {
+      return;
+    }
+
+    // Read the valid rows as packed Aadhar ID << 1 | voting status:
+    std::vector<uint64_t> rows;
+    std::unordered_set<uint64_t> invalidKeys;
+    size_t skipped = 0;
+    std::string line;
+    while (std::getline(inputFile, line))
+    {
+      CsvFields fields(line);
+      std::string_view aadharField, statusField;
+      bool voted = false;
+      fields.Next(aadharField);
+      bool hasStatus = fields.Next(statusField);
+      bool validAadhar = MatchesField<ActiveRules::kAadhar>(aadharField);
+      if (validAadhar && hasStatus && ParseStatus(statusField, voted))
+      {
+        rows.push_back(PackAadhar(aadharField) << 1 | voted);
+      }
+      else if (!line.empty())
+      {
+        if (validAadhar)
         {
-          
-          
+          invalidKeys.insert(PackAadhar(aadharField));
         }
-        else
+        skipped++;
+      }
+    }
+
+    // A voter whose row turned invalid keeps their last valid row:
+    if (!invalidKeys.empty())
+    {
+      for (uint64_t row : voterFileRows)
+      {
+        if (invalidKeys.count(row >> 1) != 0)
         {
-          std::cerr << errorMessage << '\n';
-          while(true)
-          { 
-              std::string newPartySymbolInput = "New Party Symbol (only characters ) ";
-              msymbol = GetValidString(newPartySymbolInput);
-              if (ValidatePartySymbol(msymbol) )
-              {
-                 //std::cout << "Candidate Information Updated Successfully \n";
-                 symbolSet.insert(msymbol);
-                 modify.SetPartySymbol(msymbol);
-                 break;
-              }
-              else
-              {
-                   std::cerr << errorMessage << '\n';
-                   std::cout << "Invalid Party Symbol \n";
-                   std::cout << "Do you want to continue ?  n for back \n";
-                   std::string characterChoice = "a character";
-                   char result = GetValidChar(characterChoice);
-                   if(result == 'n')
-                    { 
-                        return false;
-                    }
-             }
-          }
+          rows.push_back(row);
         }
-        
-        if(ValidateRegionCode(mreg))
+      }
+    }
+
+    // Sort by Aadhar ID, keeping the first row of a repeated ID:
+    auto byID = [](uint64_t a, uint64_t b) { return a >> 1 < b >> 1; };
+    std::stable_sort(rows.begin(), rows.end(), byID);
+    rows.erase(std::unique(rows.begin(), rows.end(), [](uint64_t a, uint64_t b) { return a >> 1 == b >> 1; }),
+               rows.end());
+
+    // Sorted merge against the rows last read:
+    std::vector<uint64_t> added, removed, changed;
+    size_t i = 0, j = 0;
+    while (i < voterFileRows.size() || j < rows.size())
+    {
+      if (j == rows.size() || (i < voterFileRows.size() && byID(voterFileRows[i], rows[j])))
+      {
+        removed.push_back(voterFileRows[i++]);
+      }
+      else if (i == voterFileRows.size() || byID(rows[j], voterFileRows[i]))
+      {
+        added.push_back(rows[j++]);
+      }
+      else
+      {
+        if (voterFileRows[i] != rows[j])
         {
-         
+          changed.push_back(rows[j]);
         }
-        else
-        {
-          std::cerr << errorMessage << '\n';
-          while(true)
-          { 
-            std::string newRegionIdInput = "New Region ID (only alphanumeric) ";
-            mreg = GetValidString(newRegionIdInput);
-            if (ValidateRegionCode(mreg) )
-            {
-               
-               break;
-             }
-             else
-              {
-                   std::cerr << errorMessage << '\n';
-                   std::cout << "Invalid Region ID \n";
-                   std::cout << "Do you want to continue ?  n for back \n";
-                   std::string characterChoice = "a character";
-                   char result = GetValidChar(characterChoice);
-                   if(result == 'n')
-                    { 
-                        return false;
-                    }
-             }
-           } 
-         }
-         Candidate candidate(mid, mname, msymbol, mreg,mcount);
-         validCandidateList.push_back(candidate);
-         temp.erase(temp.begin() + candidateChoice-1);
-         invalidCandidateList.swap(temp);
-         idSet.insert(mid);
-         symbolSet.insert(msymbol);
-         std::cout << "Candidate Information Updated Successfully \n";
-         return true;
+        i++;
+        j++;
       }
-      else 
+    }
+    voterFileRows.swap(rows);
+
+    // Status changes are found by the roll's own lookup:
+    size_t edited = 0;
+    for (uint64_t row : changed)
+    {
+      std::string aadhar = UnpackAadhar(row >> 1);
+      long index = FindVoter(aadhar);
+      if (index >= 0)
       {
-        std::cout << "Invalid Choice \n";
-        std::cout << "Do you want to continue ?  n for back \n";
-        std::string characterChoice = "a character";
-        char result = GetValidChar(characterChoice);
-        if(result == 'n')
-        { 
-           return false;
+        validVoterList[index].SetVotingStatus(row & 1);
+        MarkVoterDirty(aadhar, row & 1);  // Outranks older delta rows
+        NoteVoterChange(aadhar, row & 1);
+        edited++;
+      }
+    }
+
+    // Removals are compacted out of the roll in one pass:
+    std::unordered_set<uint64_t> gone;
+    for (uint64_t row : removed)
+    {
+      std::string aadhar = UnpackAadhar(row >> 1);
+      if (checkAadhar.erase(aadhar) > 0)
+      {
+        gone.insert(row >> 1);
+        dirtyVoters.erase(aadhar);
+        NoteVoterRemoval(aadhar);
+      }
+    }
+    if (!gone.empty())
+    {
+      size_t kept = 0;
+      for (size_t k = 0; k < validVoterList.size(); k++)
+      {
+        uint64_t key = sortedRoll ? voterKeys[k] : PackAadhar(validVoterList[k].GetAadharID());
+        if (gone.count(key) == 0)
+        {
+          if (sortedRoll)
+          {
+            voterKeys[kept] = key;
+          }
+          if (kept != k)
+          {
+            validVoterList[kept] = std::move(validVoterList[k]);
+          }
+          kept++;
         }
       }
-   }
+      validVoterList.erase(validVoterList.begin() + kept, validVoterList.end());
+      if (sortedRoll)
+      {
+        voterKeys.resize(kept);
+      }
+    }
+
+    // Additions go to their sorted position, or are sorted in with the roll
+    // when there are many:
+    size_t joined = 0, rejected = 0;
+    bool resort = sortedRoll && added.size() > kReloadInsertLimit;
+    for (uint64_t row : added)
+    {
+      std::string aadhar = UnpackAadhar(row >> 1);
+      if (VoterRegistered(aadhar))
+      {
+        rejected++;
+        continue;
+      }
+      RegisterAadhar(aadhar);
+      if (resort)
+      {
+        validVoterList.emplace_back(aadhar, row & 1);
+      }
+      else
+      {
+        InsertVoter(Voter(aadhar, row & 1));
+      }
+      NoteVoterChange(aadhar, row & 1);
+      joined++;
+    }
+    if (resort)
+    {
+      SortVoterRoll();
+    }
+
+    Out() << "Reloaded Voter.csv: " << joined << " added, " << gone.size() << " removed, " << edited
+          << " changed";
+    if (skipped + rejected > 0)
+    {
+      Out() << ", " << skipped + rejected << " rows rejected";
+    }
+    Out() << '\n';
   }
-  
-// Removes a candidate from the validCandidateList based on their ID.
-//
-// Returns:
-//   true if a candidate was successfully removed, false if the user cancelled.
-bool ElectionSystem::RemoveCandidate() {
-  // Check for available candidates:
-  if (validCandidateList.empty()) {
-    std::cerr << "No candidates available to remove." << std::endl;
-    return false;  // Exit if no candidates
+
+  // Sorts validVoterList by Aadhar ID and rebuilds voterKeys.
+  void ElectionSystem::SortVoterRoll()
+  {
+    voterKeys.clear();
+    voterKeys.reserve(validVoterList.size());
+    for (const auto& voter : validVoterList)
+    {
+      voterKeys.push_back(PackAadhar(voter.GetAadharID()));
+    }
+
+    std::vector<uint32_t> order = RadixSortOrder(voterKeys);
+    std::vector<Voter> sortedVoters;
+    std::vector<uint64_t> sortedKeys;
+    sortedVoters.reserve(order.size());
+    sortedKeys.reserve(order.size());
+    for (uint32_t position : order)
+    {
+      sortedVoters.push_back(validVoterList[position]);
+      sortedKeys.push_back(voterKeys[position]);
+    }
+    validVoterList.swap(sortedVoters);
+    voterKeys.swap(sortedKeys);
   }
 
-  // Display current candidate list:
-  std::cout << "Candidate List:\n";
-  for (const Candidate& candidate : validCandidateList) {
-    std::cout << " Candidate ID: " << candidate.GetCandidateID()
-              << " Name: " << candidate.GetCandidateName()
-              << " Party Symbol: " << candidate.GetPartySymbol()
-              << " Region ID: " << candidate.GetRegion() << '\n';
+  // Finds a voter in validVoterList, by interpolation search for a sorted roll.
+  //
+  // Args:
+  //   aadhar: The voter's Aadhar ID.
+  //
+  // Returns:
+  //   The index of the voter, or -1 if the voter is not registered.
+  long ElectionSystem::FindVoter(const std::string& aadhar)
+  {
+    if (sortedRoll)
+    {
+      if (!MatchesField<ActiveRules::kAadhar>(aadhar))
+      {
+        return -1;
+      }
+      return InterpolationSearch(voterKeys, PackAadhar(aadhar));
+    }
+
+    auto it = std::find_if(validVoterList.begin(), validVoterList.end(), [&aadhar](const Voter& voter) {
+      return voter.GetAadharID() == aadhar;
+    });
+    return it == validVoterList.end() ? -1 : static_cast<long>(it - validVoterList.begin());
   }
 
-  // Repeatedly prompt for candidate ID until a valid one is entered or user cancels:
-  while (true) {
-    // Prompt for candidate ID:
-    std::string candidateID;
-    std::cout << "Enter Candidate ID to remove: ";
-    std::cin >> candidateID;
+  // Adds a voter to validVoterList, at its sorted position for a sorted roll.
+  //
+  // Args:
+  //   voter: The voter to add.
+  void ElectionSystem::InsertVoter(const Voter& voter)
+  {
+    if (voterStore.IsOpen())
+    {
+      voterStore.Insert(voter.GetAadharID(), voter.GetVotingStatus());
+      return;
+    }
+    if (!sortedRoll)
+    {
+      validVoterList.push_back(voter);
+      return;
+    }
 
-    // Find candidate in validCandidateList:
-    auto it = std::find_if(validCandidateList.begin(), validCandidateList.end(),
-                           [candidateID](const Candidate& candidate) {
-                             return candidate.GetCandidateID() == candidateID;
-                           });
+    uint64_t key = PackAadhar(voter.GetAadharID());
+    auto position = std::lower_bound(voterKeys.begin(), voterKeys.end(), key) - voterKeys.begin();
+    voterKeys.insert(voterKeys.begin() + position, key);
+    validVoterList.insert(validVoterList.begin() + position, voter);
+  }
 
-    // Handle found or not found scenarios:
-    if (it != validCandidateList.end()) {
-      // Remove candidate and provide success message:
-      validCandidateList.erase(it);
-      votesSet.erase(candidateID);
-      idSet.erase(candidateID);
-      std::cout << "Candidate with ID: " << candidateID << " removed successfully!" << std::endl;
-      return true;
-    } else {
-      // Handle not found scenario and prompt to continue:
-      std::cout << "Candidate with ID: " << candidateID << " not found." << std::endl;
-      std::cout << "Do you want to continue ?  n for back \n";
-      std::string characterChoice = "a character";
-         char result = GetValidChar(characterChoice);
-      if(result == 'n')
-      { 
-        return false;
-      }
+  // Removes a voter from validVoterList.
+  //
+  // Args:
+  //   index: The index of the voter to remove.
+  void ElectionSystem::EraseVoter(size_t index)
+  {
+    if (sortedRoll)
+    {
+      voterKeys.erase(voterKeys.begin() + index);
     }
+    validVoterList.erase(validVoterList.begin() + index);
   }
-}
 
+  
+  
+  // Starts loading the voter roll on a background thread.
+  void ElectionSystem::StartVoterRollLoad()
+  {
+    voterLoad = std::async(std::launch::async, &ElectionSystem::VoterCsvCheck, this);
+  }
 
-  // Modifies a candidate's information in the validCandidateList.
+  // Makes the voter roll available, waiting for the background load or loading it now.
   //
   // Returns:
-  //   true if a candidate was successfully modified, false if the user cancelled.
-  bool ElectionSystem::ModifyCandidate()
+  //   true if at least one valid voter was found, false otherwise.
+  bool ElectionSystem::EnsureVoterRoll()
   {
-      // Check for available candidates:
-      if (validCandidateList.empty()) {
-        std::cerr << "No candidates available to modify.\n";
-        return false;;
-       }
-       // Display current candidate list for user reference:
-       std::cout << "Candidate List \n";
-       for (auto& candidate : validCandidateList) {
-         std::cout  << " Candidate ID: " << candidate.GetCandidateID()
-                   << " Name: " << candidate.GetCandidateName()
-                   << " Party Symbol: " << candidate.GetPartySymbol()
-                   << " Region ID: " << candidate.GetRegion() << '\n';
+    if (voterLoad.valid())
+    {
+      voterLoad.get();
+    }
+    else if (!voterRollLoaded)
+    {
+      VoterCsvCheck();
+    }
+    return VoterCount() >= 1;
+  }
+
+  // Checks the Aadhar ID format without touching errorMessage, so it is safe to
+  // call from the background voter loader.
+  bool ElectionSystem::IsAadharFormat(const std::string& aadhar)
+  {
+    // Check the length and digits against the active rule set
+    return MatchesField<ActiveRules::kAadhar>(aadhar);
+  }
+
+  // Checks the voting status format without touching errorMessage.
+  bool ElectionSystem::IsStatusFormat(const std::string& status)
+  {
+    // Check if the string is either "0" or "1" (see field_parser.h)
+    bool voted = false;
+    return ParseStatus(status, voted);
+  }
+
+  bool ElectionSystem:: IsValidAadhar(const std::string& aadhar) {
+    if(IsAadharFormat(aadhar))
+    {
+      errorMessage = "";
+      return true;
+    }
+    
+    else
+    { 
+      errorMessage =  "Invalid Aadhar ID ";
+      return false;;
+    }
+  }
+
+ bool ElectionSystem:: IsValidStatus(const std::string& status) {
+    if(IsStatusFormat(status))
+    {
+      errorMessage = "";
+      return true;
+    }
+    else
+    {
+      errorMessage = "Invalid Voting Status ";
+      return false;;
+    } 
+ }
+  
+  // Redirects the operator console, e.g. to replay a recorded script.
+  //
+  // Args:
+  //   in: The stream operator input is read from.
+  //   out: The stream prompts and messages are written to.
+  //   err: The stream error messages are written to.
+  void ElectionSystem::SetConsole(std::istream& in, std::ostream& out, std::ostream& err)
+  {
+    input = &in;
+    output = &out;
+    errors = &err;
+  }
+
+  std::istream& ElectionSystem::In() { return *input; }
+  std::ostream& ElectionSystem::Out() { return *output; }
+  std::ostream& ElectionSystem::Err() { return *errors; }
+
+  // Repeatedly prompts the user to enter a valid integer choice.
+  //
+  // Returns:
+  //   The valid integer entered by the user.
+  int ElectionSystem:: GetChoice() 
+  {
+    while (true) // Loop until valid input is received
+    {  
+      Out() << "Enter your choice: ";
+      int choice{};
+      In() >> choice;
+
+      // Check for input failure:
+      if (!In()) {
+        if (In().eof()) {  // If the input stream was closed
+          throw EndOfInput();  // End the session
+        } else {  // Handle invalid input
+          In().clear();  // Reset the input stream
+          In().ignore(std::numeric_limits<std::streamsize>::max(), '\n');  // Discard invalid input
+          Err() << "Oops, that input is invalid. Please try again.\n";
+        }
+      } else {  // Input is valid
+        In().ignore(std::numeric_limits<std::streamsize>::max(), '\n');  // Discard any extra input
+        return choice;  // Return the valid integer
+      }
+    }
+  }
+
+  
+// Repeatedly prompts the user to enter a valid string for a given field.
+//
+// Args:
+//   fieldName: The name of the field to prompt for.
+//
+// Returns:
+//   The valid string entered by the user.
+std::string ElectionSystem::GetValidString(const std::string& fieldName) {
+  while (true) {  // Loop until valid input is received
+    Out() << "Enter " << fieldName << ": ";
+    std::string input;
+    std::getline(In(), input);
+
+    // Check for input failure:
+    if (!In()) {
+      if (In().eof()) {  // If the input stream was closed
+        throw EndOfInput();  // End the session
+      }
+      In().clear();  // Reset the input stream
+      In().ignore(std::numeric_limits<std::streamsize>::max(), '\n');  // Discard invalid input
+      Out() << "Oops, there was an error. Please try again.\n";
+    } else {  // Input is valid
+      return input;  // Return the valid string
+    }
+  }
+}
+
+
+// Repeatedly prompts the user to enter a valid character for a given field.
+//
+// Args:
+//   fieldName: The name of the field to prompt for.
+//
+// Returns:
+//   The valid character entered by the user.
+char ElectionSystem:: GetValidChar(const std::string& fieldName) {
+  while (true) {  // Loop until valid input is received
+    Out() << "Enter " << fieldName << ": ";
+    char input;
+    In() >> input;
+
+    // Check for input failure:
+    if (In().fail()) {
+      if (In().eof()) {  // If the input stream was closed
+        throw EndOfInput();  // End the session
+      }
+      In().clear();  // Reset the input stream
+      In().ignore(std::numeric_limits<std::streamsize>::max(), '\n');  // Discard invalid input
+      Out() << "Oops, there was an error. Please try again.\n";
+    } else {  // Input is valid
+      In().ignore(std::numeric_limits<std::streamsize>::max(), '\n');  // Discard any extra input
+      return input;  // Return the valid character
+    }
+  }
+}
+
+
+// Repeatedly prompts the user for admin credentials until successful or cancelled.
+//
+// Returns:
+//   true if authentication is successful, false if the user cancels.
+bool ElectionSystem::GetAdminAuthenicate() {
+  while (true) {  // Loop until authentication or cancellation
+    // Get valid username and password from user:
+    std::string adminUsername="Admin Username ";
+    std::string adminPassword="Admin Password ";
+    std::string username = GetValidString(adminUsername);
+    std::string password = GetValidString(adminPassword);
+
+    // Check the stored verification record. Unknown usernames pay for a hash of
+    // the same cost, so the response time does not reveal which usernames exist.
+    bool verified = false;
+    auto it = adminCredentials.find(username);
+    if (it != adminCredentials.end()) {
+      verified = it->second.Verify(password);
+    } else {
+      CredentialRecord::Create(password, adminSpaceCost, adminTimeCost);
+    }
+
+    // Until Admin.csv holds an admin, the default admin signs in once to set
+    // the first password:
+    if (!verified && adminCredentials.empty() && username == "admin" && password == "admin") {
+      verified = SetFirstAdminPassword();
+    }
+
+    // Check for successful authentication:
+    if (verified) {
+      return true;  // Authentication successful
+    } else {
+      // Invalid credentials:
+      Out() << "Invalid Username or Password\n";
+      Out() << "Do you want to continue? (n for back)\n";
+      std::string characterChoice = "a character";
+      char result = GetValidChar(characterChoice);
+      if (result == 'n') {
+        return false;  // User cancelled
+      }
+    }
+  }
+}
+
+
+// Prompts for the password of the first admin, "admin", and stores its
+// verification record in Admin.csv, so the default password stops working.
+//
+// Returns:
+//   true if the password was set, false if the user cancels.
+bool ElectionSystem::SetFirstAdminPassword() {
+  Out() << "No admin is on file. Choose a password for admin.\n";
+  while (true) {
+    std::string newPassword = "New Admin Password ";
+    std::string confirmPassword = "New Admin Password again ";
+    std::string password = GetValidString(newPassword);
+    if (password.size() < 8 || password == "admin") {
+      Out() << "The password needs at least 8 characters and cannot be admin\n";
+    } else if (GetValidString(confirmPassword) != password) {
+      Out() << "The passwords do not match\n";
+    } else {
+      adminCredentials["admin"] = CredentialRecord::Create(password, adminSpaceCost, adminTimeCost);
+      WriteAdminDataToCSV();
+      return true;
+    }
+    Out() << "Do you want to continue? (n for back)\n";
+    std::string characterChoice = "a character";
+    if (GetValidChar(characterChoice) == 'n') {
+      return false;
+    }
+  }
+}
+
+
+// Gathers valid candidate information from the user and adds it to the candidate table.
+//
+// Returns:
+//   true if a candidate was successfully added, false if the user cancelled.
+bool ElectionSystem::AddCandidate() 
+{
+  std::string id, name, symbol, regionCode;
+
+  // Get and validate candidate ID:
+  while (true) {
+    std::string candidateIdInput = "Candidate ID (only alphanumeric)";
+    id = GetValidString(candidateIdInput);
+    if (ValidateCandidateID(id)) {  // Ensure valid ID format and uniqueness
+      
+      break;
+    } else {
+      // Handle invalid ID:
+      Err() << errorMessage << '\n';
+      Out() << "Do you want to continue ?  n for back \n";
+      std::string characterChoice = "a character";
+      char result = GetValidChar(characterChoice);
+      if(result == 'n')  return false;  // Offer to try again or cancel
+    }
+  }
+
+  // Get and validate candidate name:
+  while (true) {
+    std::string candidateNameInput = "Candidate Name (only alphabets )";
+    name = GetValidString(candidateNameInput);
+    if (ValidateCandidateName(name)) 
+    {
+      break;
+    } 
+    else 
+    {
+      // Handle invalid name:
+      Err() << errorMessage << '\n';
+      Out() << "Do you want to continue ?  n for back \n";
+      std::string characterChoice = "a character";
+      char result = GetValidChar(characterChoice);
+         if(result == 'n')
+         { 
+          // Store partial candidate info if cancelled
+           Candidate candidate(id, "", "", "");
+           invalidCandidates.Add(candidate, CandidateProblems(candidate, *validCandidates.Current()));
+           return false;
+         }
+    }
+  }
+
+  // Get and validate party symbol:
+  while (true) {
+    std::string partySymbolInput = "Party Symbol (only characters )";
+    symbol = GetValidString(partySymbolInput);
+    if (ValidatePartySymbol(symbol)) {  // Ensure valid symbol format and uniqueness
+      
+      break;
+    } else {
+      // Handle invalid symbol:
+      Err() << errorMessage << '\n';
+      Out() << "Do you want to continue ?  n for back \n";
+         std::string characterChoice = "a character";
+         char result = GetValidChar(characterChoice);
+         if(result == 'n')
+         { 
+           Candidate candidate(id, name, "", "");
+           invalidCandidates.Add(candidate, CandidateProblems(candidate, *validCandidates.Current()));
+           return false;
+         }
+    }
+  }
+
+  // Get and validate region ID:
+  while (true) {
+    std::string regionIdInput = "Region ID (only alphanumeric)";
+    regionCode = GetValidString(regionIdInput);
+    if (ValidateRegionCode(regionCode)) {
+      break;
+    } else {
+      // Handle invalid region ID:
+      Err() << errorMessage << '\n';
+      Out() << "Do you want to continue ?  n for back \n";
+         std::string characterChoice = "a character";
+         char result = GetValidChar(characterChoice);
+         if(result == 'n')
+         { 
+           Candidate candidate(id, name, symbol, "");
+           invalidCandidates.Add(candidate, CandidateProblems(candidate, *validCandidates.Current()));
+           return false;
+         }
+    }
+  }
+
+  // Create the candidate and publish a table version with it added, unless
+  // another edit took the ID or symbol in the meantime:
+  Candidate candidate(id, name, symbol, regionCode);
+  bool added = validCandidates.Edit([&](CandidateTable& table) {
+    if (!ValidateCandidateID(id, table) || !ValidatePartySymbol(symbol, table)) {
+      return false;
+    }
+    table.candidates.push_back(candidate);
+    table.ids.insert(id);  // Track used IDs
+    table.symbols.insert(symbol);  // Track used symbols
+    return true;
+  });
+  if (!added) {
+    Err() << errorMessage << '\n';
+    return false;
+  }
+  votesSet.Add(id, 0);  // Start the tally, so exports list the candidate
+  candidatesChanged = true;
+
+  // Success message:
+  Out() << "Candidate Added Successfully\n";
+  return true;
+}
+
+  
+  
+  // Identifies and guides the user to fill missing or invalid information in invalidCandidateList.
+  //
+  // Returns:
+  //   true if candidates were successfully updated, false if the user cancelled.
+  bool ElectionSystem::FillMissingCandidateInfo()
+  {
+      if(!invalidCandidates.Empty())
+      Out() << "Fill missing data or update invalid data \n";
+      else{
+      Out() << "No need to fill or to update invalid data \n";
+      return false;;
+      }
+      PrintInvalidCandidates(0, 1);
+      while(true)
+      {
+       // Let the operator page through the records or repair them in bulk:
+       size_t recordID = 0;
+       if (!PickInvalidRecord(invalidCandidates, recordID,
+                              [this](unsigned problem, size_t page) { PrintInvalidCandidates(problem, page); },
+                              [this]() { return AutoRepairCandidates(); }))
+       {
+         return false;
+       }
+       {
+         Candidate modify = *invalidCandidates.Find(recordID);
+         std::string mid = modify.GetCandidateID();
+         std::string mname = modify.GetCandidateName();
+         std::string msymbol = modify.GetPartySymbol(); 
+         std::string mreg = modify.GetRegion();
+         int64_t mcount = modify.GetNumOfVotes();
+
+         
+         
+        //Candiadate ID 
+        if (ValidateCandidateID(mid) )
+        {
+          
+        }
+        else
+        {
+          Err() << errorMessage << '\n';
+          while(true)
+          { 
+              std::string newCandidateIdInput = "New Candidate ID (only alphanumeric) ";
+              mid = GetValidString(newCandidateIdInput);
+              if (ValidateCandidateID(mid) )
+              {
+                 modify.SetCandidateID(mid);
+                 //Out() << "Candidate Information Updated Successfully \n";
+                 break;
+              }
+              else
+              {
+                   Out() << errorMessage << '\n';
+                   Out() << "Do you want to continue ?  n for back \n";
+                   std::string characterChoice = "a character";
+                   char result = GetValidChar(characterChoice);
+                   if(result == 'n')
+                    { 
+                        return false;;
+                    }
+             }
+          }
+        }
+        
+        //Candidate Name
+        if (ValidateCandidateName(mname) )
+        {
+          
+          
+        }
+        else
+        {
+          Err() << errorMessage << '\n';
+          while(true)
+          { 
+              std::string  newCandidateNameInput= "New Candidate Name (only characters ) ";
+              mname = GetValidString(newCandidateNameInput);
+              if (ValidateCandidateName(mname) )
+              {
+                 modify.SetCandidateName(mname);
+                 //Out() << "Candidate Information Updated Successfully \n";
+                 break;
+              }
+              else
+              {
+                   Err() << errorMessage << '\n';
+                   Out() << "Do you want to continue ?  n for back \n";
+                   std::string characterChoice = "a character";
+                   char result = GetValidChar(characterChoice);
+                   if(result == 'n')
+                    { 
+                        return false;;
+                    }
+             }
+          }
+        }
+        
+        //Candiadate Symbol
+        if (ValidatePartySymbol(msymbol) )
+        {
+          
+          
+        }
+        else
+        {
+          Err() << errorMessage << '\n';
+          while(true)
+          { 
+              std::string newPartySymbolInput = "New Party Symbol (only characters ) ";
+              msymbol = GetValidString(newPartySymbolInput);
+              if (ValidatePartySymbol(msymbol) )
+              {
+                 //Out() << "Candidate Information Updated Successfully \n";
+                 modify.SetPartySymbol(msymbol);
+                 break;
+              }
+              else
+              {
+                   Err() << errorMessage << '\n';
+                   Out() << "Invalid Party Symbol \n";
+                   Out() << "Do you want to continue ?  n for back \n";
+                   std::string characterChoice = "a character";
+                   char result = GetValidChar(characterChoice);
+                   if(result == 'n')
+                    { 
+                        return false;
+                    }
+             }
+          }
+        }
+        
+        if(ValidateRegionCode(mreg))
+        {
+         
+        }
+        else
+        {
+          Err() << errorMessage << '\n';
+          while(true)
+          { 
+            std::string newRegionIdInput = "New Region ID (only alphanumeric) ";
+            mreg = GetValidString(newRegionIdInput);
+            if (ValidateRegionCode(mreg) )
+            {
+               
+               break;
+             }
+             else
+              {
+                   Err() << errorMessage << '\n';
+                   Out() << "Invalid Region ID \n";
+                   Out() << "Do you want to continue ?  n for back \n";
+                   std::string characterChoice = "a character";
+                   char result = GetValidChar(characterChoice);
+                   if(result == 'n')
+                    { 
+                        return false;
+                    }
+             }
+           } 
+         }
+         Candidate candidate(mid, mname, msymbol, mreg,mcount);
+         bool added = validCandidates.Edit([&](CandidateTable& table) {
+           if (!ValidateCandidateID(mid, table) || !ValidatePartySymbol(msymbol, table)) {
+             return false;
+           }
+           table.candidates.push_back(candidate);
+           table.ids.insert(mid);
+           table.symbols.insert(msymbol);
+           return true;
+         });
+         if (!added)
+         {
+           Err() << errorMessage << '\n';
+           return false;
+         }
+         votesSet.Add(mid, mcount);
+         if (mcount > 0) {
+           voteJournal.RecordCarry(mid, mcount);
+         }
+         invalidCandidates.Remove(recordID);
+         candidatesChanged = true;
+         Out() << "Candidate Information Updated Successfully \n";
+         return true;
+      }
+   }
+  }
+  
+// Finds every problem of a candidate row.
+//
+// Args:
+//   candidate: The candidate row.
+//   table: The table its ID and party symbol must be unique in.
+//
+// Returns:
+//   The RecordProblem bits the row fails on.
+unsigned ElectionSystem::CandidateProblems(const Candidate& candidate, const CandidateTable& table)
+{
+  const std::string& id = candidate.GetCandidateID();
+  const std::string& symbol = candidate.GetPartySymbol();
+  unsigned problems = 0;
+  if (id.empty() || candidate.GetCandidateName().empty() || symbol.empty() || candidate.GetRegion().empty()) {
+    problems |= kMissingField;
+  }
+  if (table.ids.count(id) != 0) {
+    problems |= kDuplicateCandidateID;
+  } else if (!MatchesField<ActiveRules::kCandidateID>(id)) {
+    problems |= kBadCandidateID;
+  }
+  if (!MatchesField<ActiveRules::kCandidateName>(candidate.GetCandidateName())) {
+    problems |= kBadName;
+  }
+  if (table.symbols.count(symbol) != 0) {
+    problems |= kDuplicateSymbol;
+  } else if (!MatchesField<ActiveRules::kPartySymbol>(symbol)) {
+    problems |= kBadSymbol;
+  }
+  if (!MatchesField<ActiveRules::kRegionCode>(candidate.GetRegion())) {
+    problems |= kBadRegion;
+  }
+  return problems;
+}
+
+// Prints a page of the invalid candidates, with the count of each problem.
+//
+// Args:
+//   problem: A single problem bit to list, or 0 for all records.
+//   page: The 1-based page to print.
+void ElectionSystem::PrintInvalidCandidates(unsigned problem, size_t page)
+{
+  size_t count = invalidCandidates.FilteredSize(problem);
+  size_t pages = std::max<size_t>((count + kRepairPageSize - 1) / kRepairPageSize, 1);
+  page = std::min(std::max<size_t>(page, 1), pages);
+  Out() << invalidCandidates.Size() << " invalid candidates (" << invalidCandidates.Summary() << ")\n";
+  for (size_t id : invalidCandidates.Page(problem, page, kRepairPageSize)) {
+    const Candidate& candidate = *invalidCandidates.Find(id);
+    Out() << id + 1 << " Candidate ID: " << candidate.GetCandidateID()
+          << " Name: " << candidate.GetCandidateName()
+          << " Party Symbol: " << candidate.GetPartySymbol()
+          << " Region ID: " << candidate.GetRegion() << '\n';
+  }
+  Out() << "Page " << page << " of " << pages;
+  if (problem != 0) {
+    Out() << " (" << RecordProblemName(problem) << ")";
+  }
+  Out() << ".\n";
+}
+
+// Registers every invalid candidate that only needs its fields trimmed.
+//
+// Returns:
+//   The number of candidates repaired.
+size_t ElectionSystem::AutoRepairCandidates()
+{
+  std::vector<size_t> repaired;
+  std::vector<Candidate> added;
+  validCandidates.Edit([&](CandidateTable& table) {
+    repaired.clear();
+    added.clear();
+    for (size_t id : invalidCandidates.IDs()) {
+      const Candidate& record = *invalidCandidates.Find(id);
+      Candidate candidate(TrimField(record.GetCandidateID()), TrimField(record.GetCandidateName()),
+                          TrimField(record.GetPartySymbol()), TrimField(record.GetRegion()), record.GetNumOfVotes());
+      if (CandidateProblems(candidate, table) == 0) {
+        table.candidates.push_back(candidate);
+        table.ids.insert(candidate.GetCandidateID());
+        table.symbols.insert(candidate.GetPartySymbol());
+        repaired.push_back(id);
+        added.push_back(candidate);
+      }
+    }
+    return !added.empty();
+  });
+
+  for (size_t id : repaired) {
+    invalidCandidates.Remove(id);
+  }
+  for (const Candidate& candidate : added) {
+    votesSet.Add(candidate.GetCandidateID(), candidate.GetNumOfVotes());
+    if (candidate.GetNumOfVotes() > 0) {
+      voteJournal.RecordCarry(candidate.GetCandidateID(), candidate.GetNumOfVotes());
+    }
+  }
+  candidatesChanged = candidatesChanged || !added.empty();
+  return added.size();
+}
+
+// Reads repair workflow commands until the operator picks a record: a record
+// number picks it, "?<page>" prints a page, "?<problem>" lists the records
+// with a problem, "!" runs the automatic repair and "n" goes back.
+//
+// Args:
+//   records: The invalid records to pick from.
+//   id: Receives the ID of the picked record.
+//   printPage: Prints a page of the records, given a problem filter.
+//   autoRepair: Repairs what can be fixed mechanically, returning the count.
+//
+// Returns:
+//   true if a record was picked, false if the operator went back or ran the
+//   automatic repair.
+template <typename Record>
+bool ElectionSystem::PickInvalidRecord(const InvalidRecords<Record>& records, size_t& id,
+                                       const std::function<void(unsigned, size_t)>& printPage,
+                                       const std::function<size_t()>& autoRepair)
+{
+  unsigned problem = 0;
+  while (true) {
+    std::string recordPrompt = "a record number, ?<page>, ?<problem>, ! to repair automatically or n for back";
+    std::string input = GetValidString(recordPrompt);
+    if (input == "n") {
+      return false;
+    }
+    if (input == "!") {
+      Out() << "Repaired " << autoRepair() << " records automatically.\n";
+      return false;
+    }
+    if (!input.empty() && input[0] == '?') {
+      std::string argument = input.substr(1);
+      if (!argument.empty() && std::all_of(argument.begin(), argument.end(), ::isdigit)) {
+        printPage(problem, Convert2Int(argument));
+      } else if (argument.empty() || ParseRecordProblem(argument) != 0) {
+        problem = ParseRecordProblem(argument);
+        printPage(problem, 1);
+      } else {
+        Out() << "Unknown problem " << argument << '\n';
+      }
+      continue;
+    }
+    int64_t number = 0;
+    if (ParseCount(input, number)) {
+      if (number >= 1 && records.Find(number - 1) != nullptr) {
+        id = number - 1;
+        return true;
+      }
+    }
+    Out() << "Invalid Choice \n";
+  }
+}
+
+// Returns a field without surrounding blanks, carriage returns or quotes.
+std::string ElectionSystem::TrimField(const std::string& field)
+{
+  const char* const kBlanks = " \t\r\n\"'";
+  size_t first = field.find_first_not_of(kBlanks);
+  if (first == std::string::npos) {
+    return "";
+  }
+  return field.substr(first, field.find_last_not_of(kBlanks) - first + 1);
+}
+
+// Builds the cached candidate listing, unless it was built from the same
+// candidate table version.
+//
+// Args:
+//   table: The candidate table version to list.
+//
+// Returns:
+//   The listing, one line per candidate in table order.
+const std::string& ElectionSystem::CandidateListing(const CandidateTable& table)
+{
+  if (candidateListingVersion == table.version) {
+    return candidateListing;
+  }
+
+  candidateListing.clear();
+  listingLineStarts.clear();
+  regionListings.clear();
+  for (const Candidate& candidate : table.candidates) {
+    std::string line = " Candidate ID: " + candidate.GetCandidateID() +
+                       " Name: " + candidate.GetCandidateName() +
+                       " Party Symbol: " + candidate.GetPartySymbol() +
+                       " Region ID: " + candidate.GetRegion() + "\n";
+    listingLineStarts.push_back(candidateListing.size());
+    candidateListing += line;
+    regionListings[candidate.GetRegion()] += line;
+  }
+  listingLineStarts.push_back(candidateListing.size());
+  candidateListingVersion = table.version;
+  return candidateListing;
+}
+
+// Prints one page of the cached candidate listing in a single write. Short
+// listings are printed whole.
+//
+// Args:
+//   page: The 1-based page to print.
+void ElectionSystem::PrintCandidateListing(size_t page)
+{
+  std::shared_ptr<const CandidateTable> table = validCandidates.Current();
+  const std::string& listing = CandidateListing(*table);
+  size_t count = table->candidates.size();
+  if (count <= kListingPageSize) {
+    Out().write(listing.data(), listing.size());
+    return;
+  }
+
+  size_t pages = (count + kListingPageSize - 1) / kListingPageSize;
+  page = std::min(std::max<size_t>(page, 1), pages);
+  size_t first = (page - 1) * kListingPageSize;
+  size_t last = std::min(first + kListingPageSize, count);
+  Out().write(listing.data() + listingLineStarts[first], listingLineStarts[last] - listingLineStarts[first]);
+  Out() << "Page " << page << " of " << pages << ". Enter ?<page> for another page or ?<region> to list a region.\n";
+}
+
+// Prints the cached candidate listing of one region in a single write.
+//
+// Args:
+//   region: The region ID to list.
+void ElectionSystem::PrintRegionListing(const std::string& region)
+{
+  CandidateListing(*validCandidates.Current());
+  auto it = regionListings.find(region);
+  if (it == regionListings.end()) {
+    Out() << "No candidates in region " << region << '\n';
+    return;
+  }
+  Out().write(it->second.data(), it->second.size());
+}
+
+// Prints the candidates that best match a query, best match first.
+//
+// Args:
+//   query: Part of a candidate ID, name or party symbol.
+//   limit: The maximum number of candidates to print.
+//
+// Returns:
+//   The number of candidates printed.
+size_t ElectionSystem::PrintCandidateMatches(const std::string& query, size_t limit)
+{
+  // Search and list the same table version:
+  std::shared_ptr<const CandidateTable> table = validCandidates.Current();
+  if (searchIndexVersion != table->version) {
+    searchIndex.Build(table->candidates);
+    searchIndexVersion = table->version;
+  }
+
+  // Matches are positions in the table, like the listing lines:
+  const std::string& listing = CandidateListing(*table);
+  std::string lines;
+  for (size_t position : searchIndex.Search(query, limit)) {
+    lines.append(listing, listingLineStarts[position], listingLineStarts[position + 1] - listingLineStarts[position]);
+  }
+  Out().write(lines.data(), lines.size());
+  return std::count(lines.begin(), lines.end(), '\n');
+}
+
+// Suggests the candidates closest to a candidate ID that was not found.
+//
+// Args:
+//   input: The text the user entered.
+void ElectionSystem::SuggestCandidates(const std::string& input)
+{
+  if (input.empty()) {
+    return;
+  }
+  Out() << "Did you mean:\n";
+  if (PrintCandidateMatches(input, kSuggestions) == 0) {
+    Out() << " (no similar candidates)\n";
+  }
+}
+
+// Handles a listing command typed at a candidate ID prompt: "?<page>" prints a
+// page of the candidate listing, "?<region>" the candidates of a region and
+// "/<text>" the candidates whose ID, name or party symbol best match the text.
+//
+// Args:
+//   input: The text the user entered.
+//
+// Returns:
+//   true if the input was a listing command, false if it is a candidate ID.
+bool ElectionSystem::HandleListingCommand(const std::string& input)
+{
+  if (!input.empty() && input[0] == '/') {
+    if (PrintCandidateMatches(input.substr(1), kSearchResults) == 0) {
+      Out() << "No candidates match " << input.substr(1) << '\n';
+    }
+    return true;
+  }
+  if (input.empty() || input[0] != '?') {
+    return false;
+  }
+
+  std::string argument = input.substr(1);
+  if (!argument.empty() && std::all_of(argument.begin(), argument.end(), ::isdigit)) {
+    PrintCandidateListing(Convert2Int(argument));
+  } else if (!argument.empty()) {
+    PrintRegionListing(argument);
+  } else {
+    PrintCandidateListing(1);
+  }
+  return true;
+}
+
+// Removes a candidate from the candidate table based on their ID.
+//
+// Returns:
+//   true if a candidate was successfully removed, false if the user cancelled.
+bool ElectionSystem::RemoveCandidate() {
+  // Check for available candidates:
+  if (validCandidates.Current()->candidates.empty()) {
+    Err() << "No candidates available to remove." << '\n';
+    return false;  // Exit if no candidates
+  }
+
+  // Display current candidate list:
+  Out() << "Candidate List:\n";
+  PrintCandidateListing(1);
+
+  // Repeatedly prompt for candidate ID until a valid one is entered or user cancels:
+  while (true) {
+    // Prompt for candidate ID:
+    std::string candidateID;
+    Out() << "Enter Candidate ID to remove: ";
+    In() >> candidateID;
+    if (HandleListingCommand(candidateID)) {
+      continue;
+    }
+
+    // Publish a table version without the candidate, if it is listed:
+    bool removed = validCandidates.Edit([&candidateID](CandidateTable& table) {
+      const Candidate* candidate = table.Find(candidateID);
+      if (candidate == nullptr) {
+        return false;
+      }
+      table.candidates.erase(table.candidates.begin() + (candidate - table.candidates.data()));
+      table.ids.erase(candidateID);
+      return true;
+    });
+
+    // Handle found or not found scenarios:
+    if (removed) {
+      // Remove the candidate's votes and provide success message:
+      votesSet.Remove(candidateID);
+      voteJournal.RecordRemoval(candidateID);
+      candidatesChanged = true;
+      Out() << "Candidate with ID: " << candidateID << " removed successfully!" << '\n';
+      return true;
+    } else {
+      // Handle not found scenario and prompt to continue:
+      Out() << "Candidate with ID: " << candidateID << " not found." << '\n';
+      SuggestCandidates(candidateID);
+      Out() << "Do you want to continue ?  n for back \n";
+      std::string characterChoice = "a character";
+         char result = GetValidChar(characterChoice);
+      if(result == 'n')
+      { 
+        return false;
+      }
+    }
+  }
+}
+
+
+  // Publishes a candidate table version with one candidate's details edited.
+  //
+  // Args:
+  //   candidateID: The candidate to edit.
+  //   edit: Applies the change to the candidate in a copy of the table; returns
+  //         false, with errorMessage set, to abandon it.
+  //
+  // Returns:
+  //   true if the edit was published, false if it was abandoned or the
+  //   candidate was removed in the meantime.
+  bool ElectionSystem::EditCandidate(const std::string& candidateID,
+                                     const std::function<bool(Candidate&, CandidateTable&)>& edit)
+  {
+      bool found = true;
+      bool edited = validCandidates.Edit([&](CandidateTable& table) {
+          Candidate* candidate = table.Find(candidateID);
+          found = candidate != nullptr;
+          return found && edit(*candidate, table);
+      });
+      if (!edited) {
+          Err() << (found ? errorMessage : "Candidate with ID: " + candidateID + " no longer exists.") << '\n';
+          return false;
+      }
+      candidatesChanged = true;
+      return true;
+  }
+
+
+  // Modifies a candidate's information in the candidate table.
+  //
+  // Returns:
+  //   true if a candidate was successfully modified, false if the user cancelled.
+  bool ElectionSystem::ModifyCandidate()
+  {
+      // Check for available candidates:
+      if (validCandidates.Current()->candidates.empty()) {
+        Err() << "No candidates available to modify.\n";
+        return false;;
+       }
+       // Display current candidate list for user reference:
+       Out() << "Candidate List \n";
+       PrintCandidateListing(1);
+       std::string candidateID;
+       bool candidateFound = false;;
+      // Repeatedly prompt for candidate ID until a valid one is entered or user cancels:
+       while (!candidateFound) {
+          std::string CandidateIdInput = "Candidate ID (only alphanumeric) ";
+          candidateID = GetValidString(CandidateIdInput);
+          if (HandleListingCommand(candidateID)) {
+            continue;
+          }
+          // Find candidate in the list:
+        if (validCandidates.Current()->Find(candidateID) != nullptr) {
+            candidateFound = true;  // Candidate found
+        } else {
+        Out() << "Candidate with ID: " << candidateID << " not found. Please enter a valid Candidate ID.\n";
+        SuggestCandidates(candidateID);
+        Out() << "Do you want to continue ?  n for back \n";
+        std::string characterChoice = "a character";
+        char result = GetValidChar(characterChoice);
+                if(result == 'n')
+                { 
+                    return false;  // Exit if user cancels
+                 }
+             }
+       }
+
+       // Candidate found, present modification options:
+       Out() << "Candidate found. Select the information to modify:\n";
+       Out() << "1. Name\n2. Party Symbol\n3. Region Code\n";
+       while(true)
+       {
+        
+        int choice {GetChoice()};
+        switch (choice) {
+        case 1: {
+            std::string newName;
+            //Getting New Candidate Name untill user cancels 
+            while(true)
+            { 
+                 std::string NewCandidateNameInput ="New Candidate Name (only alphabets)";
+                 newName = GetValidString(NewCandidateNameInput);
+                 if (ValidateCandidateName(newName) )
+                 {
+                    break;
+                 }
+                 else
+                 {
+                  Err() << errorMessage << '\n';
+                  Out() << "Do you want to continue ?  n for back \n";
+                  std::string characterChoice = "a character";
+                  char result = GetValidChar(characterChoice);
+                  if(result == 'n')
+                  { 
+                     return false; // Exit if user cancels
+                  }
+                 }
+            }
+            //Modify the Candidate Name 
+            if (EditCandidate(candidateID, [&newName](Candidate& candidate, CandidateTable&) {
+                    candidate.SetCandidateName(newName);
+                    return true;
+                })) {
+                Out() << "Candidate Name updated successfully!\n";
+            }
+            return true;
+        }
+        case 2: {
+            std::string newPartySymbol;
+            //Getting New Party Symbol untill user cancels
+            while(true)
+            { 
+                std::string NewPartySymbolInput = "New Party Symbol (only alphabets)";
+                newPartySymbol = GetValidString(NewPartySymbolInput);
+               if (ValidatePartySymbol(newPartySymbol) )
+               {
+                   
+                   break;
+               }
+               else
+                 {
+                  Out() << errorMessage << '\n';
+                  Out() << "Do you want to continue ?  n for back \n";
+                  std::string characterChoice = "a character";
+                  char result = GetValidChar(characterChoice);
+                  if(result == 'n')
+                  { 
+                     return false; // Exit if user cancels
+                  }
+                 }
+            }
+            //Modify the Party Symbol 
+            if (EditCandidate(candidateID, [&](Candidate& candidate, CandidateTable& table) {
+                    if (!ValidatePartySymbol(newPartySymbol, table)) {
+                        return false;
+                    }
+                    candidate.SetPartySymbol(newPartySymbol);
+                    table.symbols.insert(newPartySymbol);
+                    return true;
+                })) {
+                Out() << "Candidate Party Symbol updated successfully!\n";
+            }
+            return true;
+        }
+        case 3: {
+            //Getting New RegionCode untill user cancels
+            std::string newRegionCode;
+            while(true)
+            { 
+               std::string NewRegionIdInput = "New Region ID (only alphanumeric)";
+               newRegionCode = GetValidString(NewRegionIdInput);
+               if (ValidateRegionCode(newRegionCode) )
+               {
+                  break;
+               }
+               else
+                 {
+                  Out() << "Invalid Party Symbol \n";
+                  Out() << "Do you want to continue ?  n for back \n";
+                  std::string characterChoice = "a character";
+                  char result = GetValidChar(characterChoice);
+                  if(result == 'n')
+                  { 
+                     return false;  // Exit if user cancels
+                  }
+                 }
                 
+            }
+            //Modify the Region Code
+            if (EditCandidate(candidateID, [&newRegionCode](Candidate& candidate, CandidateTable&) {
+                    candidate.SetRegion(newRegionCode);
+                    return true;
+                })) {
+                Out() << "Candidate Region Code updated successfully!\n";
+            }
+           return true;
+        }
+        
+        default: {
+            Out() << "Invalid choice.\n";
+            Out() << "Do you want to continue ?  n for back \n";
+            std::string characterChoice = "a character";
+            char result = GetValidChar(characterChoice);
+            if(result == 'n')
+            { 
+            return false; // Exit if user cancels
+             }
+             }
+      }
+
+    }
+    return true;
+  }
+
+  // Adds a new voter to the validVoterList container.
+  //
+  // Returns:
+  //   true if a voter was successfully added, false if the user cancelled.
+  bool ElectionSystem::AddVoter()
+  {
+      EnsureVoterRoll();
+      // Variables for storing voter information:
+      std::string aadhar,status;
+      // Loops until a valid Aadhar number is entered or the user cancels:
+      while(true)
+      {
+        // Prompts the user to enter the Aadhar number:
+        Out() << "Enter Aadhar Number (max " << ActiveRules::kAadhar.maxLength << " characters, numeric): ";
+        std::getline(In(), aadhar);
+        // Handles potential input failures:
+        if (!In()) // if the previous extraction failed
+        {
+          if (In().eof()) // if the stream was closed
+          {
+             throw EndOfInput(); // end the session
+          }
+          // let's handle the failure
+          In().clear();                           // put us back in 'normal' operation mode
+          In().ignore(std::numeric_limits<std::streamsize>::max(), '\n'); // remove the bad input
+          Out() << "Oops, that input is invalid. Please try again.\n";
+        }
+        // Checks if the Aadhar number is valid:
+        if(IsValidAadhar(aadhar))
+        {
+          // Checks if the Aadhar number is already registered:
+          if(!VoterRegistered(aadhar))
+          {
+           RegisterAadhar(aadhar); // Adds the Aadhar to checkAadhar
+           break;
+          }
+          else
+          {
+           Out() << "Aadhar Already Exist \n";
+           Out() << "Do you want to continue ?  n for back \n";
+           std::string characterChoice = "a character";
+           char result = GetValidChar(characterChoice);
+           if(result == 'n')
+           { 
+            return false;  // Exits if the user doesn't want to continue
+           }
+          }
+        }
+        else
+        {
+          Out() << errorMessage << "\n";
+          Out() << "Do you want to continue ?  n for back \n";
+          std::string characterChoice = "a character";
+          char result = GetValidChar(characterChoice);
+          if(result == 'n')
+          { 
+           return false;  // Exits if the user doesn't want to continue
+          }
+        }
+      }   
+      // Creates a new Voter object with the entered Aadhar and default status:
+      Voter v(aadhar,(bool) 0);
+      InsertVoter(v); // Adds the voter to the validVoterList
+      voterRollChanged = true;
+      NoteVoterChange(aadhar, false);
+      Out() << "Voter added successfully!" << '\n';
+      return true;  // Indicates successful voter addition
+  }
+ 
+ // Modifies the information of an existing voter in the validVoterList.
+ //
+ // Returns:
+ //   true if a voter was successfully modified, false if the user cancelled.  
+ bool ElectionSystem::ModifyVoter()
+  {
+      EnsureVoterRoll();
+      if (voterStore.IsOpen()) {
+        return ModifyStoredVoter();
+      }
+     // Check for available voters:
+     if (validVoterList.empty()) {
+        Out() << "No voters available to modify." << '\n';
+        return false;;
+       }
+     // Display a numbered list of voters:
+     int count = 1;
+     for (const auto& voter : validVoterList) {
+      Out() << count << " Aadhar ID " << voter.GetAadharID() << " Status " << voter.GetVotingStatus() << '\n';
+      count++;
+      }
+      while(true)
+      {
+        int aadharIdChoice {GetChoice()};  // Prompt the user to select a voter by number:
+        if(aadharIdChoice >= 1&&aadharIdChoice < count)
+         {  
+            auto& voter = validVoterList[aadharIdChoice-1];
+             // Present modification options:
+            Out() << "1. Aadhar ID\n2. Voting Status\n";
+            int updateChoice {GetChoice()};
+            if(updateChoice == 1)
+            { 
+               std::string temp = voter.GetAadharID();
+               auto it = checkAadhar.find(temp);
+               checkAadhar.erase(it);
+               std::string aadhar,status;
+               while(true)
+               {
+                  Out() << "Enter New Aadhar Number (max " << ActiveRules::kAadhar.maxLength << " characters, numeric): ";
+                  std::getline(In(), aadhar);
+                   if (!In()) // if the previous extraction failed
+              {
+                if (In().eof()) // if the stream was closed
+                {
+                  throw EndOfInput(); // end the session
+               }
+              // let's handle the failure
+              In().clear();                           // put us back in 'normal' operation mode
+              In().ignore(std::numeric_limits<std::streamsize>::max(), '\n'); // remove the bad input
+              Out() << "Oops, that input is invalid. Please try again.\n";
+             }
+             if(IsValidAadhar(aadhar))
+             {
+                if(checkAadhar.find(aadhar) == checkAadhar.end())
+                {
+                  checkAadhar.insert(aadhar);
+                  voter.SetAadharID(aadhar);
+                  voterRollChanged = true;
+                  NoteVoterRemoval(temp);
+                  NoteVoterChange(aadhar, voter.GetVotingStatus());
+                  // Move the re-keyed voter to its sorted position:
+                  if (sortedRoll)
+                  {
+                    Voter moved = voter;
+                    EraseVoter(aadharIdChoice - 1);
+                    InsertVoter(moved);
+                  }
+                  Out() << "Aadhar ID updated successfully!\n";
+                  return true;
+                  
+                }
+                else
+                {
+                  Out() << "Aadhar Already Exist \n";
+                  Out() << "Do you want to continue ?  n for back \n";
+                  std::string characterChoice = "a character";
+                  char result = GetValidChar(characterChoice);
+                  if(result == 'n')
+                  { 
+                     return false;
+                  }
+                }
+            }
+            else
+            {
+              Out() << "Invalid Aadhar ID \n";
+              Out() << "Do you want to continue ?  n for back \n";
+              std::string characterChoice = "a character";
+              char result = GetValidChar(characterChoice);
+                  if(result == 'n')
+                  { 
+                     return false;
+                  }
+            }
+          }
+        }
+        else if(updateChoice == 2)
+        { 
+                std::string status;
+                do {
+                      Out() << "Enter voting status (0 or 1) :";
+                      std::getline(In(), status);
+                      if (!In()) // if the previous extraction failed
+  	              {
+   	                if (In().eof()) // if the stream was closed
+   	           	{
+   		           throw EndOfInput(); // end the session
+   		        }
+   	                // let's handle the failure
+                       In().clear();   // put us back in 'normal' operation mode
+                       In().ignore(std::numeric_limits<std::streamsize>::max(), '\n'); // remove the bad input
+         	       Out() << "Oops, that input is invalid. Please try again.\n";
+  	              }
+        } while (!IsValidStatus(status));
+        bool res = (status == "1" ? 1 : 0);
+        voter.SetVotingStatus(res); 
+        MarkVoterDirty(voter.GetAadharID(), res);
+        NoteVoterChange(voter.GetAadharID(), res);
+        Out() << "Voting Status updated successfully!\n";
+        return true;
+        }   
+         }
+         else
+         {
+           Out() << "Invalid Choice \n";
+           Out() << "Do you want to continue ?  n for back \n";
+           std::string characterChoice = "a character";
+           char result = GetValidChar(characterChoice);
+           if(result == 'n')
+           { 
+           return false;;
+           }
+         }
        }
-       std::string candidateID;
-       bool candidateFound = false;;
-      // Repeatedly prompt for candidate ID until a valid one is entered or user cancels:
-       while (!candidateFound) {
-          std::string CandidateIdInput = "Candidate ID (only alphanumeric) ";
-          candidateID = GetValidString(CandidateIdInput);
-          // Find candidate in the list:
-          auto it = std::find_if(validCandidateList.begin(), validCandidateList.end(), [candidateID](const Candidate& candidate) {
-            return candidate.GetCandidateID() == candidateID; });
+      return true; // Should not reach here, but compiler requires a return
+  }
 
-        if (it != validCandidateList.end()) {
-            candidateFound = true;  // Candidate found
-        } else {
-        std::cout << "Candidate with ID: " << candidateID << " not found. Please enter a valid Candidate ID.\n";
-        std::cout << "Do you want to continue ?  n for back \n";
+  // Modifies a voter of the out-of-core roll, picked by Aadhar ID since the
+  // roll is too large to list.
+  //
+  // Returns:
+  //   true if a voter was successfully modified, false if the user cancelled.
+  bool ElectionSystem::ModifyStoredVoter()
+  {
+    std::string aadhar;
+    bool status = false;
+    while (true)
+    {
+      Out() << "Enter Aadhar Number (max " << ActiveRules::kAadhar.maxLength << " characters, numeric): ";
+      std::getline(In(), aadhar);
+      if (!In()) // if the previous extraction failed
+      {
+        if (In().eof()) // if the stream was closed
+        {
+          throw EndOfInput(); // end the session
+        }
+        In().clear();
+        In().ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        Out() << "Oops, that input is invalid. Please try again.\n";
+      }
+      if (IsValidAadhar(aadhar) && voterStore.GetVotingStatus(aadhar, status))
+      {
+        break;
+      }
+      Out() << "Entered Aadhar ID Not Exisiting \n";
+      Out() << "Do you want to continue ?  n for back \n";
+      std::string characterChoice = "a character";
+      if (GetValidChar(characterChoice) == 'n')
+      {
+        return false;
+      }
+    }
+
+    Out() << "Aadhar ID " << aadhar << " Status " << status << '\n';
+    Out() << "1. Aadhar ID\n2. Voting Status\n";
+    int updateChoice {GetChoice()};
+    if (updateChoice == 1)
+    {
+      while (true)
+      {
+        std::string updated;
+        Out() << "Enter New Aadhar Number (max " << ActiveRules::kAadhar.maxLength << " characters, numeric): ";
+        std::getline(In(), updated);
+        if (!In()) // if the previous extraction failed
+        {
+          if (In().eof()) // if the stream was closed
+          {
+            throw EndOfInput(); // end the session
+          }
+          In().clear();
+          In().ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+          Out() << "Oops, that input is invalid. Please try again.\n";
+        }
+        if (IsValidAadhar(updated) && !voterStore.Contains(updated))
+        {
+          // Re-key the voter, keeping its voting status:
+          voterStore.Erase(aadhar);
+          voterStore.Insert(updated, status);
+          NoteVoterRemoval(aadhar);
+          NoteVoterChange(updated, status);
+          Out() << "Aadhar ID updated successfully!\n";
+          return true;
+        }
+        Out() << (IsValidAadhar(updated) ? "Aadhar Already Exist \n" : "Invalid Aadhar ID \n");
+        Out() << "Do you want to continue ?  n for back \n";
         std::string characterChoice = "a character";
-        char result = GetValidChar(characterChoice);
-                if(result == 'n')
-                { 
-                    return false;  // Exit if user cancels
-                 }
-             }
-       }
+        if (GetValidChar(characterChoice) == 'n')
+        {
+          return false;
+        }
+      }
+    }
+    else if (updateChoice == 2)
+    {
+      std::string entered;
+      do {
+        Out() << "Enter voting status (0 or 1) :";
+        std::getline(In(), entered);
+        if (!In()) // if the previous extraction failed
+        {
+          if (In().eof()) // if the stream was closed
+          {
+            throw EndOfInput(); // end the session
+          }
+          In().clear();
+          In().ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+          Out() << "Oops, that input is invalid. Please try again.\n";
+        }
+      } while (!IsValidStatus(entered));
+      voterStore.SetVotingStatus(aadhar, entered == "1");
+      NoteVoterChange(aadhar, entered == "1");
+      Out() << "Voting Status updated successfully!\n";
+      return true;
+    }
+    Out() << "Invalid Choice \n";
+    return false;
+  }
 
-       // Candidate found, present modification options:
-       std::cout << "Candidate found. Select the information to modify:\n";
-       std::cout << "1. Name\n2. Party Symbol\n3. Region Code\n";
-       while(true)
-       {
-        
-        int choice {GetChoice()};
-        switch (choice) {
-        case 1: {
-            std::string newName;
-            //Getting New Candidate Name untill user cancels 
-            while(true)
-            { 
-                 std::string NewCandidateNameInput ="New Candidate Name (only alphabets)";
-                 newName = GetValidString(NewCandidateNameInput);
-                 if (ValidateCandidateName(newName) )
-                 {
-                    break;
-                 }
-                 else
-                 {
-                  std::cerr << errorMessage << '\n';
-                  std::cout << "Do you want to continue ?  n for back \n";
+
+  // Removes a voter from the validVoterList and checkAadhar containers.
+  //
+  // Returns:
+  //   true if a voter was successfully removed, false if the user cancelled.
+  bool ElectionSystem::RemoveVoter()
+  {
+      EnsureVoterRoll();
+
+   // Check for available voters:
+   if (VoterCount() == 0) {
+        Out() << "No voters available to remove." << '\n';
+        return false;;
+    }
+    // Prompt the user to enter the Aadhar ID of the voter to remove:
+    std::string aadharID;
+     while(true)
+            {
+              Out() << "Enter Aadhar Number (max " << ActiveRules::kAadhar.maxLength << " characters, numeric): ";
+              std::getline(In(), aadharID);
+              if (!In()) // if the previous extraction failed
+              {
+                if (In().eof()) // if the stream was closed
+                {
+                  throw EndOfInput(); // end the session
+               }
+              // let's handle the failure
+              In().clear();                           // put us back in 'normal' operation mode
+              In().ignore(std::numeric_limits<std::streamsize>::max(), '\n'); // remove the bad input
+              Out() << "Oops, that input is invalid. Please try again.\n";
+             }
+             if(IsValidAadhar(aadharID))
+             {
+              break;
+             }
+             else
+             {
+              Out() << "Invalid Aadhar ID \n";
+              Out() << "Do you want to continue ?  n for back \n";
                   std::string characterChoice = "a character";
                   char result = GetValidChar(characterChoice);
                   if(result == 'n')
                   { 
-                     return false; // Exit if user cancels
-                  }
-                 }
+                     return false;
+                  }
+             }
+           }   
+        // Remove the voter from the out-of-core roll if found:
+        if (voterStore.IsOpen()) {
+            if (voterStore.Erase(aadharID)) {
+                NoteVoterRemoval(aadharID);
+                Out() << "Voter with Aadhar ID " << aadharID << " removed successfully!" << '\n';
+            } else {
+                Out() << "Voter with Aadhar ID " << aadharID << " not found." << '\n';
+            }
+            return true;
+        }
+        // Find the voter with the matching Aadhar ID:
+        long voterIndex = FindVoter(aadharID);
+        // Remove the voter if found:
+        if (voterIndex >= 0) {
+            auto it1 = checkAadhar.find(aadharID);
+            checkAadhar.erase(it1);   // Remove from Aadhar set
+            EraseVoter(voterIndex);  // Remove from voter list
+            voterRollChanged = true;
+            NoteVoterRemoval(aadharID);
+            Out() << "Voter with Aadhar ID " << aadharID << " removed successfully!" << '\n';
+        } else {
+            Out() << "Voter with Aadhar ID " << aadharID << " not found." << '\n';
+        }
+      return true;
+    }
+  
+// Casts a vote for the specified candidate and updates the voter's status.
+//
+// Returns:
+//   true if a vote was successfully cast, false if the user cancelled or an error occurred
+bool ElectionSystem::CastVote()
+{
+  EnsureVoterRoll();
+
+  // Display a list of candidates:
+  PrintCandidateListing(1);
+  
+  // Prompt the user to enter a valid candidate ID and Aadhar ID:
+   bool candidateFlag = false, aadharFlag = false;
+   std::string candidateID,aadhaarID;
+   
+   while(true)
+   {
+   
+   Out()<<"Enter Candidate ID :";
+   In()>> candidateID;
+   if (!In()) // if the previous extraction failed
+   {
+            if (In().eof()) // if the stream was closed
+            {
+                throw EndOfInput(); // end the session
+            }
+            // let's handle the failure
+            In().clear();                           // put us back in 'normal' operation mode
+            In().ignore(std::numeric_limits<std::streamsize>::max(), '\n'); // remove the bad input
+            Out() << "Oops, that input is invalid. Please try again.\n";
+   }
+   else
+   {
+    if (HandleListingCommand(candidateID))
+    {
+      continue;
+    }
+    std::shared_ptr<const CandidateTable> table = validCandidates.Current();
+    if(table->ids.find(candidateID) == table->ids.end())
+    {
+      Out() << "Entered Candidate ID Not Exisiting \n";
+      SuggestCandidates(candidateID);
+      Out() << "Do you want to continue ?  n for back \n";
+     std::string characterChoice = "a character";
+     char result = GetValidChar(characterChoice);
+     if(result == 'n')
+     { 
+      return false;;
+      }           
+    }
+    else
+    {
+      candidateFlag = true;
+      break;
+    }
+   }
+  }
+  
+  while(true)
+   {
+   
+   Out()<<"Enter Aadhar ID :";
+   In()>> aadhaarID;;
+   if (!In()) // if the previous extraction failed
+   {
+            if (In().eof()) // if the stream was closed
+            {
+                throw EndOfInput(); // end the session
+            }
+            // let's handle the failure
+            In().clear();                           // put us back in 'normal' operation mode
+            In().ignore(std::numeric_limits<std::streamsize>::max(), '\n'); // remove the bad input
+            Out() << "Oops, that input is invalid. Please try again.\n";
+   }
+   else
+   {
+    if(!VoterRegistered(aadhaarID))
+    {
+      Out() << "Entered Aadhar ID Not Exisiting \n"; 
+      Out() << "Do you want to continue ?  n for back \n";
+      std::string characterChoice = "a character";
+         char result = GetValidChar(characterChoice);
+      if(result == 'n')
+      { 
+        return false;;
+      }
+    }
+    else
+    {
+      aadharFlag = true;
+      break;
+    }
+   }
+  }
+
+  // Look the voter up, on disk for an out-of-core roll:
+  long voterIndex = -1;
+  bool currentStatus = true;
+  if (voterStore.IsOpen())
+  {
+    bool voted = true;
+    currentStatus = !voterStore.GetVotingStatus(aadhaarID, voted) || voted;
+  }
+  else
+  {
+    voterIndex = FindVoter(aadhaarID);
+    currentStatus = voterIndex < 0 || validVoterList[voterIndex].GetVotingStatus();
+  }
+  // Check if the voter has already voted:
+  if(!currentStatus)
+  {
+   // Find the selected candidate and increment their vote count:
+   if(aadharFlag &&  candidateFlag)
+   {
+     // Ranked contests ask for the further preferences:
+     std::vector<std::string> ranking{candidateID};
+     if (countMethod != CountMethod::kPlurality && !ReadLaterPreferences(ranking))
+     {
+       return false;
+     }
+     // The candidate may have been removed by an admin edit since it was entered:
+     std::shared_ptr<const CandidateTable> table = validCandidates.Current();
+     const Candidate* candidate = table->Find(candidateID);
+     if (candidate != nullptr) {
+         // Keep the ballot for the ranked count:
+         if (countMethod != CountMethod::kPlurality)
+         {
+           ballots.Add(ranking);
+         }
+         // Increment the vote count for the selected candidate
+         int64_t votes = votesSet.Add(candidateID);
+         voteJournal.RecordVote(candidateID);
+         turnout.Record(candidateID, candidate->GetRegion(),
+                        TurnoutSeries::MinuteOf(std::chrono::system_clock::now()));
+         dirtyCandidates.insert(candidateID);
+         // Mark the voter as having voted:
+         if (voterStore.IsOpen())
+         {
+           voterStore.SetVotingStatus(aadhaarID, true);
+         }
+         else
+         {
+           validVoterList[voterIndex].SetVotingStatus(true);
+           MarkVoterDirty(aadhaarID, true);
+         }
+         NoteVote(aadhaarID, candidateID, votes);
+         Out() << "Vote cast successfully for Candidate ID: " << candidateID << '\n';
+     }
+   }
+  }
+  else
+  {
+    Out() << "Voter Already Voted \n";
+  }
+      return true;
+    }
+  
+  // Displays the vote count for a specific candidate.
+  //
+  // Returns:
+  //   true if the result was displayed successfully, false if the user cancelled or an error occurred.
+  bool ElectionSystem::IndividualResult()
+  {
+   std::string candidateID;
+   // Get the candidate ID from the user:
+   while(true)
+   {
+   
+   Out()<<"Enter Candidate ID : ";
+   In()>> candidateID;
+   if (!In()) // if the previous extraction failed
+   {
+            if (In().eof()) // if the stream was closed
+            {
+                throw EndOfInput(); // end the session
+            }
+            // let's handle the failure
+            In().clear();                           // put us back in 'normal' operation mode
+            In().ignore(std::numeric_limits<std::streamsize>::max(), '\n'); // remove the bad input
+            Out() << "Oops, that input is invalid. Please try again.\n";
+   }
+   else
+   {
+    if (HandleListingCommand(candidateID))
+    {
+      continue;
+    }
+    std::shared_ptr<const CandidateTable> table = validCandidates.Current();
+    if(table->ids.find(candidateID) == table->ids.end())
+    {
+      Out() << "Enter Candidate ID Not Exisiting \n"; 
+      SuggestCandidates(candidateID);
+      Out() << "Do you want to continue ?  n for back \n";
+         std::string characterChoice = "a character";
+         char result = GetValidChar(characterChoice);
+                  if(result == 'n')
+                  { 
+                     return false;;
+                  }          
+    }
+    else
+    {
+      break;
+    }
+   }
+  }
+  // Display the vote count for the candidate:
+  Out() << "Candidate ID: " << candidateID << ", Vote Count: " << votesSet.Get(candidateID) << '\n';
+  Out() << "Votes in the last hour: "
+        << turnout.Recent(TurnoutSeries::Scope::kCandidate, candidateID, 60,
+                          TurnoutSeries::MinuteOf(std::chrono::system_clock::now()))
+        << '\n';
+  
+      return true;
+    }
+  
+
+  // Displays the overall election results in descending order of vote count.
+  //
+  // Returns:
+  //   true if the results were displayed successfully
+  bool ElectionSystem::ShowResult()
+  {
+      // Take all counts at one instant, so they add up to the turnout:
+      TallySnapshot snapshot = votesSet.Snapshot();
+      std::vector<std::pair<std::string, int64_t>> sortedVotes(std::move(snapshot.counts));
+
+      // Sort the vector based on values (second element of the pair)
+      std::sort(sortedVotes.begin(), sortedVotes.end(), [](const auto& a, const auto& b) {
+        return a.second > b.second; // descending order
+      });
+
+     // Print the sorted vector
+    for (const auto& pair : sortedVotes) {
+        Out() << pair.first << " has " << pair.second << " votes \n";
+       } 
+    Out() << "Total votes: " << snapshot.turnout << '\n';
+    ShowTurnout(snapshot.turnout);
+
+    // The counts above are first preferences in a ranked contest:
+    if (countMethod != CountMethod::kPlurality) {
+        ShowRankedResult();
+    }
+      return true;
+    }
+
+  // Runs the ranked count over all ballots and prints each round.
+  void ElectionSystem::ShowRankedResult()
+  {
+    std::vector<std::string> standing;
+    for (const Candidate& candidate : validCandidates.Current()->candidates) {
+        standing.push_back(candidate.GetCandidateID());
+    }
+    CountResult count = CountRankedBallots(ballots, standing, countMethod, countSeats);
+
+    if (countMethod == CountMethod::kSingleTransferable) {
+        Out() << "Single transferable vote count of " << ballots.Size() << " ballots for " << countSeats
+              << " seats, quota " << FormatVoteValue(count.quota) << '\n';
+    } else {
+        Out() << "Instant runoff count of " << ballots.Size() << " ballots\n";
+    }
+    for (size_t i = 0; i < count.rounds.size(); i++) {
+        const CountRound& round = count.rounds[i];
+        Out() << "Round " << i + 1 << ":";
+        for (const auto& tally : round.tallies) {
+            Out() << " " << tally.first << " " << FormatVoteValue(tally.second);
+        }
+        Out() << ", exhausted " << FormatVoteValue(round.exhausted) << '\n';
+        for (const std::string& id : round.elected) {
+            Out() << "  " << id << " elected\n";
+        }
+        if (!round.excluded.empty()) {
+            Out() << "  " << round.excluded << " excluded\n";
+        }
+    }
+    Out() << (count.winners.size() == 1 ? "Winner:" : "Winners:");
+    for (const std::string& id : count.winners) {
+        Out() << " " << id;
+    }
+    Out() << '\n';
+  }
+
+  // Prints the votes cast in the last minutes, overall and per region, and
+  // the turnout curve of the last hour.
+  //
+  // Args:
+  //   turnoutTotal: The turnout the curve ends at.
+  void ElectionSystem::ShowTurnout(int64_t turnoutTotal)
+  {
+    using Scope = TurnoutSeries::Scope;
+    int64_t now = TurnoutSeries::MinuteOf(std::chrono::system_clock::now());
+    Out() << "Votes in the last 5, 15 and 60 minutes: " << turnout.Recent(Scope::kAll, "", 5, now) << ", "
+          << turnout.Recent(Scope::kAll, "", 15, now) << ", " << turnout.Recent(Scope::kAll, "", 60, now) << '\n';
+    for (const std::string& region : turnout.Keys(Scope::kRegion)) {
+        Out() << "  Region " << region << ": " << turnout.Recent(Scope::kRegion, region, 60, now)
+              << " in the last hour\n";
+    }
+
+    // Anchor the curve of the last hour at the current turnout:
+    std::vector<int64_t> curve = turnout.Curve(Scope::kAll, "", 60, now);
+    int64_t start = turnoutTotal - curve.back();
+    Out() << "Turnout curve:";
+    for (size_t i = 9; i < curve.size(); i += 10) {
+        Out() << " " << (i + 1 == curve.size() ? std::string("now") : "-" + std::to_string(59 - i) + "m")
+              << " " << start + curve[i];
+    }
+    Out() << '\n';
+  }
+
+  // Asks a voter for their preferences after their first choice.
+  //
+  // Args:
+  //   ranking: Holds the first choice; receives the further preferences.
+  //
+  // Returns:
+  //   true if the ballot is complete, false if the voter cancelled.
+  bool ElectionSystem::ReadLaterPreferences(std::vector<std::string>& ranking)
+  {
+    // Drop the rest of the Aadhar ID line before reading whole lines:
+    In().ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    while (true) {
+        Out() << "Enter further preferences as Candidate IDs in order, separated by commas (empty for none): ";
+        std::string line;
+        std::getline(In(), line);
+        if (!In()) {
+            if (In().eof()) {
+                throw EndOfInput();
             }
-            //Modify the Candidate Name 
-            for (auto& candidate : validCandidateList) {
-                if (candidate.GetCandidateID() == candidateID) {
-                    candidate.SetCandidateName(newName);
-                    std::cout << "Candidate Name updated successfully!\n";
-                    break;
-                }
+            In().clear();
+            continue;
+        }
+
+        std::vector<std::string> complete(ranking.begin(), ranking.begin() + 1);
+        std::shared_ptr<const CandidateTable> table = validCandidates.Current();
+        CsvFields fields(line);
+        std::string_view field;
+        std::string invalid;
+        while (invalid.empty() && fields.Next(field)) {
+            std::string id = TrimField(std::string(field));
+            if (id.empty()) {
+                continue;
+            }
+            if (table->Find(id) == nullptr || std::find(complete.begin(), complete.end(), id) != complete.end()) {
+                invalid = id;
             }
+            complete.push_back(id);
+        }
+        if (invalid.empty()) {
+            ranking.swap(complete);
             return true;
         }
-        case 2: {
-            std::string newPartySymbol;
-            //Getting New Party Symbol untill user cancels
-            while(true)
-            { 
-                std::string NewPartySymbolInput = "New Party Symbol (only alphabets)";
-                newPartySymbol = GetValidString(NewPartySymbolInput);
-               if (ValidatePartySymbol(newPartySymbol) )
+
+        Out() << "Invalid or repeated preference " << invalid << '\n';
+        Out() << "Do you want to continue ?  n for back \n";
+        std::string characterChoice = "a character";
+        if (GetValidChar(characterChoice) == 'n') {
+            return false;
+        }
+    }
+  }
+
+  // Attempts to fill missing or correct invalid voter information.
+  //
+  // Returns:
+  //   true if the information was updated successfully, false if the user cancelled or an error occurred. 
+  bool ElectionSystem::FillMissingVoterInfo()
+  { 
+      EnsureVoterRoll();
+
+      if(invalidVoters.Empty())
+      { 
+         Out() << "There is no Invalid data \n";
+         return true; 
+      }
+      Out() << "Fill missing data or update invalid data \n";
+      PrintInvalidVoters(0, 1);
+      while(true)
+      {
+        // Let the operator page through the records or repair them in bulk:
+        size_t recordID = 0;
+        if (!PickInvalidRecord(invalidVoters, recordID,
+                               [this](unsigned problem, size_t page) { PrintInvalidVoters(problem, page); },
+                               [this]() { return AutoRepairVoters(); }))
+        {
+          return false;
+        }
+         {  
+            auto pair = *invalidVoters.Find(recordID);
+            std::string aadhar = pair.first;
+            std::string status = pair.second;
+            bool flag1 = false, flag2 = false;;
+            if(IsValidAadhar(aadhar) && !VoterRegistered(aadhar))
+            {
+                  flag1 = true;
+                  RegisterAadhar(aadhar);
+            }
+            else
+            {
+              while(true)
                {
-                   
-                   break;
-               }
-               else
-                 {
-                  std::cout << errorMessage << '\n';
-                  std::cout << "Do you want to continue ?  n for back \n";
+                  Out() << "Enter New Aadhar Number (max " << ActiveRules::kAadhar.maxLength << " characters, numeric): ";
+                  std::getline(In(), aadhar);
+                   if (!In()) // if the previous extraction failed
+                   {
+                      if (In().eof()) // if the stream was closed
+                      {
+                          throw EndOfInput(); // end the session
+                       }
+                     // let's handle the failure
+                      In().clear();                           // put us back in 'normal' operation mode
+                      In().ignore(std::numeric_limits<std::streamsize>::max(), '\n'); // remove the bad input
+                       Out() << "Oops, that input is invalid. Please try again.\n";
+                   }
+                   if(IsValidAadhar(aadhar))
+                   {
+                     if(!VoterRegistered(aadhar))
+                     {
+                        RegisterAadhar(aadhar);
+                        flag1 =true;
+                        break;
+                     }
+                     else
+                     {
+                        Out() << "Aadhar Already Exist \n";
+                        Out() << "Do you want to continue ?  n for back \n";
+                         std::string characterChoice = "a character";
+                         char result = GetValidChar(characterChoice);
+                         if(result == 'n')
+                          { 
+                             return false;;
+                          }
+                     }
+                   }
+                   else
+                   {
+                     Out() << "Invalid Aadhar ID \n";
+                     Out() << "Do you want to continue ?  n for back \n";
                   std::string characterChoice = "a character";
                   char result = GetValidChar(characterChoice);
                   if(result == 'n')
                   { 
-                     return false; // Exit if user cancels
+                     return false;
+                  }
+                  
                   }
                  }
-            }
-            //Modify the Party Symbol 
-            for (auto& candidate : validCandidateList) {
-                if (candidate.GetCandidateID() == candidateID) {
-                    candidate.SetPartySymbol(newPartySymbol);
-                    symbolSet.insert(newPartySymbol);
-                    std::cout << "Candidate Party Symbol updated successfully!\n";
-                    break;
-                }
-            }
-            return true;
-        }
-        case 3: {
-            //Getting New RegionCode untill user cancels
-            std::string newRegionCode;
-            while(true)
-            { 
-               std::string NewRegionIdInput = "New Region ID (only alphanumeric)";
-               newRegionCode = GetValidString(NewRegionIdInput);
-               if (ValidateRegionCode(newRegionCode) )
+             }
+             
+             if(IsValidStatus(status))
+             {
+                flag2 = true;
+             }
+             else
+             {
+              
+               while(true)
                {
-                  break;
-               }
-               else
-                 {
-                  std::cout << "Invalid Party Symbol \n";
-                  std::cout << "Do you want to continue ?  n for back \n";
+                   Out() << "Enter voting status (0 or 1):";
+                   std::getline(In(), status);
+                   if (!In()) // if the previous extraction failed
+  	           {
+   	            if (In().eof()) // if the stream was closed
+   		    {
+   		       throw EndOfInput(); // end the session
+   		     }
+   	             // let's handle the failure
+                     In().clear();   // put us back in 'normal' operation mode
+                     In().ignore(std::numeric_limits<std::streamsize>::max(), '\n'); // remove the bad input
+         	     Out() << "Oops, that input is invalid. Please try again.\n";
+  	           }
+  	           if(IsValidStatus(status))
+  	           {
+  	                flag2 = true;
+  	                break;
+   	           }
+   	           else
+   	           {
+   	             Out() << "Invalid Status \n";
+   	             Out() << "Do you want to continue ?  n for back \n";
                   std::string characterChoice = "a character";
-                  char result = GetValidChar(characterChoice);
+         char result = GetValidChar(characterChoice);
                   if(result == 'n')
                   { 
-                     return false;  // Exit if user cancels
+                     return false;;
                   }
-                 }
-                
-            }
-            //Modify the Region Code
-            for (auto& candidate : validCandidateList) {
-                if (candidate.GetCandidateID() == candidateID) {
-                    candidate.SetRegion(newRegionCode);
-                    std::cout << "Candidate Region Code updated successfully!\n";
-                    break;
-                }
+                  
+                  }
+  	      }
+  	      
+  	    }
+               
+          
+            if(flag1 && flag2)
+            {  
+               bool res = (status == "1" ? 1 : 0); 
+               Voter v(aadhar,(bool) res);
+               InsertVoter(v);
+               voterRollChanged = true;
+               NoteVoterChange(aadhar, res);
+               invalidVoters.Remove(recordID);
+               Out() << "Voter Information Updated Successfully \n";
+               return true;
             }
-           return true;
-        }
-        
-        default: {
-            std::cout << "Invalid choice.\n";
-            std::cout << "Do you want to continue ?  n for back \n";
-            std::string characterChoice = "a character";
-            char result = GetValidChar(characterChoice);
-            if(result == 'n')
-            { 
-            return false; // Exit if user cancels
-             }
-             }
+
+            
+         }
+         
       }
+      
+      return true;
+    }
+
+  // Finds every problem of a voter row.
+  //
+  // Args:
+  //   aadhar: The Aadhar ID as read.
+  //   status: The voting status as read.
+  //
+  // Returns:
+  //   The RecordProblem bits the row fails on.
+  unsigned ElectionSystem::VoterProblems(const std::string& aadhar, const std::string& status)
+  {
+    unsigned problems = 0;
+    if (aadhar.empty() || status.empty())
+    {
+      problems |= kMissingField;
+    }
+    if (!IsAadharFormat(aadhar))
+    {
+      problems |= kBadAadhar;
+    }
+    else if (VoterRegistered(aadhar))
+    {
+      problems |= kDuplicateAadhar;
+    }
+    if (!IsStatusFormat(status))
+    {
+      problems |= kBadStatus;
+    }
+    return problems;
+  }
+
+  // Stores a voter row that failed validation for the repair workflow.
+  void ElectionSystem::AddInvalidVoter(const std::string& aadhar, const std::string& status)
+  {
+    invalidVoters.Add(std::make_pair(aadhar, status), VoterProblems(aadhar, status));
+  }
 
+  // Prints a page of the invalid voters, with the count of each problem.
+  //
+  // Args:
+  //   problem: A single problem bit to list, or 0 for all records.
+  //   page: The 1-based page to print.
+  void ElectionSystem::PrintInvalidVoters(unsigned problem, size_t page)
+  {
+    size_t count = invalidVoters.FilteredSize(problem);
+    size_t pages = std::max<size_t>((count + kRepairPageSize - 1) / kRepairPageSize, 1);
+    page = std::min(std::max<size_t>(page, 1), pages);
+    Out() << invalidVoters.Size() << " invalid voters (" << invalidVoters.Summary() << ")\n";
+    for (size_t id : invalidVoters.Page(problem, page, kRepairPageSize))
+    {
+      const auto& pair = *invalidVoters.Find(id);
+      Out() << id + 1 << " Aadhar ID " << pair.first << " Status " << pair.second << '\n';
     }
-    return true;
+    Out() << "Page " << page << " of " << pages;
+    if (problem != 0)
+    {
+      Out() << " (" << RecordProblemName(problem) << ")";
+    }
+    Out() << ".\n";
   }
 
-  // Adds a new voter to the validVoterList container.
+  // Registers every invalid voter whose Aadhar ID only has separators or blanks
+  // in it and whose status is spelled out ("yes", "true", ...).
   //
   // Returns:
-  //   true if a voter was successfully added, false if the user cancelled.
-  bool ElectionSystem::AddVoter()
+  //   The number of voters repaired.
+  size_t ElectionSystem::AutoRepairVoters()
   {
-      // Variables for storing voter information:
-      std::string aadhar,status;
-      // Loops until a valid Aadhar number is entered or the user cancels:
-      while(true)
+    size_t repaired = 0;
+    for (size_t id : invalidVoters.IDs())
+    {
+      const auto& pair = *invalidVoters.Find(id);
+
+      // Drop digit group separators from the Aadhar ID:
+      std::string aadhar;
+      for (char c : pair.first)
       {
-        // Prompts the user to enter the Aadhar number:
-        std::cout << "Enter Aadhar Number (max 12 characters, numeric): ";
-        std::getline(std::cin, aadhar);
-        // Handles potential input failures:
-        if (!std::cin) // if the previous extraction failed
+        if (std::isdigit(static_cast<unsigned char>(c)))
         {
-          if (std::cin.eof()) // if the stream was closed
-          {
-             exit(0); // shut down the program now
-          }
-          // let's handle the failure
-          std::cin.clear();                           // put us back in 'normal' operation mode
-          std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n'); // remove the bad input
-          std::cout << "Oops, that input is invalid. Please try again.\n";
+          aadhar += c;
         }
-        // Checks if the Aadhar number is valid:
-        if(IsValidAadhar(aadhar))
+        else if (c != ' ' && c != '-' && c != '.' && c != '"' && c != '\r' && c != '\t')
         {
-          // Checks if the Aadhar number is already present in checkAadhar:
-          if(checkAadhar.find(aadhar) == checkAadhar.end())
-          {
-           checkAadhar.insert(aadhar); // Adds the Aadhar to checkAadhar
-           break;
-          }
-          else
-          {
-           std::cout << "Aadhar Already Exist \n";
-           std::cout << "Do you want to continue ?  n for back \n";
-           std::string characterChoice = "a character";
-           char result = GetValidChar(characterChoice);
-           if(result == 'n')
-           { 
-            return false;  // Exits if the user doesn't want to continue
-           }
-          }
+          aadhar.clear();
+          break;
+        }
+      }
+
+      // Map spelled out statuses to 0 or 1; a missing status is never guessed:
+      std::string status = TrimField(pair.second);
+      std::transform(status.begin(), status.end(), status.begin(), ::tolower);
+      if (status == "yes" || status == "y" || status == "true" || status == "voted")
+      {
+        status = "1";
+      }
+      else if (status == "no" || status == "n" || status == "false")
+      {
+        status = "0";
+      }
+
+      if (VoterProblems(aadhar, status) == 0)
+      {
+        RegisterAadhar(aadhar);
+        if (sortedRoll && !voterStore.IsOpen())
+        {
+          validVoterList.emplace_back(aadhar, status == "1");  // Sorted once below
         }
         else
         {
-          std::cout << errorMessage << "\n";
-          std::cout << "Do you want to continue ?  n for back \n";
-          std::string characterChoice = "a character";
-          char result = GetValidChar(characterChoice);
-          if(result == 'n')
-          { 
-           return false;  // Exits if the user doesn't want to continue
-          }
+          InsertVoter(Voter(aadhar, status == "1"));
         }
-      }   
-      // Creates a new Voter object with the entered Aadhar and default status:
-      Voter v(aadhar,(bool) 0);
-      validVoterList.push_back(v); // Adds the voter to the validVoterList
-      std::cout << "Voter added successfully!" << std::endl;
-      return true;  // Indicates successful voter addition
-  }
- 
- // Modifies the information of an existing voter in the validVoterList.
- //
- // Returns:
- //   true if a voter was successfully modified, false if the user cancelled.  
- bool ElectionSystem::ModifyVoter()
-  {
-     // Check for available voters:
-     if (validVoterList.empty()) {
-        std::cout << "No voters available to modify." << std::endl;
-        return false;;
-       }
-     // Display a numbered list of voters:
-     int count = 1;
-     for (const auto& voter : validVoterList) {
-      std::cout << count << " Aadhar ID " << voter.GetAadharID() << " Status " << voter.GetVotingStatus() << '\n';
-      count++;
+        NoteVoterChange(aadhar, status == "1");
+        invalidVoters.Remove(id);
+        repaired++;
       }
-      while(true)
+    }
+
+    if (repaired > 0)
+    {
+      if (sortedRoll && !voterStore.IsOpen())
       {
-        int aadharIdChoice {GetChoice()};  // Prompt the user to select a voter by number:
-        if(aadharIdChoice >= 1&&aadharIdChoice < count)
-         {  
-            auto& voter = validVoterList[aadharIdChoice-1];
-             // Present modification options:
-            std::cout << "1. Aadhar ID\n2. Voting Status\n";
-            int updateChoice {GetChoice()};
-            if(updateChoice == 1)
-            { 
-               std::string temp = voter.GetAadharID();
-               auto it = checkAadhar.find(temp);
-               checkAadhar.erase(it);
-               std::string aadhar,status;
-               while(true)
-               {
-                  std::cout << "Enter New Aadhar Number (max 12 characters, numeric): ";
-                  std::getline(std::cin, aadhar);
-                   if (!std::cin) // if the previous extraction failed
-              {
-                if (std::cin.eof()) // if the stream was closed
-                {
-                  exit(0); // shut down the program now
-               }
-              // let's handle the failure
-              std::cin.clear();                           // put us back in 'normal' operation mode
-              std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n'); // remove the bad input
-              std::cout << "Oops, that input is invalid. Please try again.\n";
-             }
-             if(IsValidAadhar(aadhar))
-             {
-                if(checkAadhar.find(aadhar) == checkAadhar.end())
-                {
-                  checkAadhar.insert(aadhar);
-                  voter.SetAadharID(aadhar);
-                  std::cout << "Aadhar ID updated successfully!\n";
-                  return true;
-                  
-                }
-                else
-                {
-                  std::cout << "Aadhar Already Exist \n";
-                  std::cout << "Do you want to continue ?  n for back \n";
-                  std::string characterChoice = "a character";
-                  char result = GetValidChar(characterChoice);
-                  if(result == 'n')
-                  { 
-                     return false;
-                  }
-                }
-            }
-            else
-            {
-              std::cout << "Invalid Aadhar ID \n";
-              std::cout << "Do you want to continue ?  n for back \n";
-              std::string characterChoice = "a character";
-              char result = GetValidChar(characterChoice);
-                  if(result == 'n')
-                  { 
-                     return false;
-                  }
+        SortVoterRoll();
+      }
+      voterRollChanged = true;
+    }
+    return repaired;
+  }
+
+  // Writes the valid voter data to a CSV file, or only the changed rows to the
+  // voter delta file when the roll itself is unchanged.
+  void ElectionSystem::WriteVoterDataToCSV() {
+    // The out-of-core roll writes back its pages and merges added and removed voters:
+    if (voterStore.IsOpen()) {
+        if (!voterStore.Close()) {
+            std::cerr << "Error writing the voter file.\n";
+            return;
+        }
+
+        // The roll now includes every delta row:
+        std::remove(DataPath("Voter.delta").c_str());
+        return;
+    }
+
+    // Nothing changed in this session:
+    if (!voterRollChanged && dirtyVoters.empty()) {
+        return;
+    }
+
+    // Only voting statuses changed, append them to the delta file:
+    if (deltaPersistence && !voterRollChanged) {
+        AppendVoterDelta();
+        return;
+    }
+
+    // Unmap the roll before it is truncated:
+    voterFile.Close();
+
+    // Write the voter data as sorted fixed-width records:
+    if (!VoterRecordFile::Write(DataPath("Voter.csv"), validVoterList)) {
+        std::cerr << "Error opening the output voter file.\n";
+        return ;
+    }
+
+    // The full roll now includes every delta row:
+    std::remove(DataPath("Voter.delta").c_str());
+    dirtyVoters.clear();
+   }
+
+
+  // Appends the dirty voter rows to the voter delta file.
+  void ElectionSystem::AppendVoterDelta() {
+    std::ofstream deltaFile(DataPath("Voter.delta"), std::ios::app);
+    if (!deltaFile.is_open()) {
+        std::cerr << "Error opening the voter delta file.\n";
+        return;
+    }
+
+    for (const auto& entry : dirtyVoters) {
+        deltaFile << entry.first << "," << entry.second << "\n";
+    }
+
+    deltaFile.close();
+    dirtyVoters.clear();
+  }
+
+
+   // Writes the valid candidate data to a CSV file, or only the changed vote
+   // counts to the candidate delta file when no candidate was added, removed
+   // or edited.
+   void ElectionSystem::WriteCandidateDataToCSV() {
+    // Nothing changed in this session:
+    if (!candidatesChanged && dirtyCandidates.empty()) {
+        return;
+    }
+
+    // Only vote counts changed, append them to the delta file:
+    if (deltaPersistence && !candidatesChanged) {
+        AppendCandidateDelta();
+        return;
+    }
+
+    if (!WriteCandidateFile(DataPath("Candidate.csv"))) {
+        std::cerr << "Error writing the output candidate file.\n";
+        return;
+    }
+
+    // The full file now includes every delta row:
+    std::remove(DataPath("Candidate.delta").c_str());
+    dirtyCandidates.clear();
+   }
+
+
+  // Appends the vote counts of the dirty candidates to the candidate delta file.
+  void ElectionSystem::AppendCandidateDelta() {
+    std::ofstream deltaFile(DataPath("Candidate.delta"), std::ios::app);
+    if (!deltaFile.is_open()) {
+        std::cerr << "Error opening the candidate delta file.\n";
+        return;
+    }
+
+    for (const std::string& id : dirtyCandidates) {
+        deltaFile << id << "," << votesSet.Get(id) << "\n";
+    }
+
+    deltaFile.close();
+    dirtyCandidates.clear();
+  }
+
+   // Writes the election results to a CSV file, if any candidate or vote count
+   // changed. The standings are sorted by votes, so one vote can move a row
+   // anywhere and the file is always written whole; it has one short row per
+   // candidate, whatever the size of the roll.
+   void ElectionSystem::WriteResultDataToCSV() {
+    if (!candidatesChanged && dirtyCandidates.empty()) {
+        return;
+    }
+
+    if (!WriteResultFile(DataPath("result.csv"))) {
+        std::cerr << "Error writing the result file.\n";
+    }
+  }
+
+  // Writes the candidates, with the counts from the tally, beside a file and
+  // renames them into place.
+  //
+  // Returns:
+  //   true if the file was replaced, false otherwise.
+  bool ElectionSystem::WriteCandidateFile(const std::string& path) {
+    std::string temporary = path + ".tmp";
+    std::ofstream outputFile(temporary);
+    if (!outputFile.is_open()) {
+        return false;
+    }
+
+    // Write the candidate data, with the counts from the tally:
+    TallySnapshot votes = votesSet.Snapshot();
+    for (const auto& candidate : validCandidates.Current()->candidates) {
+        outputFile << candidate.GetCandidateID() << ","
+                   << candidate.GetCandidateName() << ","
+                   << candidate.GetPartySymbol() << ","
+                   << candidate.GetRegion() << "," 
+                   << votes.Find(candidate.GetCandidateID()) << "\n";
+    }
+
+    outputFile.close();
+    return outputFile && std::rename(temporary.c_str(), path.c_str()) == 0;
+  }
+
+  // Writes the results, most votes first, beside a file and renames them into
+  // place.
+  //
+  // Returns:
+  //   true if the file was replaced, false otherwise.
+  bool ElectionSystem::WriteResultFile(const std::string& path) {
+    std::string temporary = path + ".tmp";
+    std::ofstream outputFile(temporary);
+    if (!outputFile.is_open()) {
+        return false;
+    }
+    std::vector<std::pair<std::string, int64_t>> sortedVotes(votesSet.Snapshot().counts);
+
+      // Sort the vector based on values (second element of the pair)
+      std::sort(sortedVotes.begin(), sortedVotes.end(), [](const auto& a, const auto& b) {
+        return a.second > b.second; // descending order
+      });
+       
+    // Iterate through the map and write data to the CSV file
+    for (const auto& entry : sortedVotes) {
+        outputFile << entry.first << "," << entry.second << '\n';
+    }
+
+    outputFile.close();
+    return outputFile && std::rename(temporary.c_str(), path.c_str()) == 0;
+  }
+
+  // Configures a result feed that is rewritten periodically for downstream systems.
+  //
+  // Args:
+  //   path: The feed file.
+  //   format: The encoding of the feed.
+  //   grouping: How vote counts are grouped in the feed.
+  //   intervalSeconds: The minimum time between two feed refreshes.
+  void ElectionSystem::SetResultFeed(const std::string& path, ExportFormat format, ExportGrouping grouping,
+                                     double intervalSeconds)
+  {
+    resultFeedPath = path;
+    resultFeedFormat = format;
+    resultFeedGrouping = grouping;
+    resultFeedInterval = intervalSeconds;
+  }
+
+  // Rewrites the result feed if its refresh interval has passed.
+  //
+  // Args:
+  //   force: true to rewrite the feed regardless of the interval.
+  void ElectionSystem::RefreshResultFeed(bool force)
+  {
+    if (resultFeedPath.empty()) {
+        return;
+    }
+    auto now = std::chrono::steady_clock::now();
+    if (!force && now - resultFeedWritten < std::chrono::duration<double>(resultFeedInterval)) {
+        return;
+    }
+    ExportResultsTo(resultFeedPath, resultFeedFormat, resultFeedGrouping);
+    resultFeedWritten = now;
+  }
+
+  // Selects periodic background checkpoints of the whole election.
+  //
+  // Args:
+  //   seconds: The minimum time between two checkpoints, or 0 for none.
+  void ElectionSystem::SetCheckpointInterval(double seconds)
+  {
+    checkpointInterval = seconds;
+  }
+
+  // Reports a finished checkpoint, and starts a new one if the interval has
+  // passed and anything changed since the last one.
+  void ElectionSystem::CheckpointIfDue()
+  {
+    if (checkpointInterval <= 0) {
+        return;
+    }
+    ReapCheckpoint(false);
+    bool changed = candidatesChanged || !dirtyCandidates.empty() || voterRollChanged || !dirtyVoters.empty();
+    if (checkpointChild > 0 || !changed ||
+        std::chrono::steady_clock::now() - checkpointStarted < std::chrono::duration<double>(checkpointInterval)) {
+        return;
+    }
+
+    // A thread cannot be carried into the child, so wait for a background
+    // voter load to end before forking:
+    if (voterLoad.valid() &&
+        voterLoad.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        return;
+    }
+    StartCheckpoint();
+  }
+
+  // Forks a checkpoint child, setting the dirty state it covers aside.
+  void ElectionSystem::StartCheckpoint()
+  {
+    EnsureVoterRoll();
+
+    // The mapped and out-of-core rolls keep their own file up to date, and a
+    // rewrite would move Voter.csv from under them:
+    checkpointVoters = !voterFile.IsOpen() && !voterStore.IsOpen();
+
+    // The rows --watch diffs Candidate.csv against once the checkpoint is
+    // written:
+    checkpointCandidateRows.clear();
+    if (hotReload) {
+        TallySnapshot votes = votesSet.Snapshot();
+        for (const Candidate& candidate : validCandidates.Current()->candidates) {
+            checkpointCandidateRows.emplace_back(candidate.GetCandidateID(), candidate.GetCandidateName(),
+                                                 candidate.GetPartySymbol(), candidate.GetRegion(),
+                                                 votes.Find(candidate.GetCandidateID()));
+        }
+        std::sort(checkpointCandidateRows.begin(), checkpointCandidateRows.end(),
+                  [](const Candidate& a, const Candidate& b) { return a.GetCandidateID() < b.GetCandidateID(); });
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::cout.flush();
+    std::cerr.flush();
+
+    // The board and report threads read the tally and candidate table through
+    // locks the child would inherit held, so they wait out the fork:
+    resultsBoard.Pause();
+    tallyReporter.Pause();
+    int stamps[2] = {-1, -1};
+    if (hotReload && pipe(stamps) != 0) {
+        stamps[0] = stamps[1] = -1;
+    }
+    pid_t child = fork();
+    if (child != 0) {
+        tallyReporter.Resume();
+        resultsBoard.Resume();
+    }
+    if (child == 0) {
+        // The child holds a copy-on-write image of the election as of the
+        // fork. It must not run any destructor, which would save the session,
+        // nor keep the replica log locked if this process dies:
+        replicaLog.Close();
+        bool written = WriteCheckpoint();
+
+        // Tell the parent which files are its own, so --watch skips them:
+        if (written && stamps[1] >= 0) {
+            std::string report = "Candidate.csv," + FileStamp("Candidate.csv") + "\n";
+            if (checkpointVoters) {
+                report += "Voter.csv," + FileStamp("Voter.csv") + "\n";
             }
-          }
+            written = write(stamps[1], report.data(), report.size()) == static_cast<ssize_t>(report.size());
         }
-        else if(updateChoice == 2)
-        { 
-                std::string status;
-                do {
-                      std::cout << "Enter voting status (0 or 1) :";
-                      std::getline(std::cin, status);
-                      if (!std::cin) // if the previous extraction failed
-  	              {
-   	                if (std::cin.eof()) // if the stream was closed
-   	           	{
-   		           exit(0); // shut down the program now
-   		        }
-   	                // let's handle the failure
-                       std::cin.clear();   // put us back in 'normal' operation mode
-                       std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n'); // remove the bad input
-         	       std::cout << "Oops, that input is invalid. Please try again.\n";
-  	              }
-        } while (!IsValidStatus(status));
-        bool res = (status == "1" ? 1 : 0);
-        voter.SetVotingStatus(res); 
-        std::cout << "Voting Status updated successfully!\n";
-        return true;
-        }   
-         }
-         else
-         {
-           std::cout << "Invalid Choice \n";
-           std::cout << "Do you want to continue ?  n for back \n";
-           std::string characterChoice = "a character";
-           char result = GetValidChar(characterChoice);
-           if(result == 'n')
-           { 
-           return false;;
-           }
-         }
-       }
-      return true; // Should not reach here, but compiler requires a return
+        _exit(written ? 0 : 1);
+    }
+    if (stamps[1] >= 0) {
+        close(stamps[1]);
+    }
+    auto forked = std::chrono::steady_clock::now();
+    checkpointStarted = forked;
+    if (child < 0) {
+        Err() << "Error starting a checkpoint.\n";
+        if (stamps[0] >= 0) {
+            close(stamps[0]);
+        }
+        return;
+    }
+    checkpointChild = child;
+    checkpointStamps = stamps[0];
+    checkpointPauseMs = std::chrono::duration<double, std::milli>(forked - start).count();
+
+    // Changes from now on are not in the checkpoint:
+    checkpointCandidatesChanged = candidatesChanged;
+    checkpointDirtyCandidates.swap(dirtyCandidates);
+    candidatesChanged = false;
+    dirtyCandidates.clear();
+    if (checkpointVoters) {
+        checkpointRollChanged = voterRollChanged;
+        checkpointDirtyVoters.swap(dirtyVoters);
+        voterRollChanged = false;
+        dirtyVoters.clear();
+        checkpointVoterFileEdits.swap(voterFileEdits);
+        voterFileEdits.clear();
+    }
   }
-  
 
-  // Removes a voter from the validVoterList and checkAadhar containers.
+  // Writes the checkpoint files. Runs in the checkpoint child.
   //
   // Returns:
-  //   true if a voter was successfully removed, false if the user cancelled.
-  bool ElectionSystem::RemoveVoter()
+  //   true if every file was written, false otherwise.
+  bool ElectionSystem::WriteCheckpoint()
   {
+    if (!WriteCandidateFile(DataPath("Candidate.csv"))) {
+        return false;
+    }
 
-   // Check for available voters:
-   if (validVoterList.empty()) {
-        std::cout << "No voters available to remove." << std::endl;
-        return false;;
+    // The full file now includes every delta row, and the rows the parent
+    // appends after the fork hold later counts:
+    std::remove(DataPath("Candidate.delta").c_str());
+
+    bool written = WriteResultFile(DataPath("result.csv"));
+    if (written && checkpointVoters) {
+        std::string path = DataPath("Voter.csv");
+        std::string temporary = path + ".tmp";
+        written = VoterRecordFile::Write(temporary, validVoterList) && std::rename(temporary.c_str(), path.c_str()) == 0;
+
+        // The full roll now includes every delta row:
+        if (written) {
+            std::remove(DataPath("Voter.delta").c_str());
+        }
     }
-    // Prompt the user to enter the Aadhar ID of the voter to remove:
-    std::string aadharID;
-     while(true)
-            {
-              std::cout << "Enter Aadhar Number (max 12 characters, numeric): ";
-              std::getline(std::cin, aadharID);
-              if (!std::cin) // if the previous extraction failed
-              {
-                if (std::cin.eof()) // if the stream was closed
-                {
-                  exit(0); // shut down the program now
-               }
-              // let's handle the failure
-              std::cin.clear();                           // put us back in 'normal' operation mode
-              std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n'); // remove the bad input
-              std::cout << "Oops, that input is invalid. Please try again.\n";
-             }
-             if(IsValidAadhar(aadharID))
-             {
-              break;
-             }
-             else
-             {
-              std::cout << "Invalid Aadhar ID \n";
-              std::cout << "Do you want to continue ?  n for back \n";
-                  std::string characterChoice = "a character";
-                  char result = GetValidChar(characterChoice);
-                  if(result == 'n')
-                  { 
-                     return false;
-                  }
-             }
-           }   
-        // Find the voter with the matching Aadhar ID:
-        auto it = std::find_if(validVoterList.begin(), validVoterList.end(), [aadharID](Voter& voter) {
-            return voter.GetAadharID() == aadharID;
-        });
-        // Remove the voter if found:
-        if (it != validVoterList.end()) {
-            auto it1 = checkAadhar.find(aadharID);
-            checkAadhar.erase(it1);   // Remove from Aadhar set
-            validVoterList.erase(it);  // Remove from voter list
-            std::cout << "Voter with Aadhar ID " << aadharID << " removed successfully!" << std::endl;
-        } else {
-            std::cout << "Voter with Aadhar ID " << aadharID << " not found." << std::endl;
+    return written;
+  }
+
+  // Collects a finished checkpoint child and reports it.
+  //
+  // Args:
+  //   wait: true to wait for a running checkpoint to finish.
+  void ElectionSystem::ReapCheckpoint(bool wait)
+  {
+    if (checkpointChild <= 0) {
+        return;
+    }
+    int status = 0;
+    pid_t reaped = waitpid(checkpointChild, &status, wait ? 0 : WNOHANG);
+    if (reaped == 0) {
+        return;
+    }
+    checkpointChild = -1;
+
+    // The files the child wrote, by name:
+    std::map<std::string, std::string> written;
+    if (checkpointStamps >= 0) {
+        std::string report;
+        char buffer[512];
+        ssize_t length;
+        while ((length = read(checkpointStamps, buffer, sizeof(buffer))) > 0) {
+            report.append(buffer, length);
+        }
+        close(checkpointStamps);
+        checkpointStamps = -1;
+        std::istringstream lines(report);
+        std::string line;
+        while (std::getline(lines, line)) {
+            size_t comma = line.find(',');
+            if (comma != std::string::npos) {
+                written[line.substr(0, comma)] = line.substr(comma + 1);
+            }
         }
-      return true;
     }
-  
-// Casts a vote for the specified candidate and updates the voter's status.
-//
-// Returns:
-//   true if a vote was successfully cast, false if the user cancelled or an error occurred
-bool ElectionSystem::CastVote()
-{
-  // Display a list of candidates:
-  for(auto& candidate : validCandidateList)
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - checkpointStarted).count();
+    if (reaped > 0 && WIFEXITED(status) && WEXITSTATUS(status) == 0) {
+        Out() << "Checkpoint written " << seconds << " s after it started; voting paused "
+              << checkpointPauseMs << " ms for the fork\n";
+        checkpointDirtyCandidates.clear();
+        checkpointDirtyVoters.clear();
+
+        // The files now hold the election as of the fork:
+        if (written.count("Candidate.csv") != 0) {
+            candidateFileRows.swap(checkpointCandidateRows);
+            ownFileStamps["Candidate.csv"] = written["Candidate.csv"];
+        }
+        if (written.count("Voter.csv") != 0) {
+            ApplyVoterFileEdits(checkpointVoterFileEdits);
+            ownFileStamps["Voter.csv"] = written["Voter.csv"];
+        }
+        checkpointCandidateRows.clear();
+        checkpointVoterFileEdits.clear();
+        return;
+    }
+
+    // Nothing the checkpoint covered is saved yet; newer changes win:
+    Err() << "Checkpoint failed; its changes will be saved on exit.\n";
+    candidatesChanged = candidatesChanged || checkpointCandidatesChanged;
+    dirtyCandidates.insert(checkpointDirtyCandidates.begin(), checkpointDirtyCandidates.end());
+    checkpointDirtyCandidates.clear();
+    if (checkpointVoters) {
+        voterRollChanged = voterRollChanged || checkpointRollChanged;
+        dirtyVoters.insert(checkpointDirtyVoters.begin(), checkpointDirtyVoters.end());
+        checkpointDirtyVoters.clear();
+        voterFileEdits.insert(checkpointVoterFileEdits.begin(), checkpointVoterFileEdits.end());
+        checkpointVoterFileEdits.clear();
+    }
+    checkpointCandidateRows.clear();
+  }
+
+  // Selects logging every change to Replica.log for a warm standby.
+  void ElectionSystem::SetReplication(bool enabled)
   {
-    std::cout << "Candidate ID : " << candidate.GetCandidateID() << "  Candidate Name  : " << candidate.GetCandidateName() <<" Candidate Symbol : " << candidate.GetPartySymbol() << "   Candidate Region : " << candidate.GetRegion() << '\n';
+    replicate = enabled;
   }
-  
-  // Prompt the user to enter a valid candidate ID and Aadhar ID:
-   bool candidateFlag = false, aadharFlag = false;
-   std::string candidateID,aadhaarID;
-   
-   while(true)
-   {
-   
-   std::cout<<"Enter Candidate ID :";
-   std::cin>> candidateID;
-   if (!std::cin) // if the previous extraction failed
-   {
-            if (std::cin.eof()) // if the stream was closed
-            {
-                exit(0); // shut down the program now
-            }
-            // let's handle the failure
-            std::cin.clear();                           // put us back in 'normal' operation mode
-            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n'); // remove the bad input
-            std::cout << "Oops, that input is invalid. Please try again.\n";
-   }
-   else
-   {
-    auto it = idSet.find(candidateID);
-    if(it == idSet.end())
-    {
-      std::cout << "Entered Candidate ID Not Exisiting \n";
-      std::cout << "Do you want to continue ?  n for back \n";
-     std::string characterChoice = "a character";
-     char result = GetValidChar(characterChoice);
-     if(result == 'n')
-     { 
-      return false;;
-      }           
+
+  // Starts a new replica log, beginning with every candidate and tally.
+  //
+  // Returns:
+  //   true if the log is open or replication is off, false otherwise.
+  bool ElectionSystem::StartReplicaLog()
+  {
+    if (!replicate) {
+        return true;
     }
-    else
-    {
-      candidateFlag = true;
-      break;
+    if (!replicaLog.Open(DataPath("Replica.log"))) {
+        Err() << "Error starting the replica log.\n";
+        return false;
     }
-   }
+
+    // The standby may have read the files before startup repairs changed them:
+    replicatedTable = std::make_shared<const CandidateTable>();
+    replicatedTally = TallySnapshot();
+    ShipReplicaChanges();
+    return true;
   }
-  
-  while(true)
-   {
-   
-   std::cout<<"Enter Aadhar ID :";
-   std::cin>> aadhaarID;;
-   if (!std::cin) // if the previous extraction failed
-   {
-            if (std::cin.eof()) // if the stream was closed
-            {
-                exit(0); // shut down the program now
-            }
-            // let's handle the failure
-            std::cin.clear();                           // put us back in 'normal' operation mode
-            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n'); // remove the bad input
-            std::cout << "Oops, that input is invalid. Please try again.\n";
-   }
-   else
-   {
-    auto it = checkAadhar.find(aadhaarID);
-    if(it == checkAadhar.end())
-    {
-      std::cout << "Entered Aadhar ID Not Exisiting \n"; 
-      std::cout << "Do you want to continue ?  n for back \n";
-      std::string characterChoice = "a character";
-         char result = GetValidChar(characterChoice);
-      if(result == 'n')
-      { 
-        return false;;
-      }
+
+  // Selects reporting the tally to an aggregator.
+  //
+  // Args:
+  //   socketPath: The aggregator's socket.
+  //   node: The name this election reports under; the data directory if empty.
+  //   interval: The time between two reports.
+  void ElectionSystem::SetTallyReport(const std::string& socketPath, const std::string& node,
+                                      std::chrono::milliseconds interval)
+  {
+    tallyReportSocket = socketPath;
+    tallyReportNode = node.empty() ? dataDirectory : node;
+    tallyReportInterval = interval;
+  }
+
+  // Starts reporting the tally, if an aggregator was selected.
+  //
+  // Returns:
+  //   true if reporting started or no aggregator was selected, false otherwise.
+  bool ElectionSystem::StartTallyReport()
+  {
+    if (tallyReportSocket.empty()) {
+        return true;
     }
-    else
-    {
-      aadharFlag = true;
-      break;
+    if (tallyReportNode.find_first_of(",\n") != std::string::npos) {
+        Err() << "The node name " << tallyReportNode << " cannot hold a comma or a line break.\n";
+        return false;
     }
-   }
+    if (!tallyReporter.Start(tallyReportSocket, tallyReportNode, tallyReportInterval, votesSet, validCandidates)) {
+        Err() << "Error starting the tally report.\n";
+        return false;
+    }
+    return true;
   }
 
-  bool currentStatus;
-  for (auto& voter: validVoterList) {
-        if (voter.GetAadharID() == aadhaarID) {
-             currentStatus = voter.GetVotingStatus();
-          }
+  // Selects publishing the results on a shared memory board.
+  //
+  // Args:
+  //   name: The shared memory name of the board.
+  //   interval: The time between two checks for changes.
+  void ElectionSystem::SetResultsBoard(const std::string& name, std::chrono::milliseconds interval)
+  {
+    resultsBoardName = name;
+    resultsBoardInterval = interval;
+  }
+
+  // Starts publishing the results board, if one was selected.
+  //
+  // Returns:
+  //   true if the board was created or none was selected, false otherwise.
+  bool ElectionSystem::StartResultsBoard()
+  {
+    if (resultsBoardName.empty()) {
+        return true;
     }
-  // Check if the voter has already voted:
-  if(!currentStatus)
+    if (!resultsBoard.Start(resultsBoardName, resultsBoardInterval, votesSet, validCandidates)) {
+        Err() << "Error creating the results board " << resultsBoardName << ".\n";
+        return false;
+    }
+    return true;
+  }
+
+  // Logs the candidate and tally changes made since the last call.
+  void ElectionSystem::ShipReplicaChanges()
   {
-   // Find the selected candidate and increment their vote count:
-   if(aadharFlag &&  candidateFlag)
-   {
-     for (Candidate& candidate : validCandidateList) {
-         if (candidate.GetCandidateID() == candidateID) {
-             // Increment the vote count for the selected candidate
-             votesSet[candidate.GetCandidateID()]++;
-             candidate.SetVotes(votesSet[candidate.GetCandidateID()]);
-             // Mark the voter as having voted:
-             for (auto& voter:validVoterList) {
-        	if (voter.GetAadharID() == aadhaarID) {
-             	    voter.SetVotingStatus(true);
-             	    std::cout << "Vote cast successfully for Candidate ID: " << candidateID << '\n';
-             	    break;
-         	 }
-    	     }
-             break;
-         }
-     }
-   }
+    if (!replicaLog.IsOpen()) {
+        return;
+    }
+
+    // Candidates, when a new table version was published:
+    std::shared_ptr<const CandidateTable> table = validCandidates.Current();
+    if (table != replicatedTable) {
+        std::map<std::string, const Candidate*> shipped;
+        for (const Candidate& candidate : replicatedTable->candidates) {
+            shipped[candidate.GetCandidateID()] = &candidate;
+        }
+        for (const Candidate& candidate : table->candidates) {
+            auto it = shipped.find(candidate.GetCandidateID());
+            if (it == shipped.end() || it->second->GetCandidateName() != candidate.GetCandidateName() ||
+                it->second->GetPartySymbol() != candidate.GetPartySymbol() ||
+                it->second->GetRegion() != candidate.GetRegion()) {
+                replicaLog.RecordCandidate(candidate.GetCandidateID(), candidate.GetCandidateName(),
+                                           candidate.GetPartySymbol(), candidate.GetRegion());
+            }
+            if (it != shipped.end()) {
+                shipped.erase(it);
+            }
+        }
+        for (const auto& entry : shipped) {
+            replicaLog.RecordCandidateRemoval(entry.first);
+        }
+        replicatedTable = table;
+    }
+
+    // Tallies, by a sorted merge of the snapshots:
+    TallySnapshot tally = votesSet.Snapshot();
+    if (tally.epoch == replicatedTally.epoch && !replicatedTally.counts.empty()) {
+        return;
+    }
+    auto shipped = replicatedTally.counts.begin();
+    for (const auto& count : tally.counts) {
+        while (shipped != replicatedTally.counts.end() && shipped->first < count.first) {
+            shipped++;
+        }
+        if (shipped == replicatedTally.counts.end() || shipped->first != count.first ||
+            shipped->second != count.second) {
+            replicaLog.RecordTally(count.first, count.second);
+        }
+    }
+    replicatedTally = std::move(tally);
   }
-  else
+
+  // Log a voter's registration, change or removal for the standby.
+  void ElectionSystem::NoteVoterChange(const std::string& aadhar, bool status)
   {
-    std::cout << "Voter Already Voted \n";
+    replicaLog.RecordVoter(aadhar, status);
+    if (voterFileWatched && checkpointInterval > 0) {
+        voterFileEdits[PackAadhar(aadhar)] = status;
+    }
   }
-      return true;
+
+  void ElectionSystem::NoteVoterRemoval(const std::string& aadhar)
+  {
+    replicaLog.RecordVoterRemoval(aadhar);
+    if (voterFileWatched && checkpointInterval > 0) {
+        voterFileEdits[PackAadhar(aadhar)] = -1;
     }
-  
-  // Displays the vote count for a specific candidate.
+  }
+
+  // Log a cast vote: the voter and the candidate's new count in one record.
+  void ElectionSystem::NoteVote(const std::string& aadhar, const std::string& candidateID, int64_t votes)
+  {
+    replicaLog.RecordVote(aadhar, candidateID, votes);
+    if (voterFileWatched && checkpointInterval > 0) {
+        voterFileEdits[PackAadhar(aadhar)] = true;
+    }
+  }
+
+  // Applies a replica log record on the standby.
   //
   // Returns:
-  //   true if the result was displayed successfully, false if the user cancelled or an error occurred.
-  bool ElectionSystem::IndividualResult()
+  //   true if the record was applied, false if it is not a known record.
+  bool ElectionSystem::ApplyReplicaRecord(const ReplicaRecord& record)
   {
-   std::string candidateID;
-   // Get the candidate ID from the user:
-   while(true)
-   {
-   
-   std::cout<<"Enter Candidate ID : ";
-   std::cin>> candidateID;
-   if (!std::cin) // if the previous extraction failed
-   {
-            if (std::cin.eof()) // if the stream was closed
-            {
-                exit(0); // shut down the program now
+    const std::vector<std::string>& fields = record.fields;
+    if (record.type == "voter" && fields.size() == 2) {
+        bool status = fields[1] == "1";
+        long index = FindVoter(fields[0]);
+        if (index >= 0) {
+            validVoterList[index].SetVotingStatus(status);
+            MarkVoterDirty(fields[0], status);
+        } else {
+            RegisterAadhar(fields[0]);
+            InsertVoter(Voter(fields[0], status));
+            voterRollChanged = true;
+        }
+        return true;
+    }
+    if (record.type == "unvoter" && fields.size() == 1) {
+        long index = FindVoter(fields[0]);
+        if (index >= 0) {
+            checkAadhar.erase(fields[0]);
+            EraseVoter(index);
+            dirtyVoters.erase(fields[0]);
+            voterRollChanged = true;
+        }
+        return true;
+    }
+    if (record.type == "candidate" && fields.size() == 4) {
+        bool added = false;
+        validCandidates.Edit([&](CandidateTable& table) {
+            Candidate* candidate = table.Find(fields[0]);
+            added = candidate == nullptr;
+            if (added) {
+                table.candidates.emplace_back(fields[0], fields[1], fields[2], fields[3]);
+                table.ids.insert(fields[0]);
+            } else {
+                table.symbols.erase(candidate->GetPartySymbol());
+                candidate->SetCandidateName(fields[1]);
+                candidate->SetPartySymbol(fields[2]);
+                candidate->SetRegion(fields[3]);
             }
-            // let's handle the failure
-            std::cin.clear();                           // put us back in 'normal' operation mode
-            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n'); // remove the bad input
-            std::cout << "Oops, that input is invalid. Please try again.\n";
-   }
-   else
-   {
-    auto it = idSet.find(candidateID);
-    if(it == idSet.end())
-    {
-      std::cout << "Enter Candidate ID Not Exisiting \n"; 
-      std::cout << "Do you want to continue ?  n for back \n";
-         std::string characterChoice = "a character";
-         char result = GetValidChar(characterChoice);
-                  if(result == 'n')
-                  { 
-                     return false;;
-                  }          
+            table.symbols.insert(fields[2]);
+            return true;
+        });
+        if (added) {
+            votesSet.Add(fields[0], 0);
+        }
+        candidatesChanged = true;
+        return true;
     }
-    else
-    {
-      break;
+    if (record.type == "uncandidate" && fields.size() == 1) {
+        bool removed = validCandidates.Edit([&](CandidateTable& table) {
+            const Candidate* candidate = table.Find(fields[0]);
+            if (candidate == nullptr) {
+                return false;
+            }
+            table.symbols.erase(candidate->GetPartySymbol());
+            table.candidates.erase(table.candidates.begin() + (candidate - table.candidates.data()));
+            table.ids.erase(fields[0]);
+            return true;
+        });
+        if (removed) {
+            votesSet.Remove(fields[0]);
+            candidatesChanged = true;
+        }
+        return true;
     }
-   }
-  }
-  // Display the vote count for the candidate:
-  std::cout << "Candidate ID: " << candidateID << ", Vote Count: " << votesSet[candidateID] << std::endl;
-  
-      return true;
+    int64_t votes = 0;
+    if (record.type == "vote" && fields.size() == 3 && ParseCount(fields[2], votes)) {
+        ApplyReplicaRecord(ReplicaRecord{record.micros, "voter", {fields[0], "1"}});
+        return ApplyReplicaRecord(ReplicaRecord{record.micros, "tally", {fields[1], fields[2]}});
     }
-  
+    if (record.type == "tally" && fields.size() == 2 && ParseCount(fields[1], votes)) {
+        // An older record may name a candidate the files no longer have:
+        if (validCandidates.Current()->Find(fields[0]) != nullptr) {
+            votesSet.Set(fields[0], votes);
+            dirtyCandidates.insert(fields[0]);
+        }
+        return true;
+    }
+    return record.type == "shutdown" && fields.empty();
+  }
 
-  // Displays the overall election results in descending order of vote count.
+  // Runs as a warm standby until the primary dies.
   //
   // Returns:
-  //   true if the results were displayed successfully
-  bool ElectionSystem::ShowResult()
+  //   true when the primary is gone and this process should take over.
+  bool ElectionSystem::RunStandby()
   {
-     // Update the vote counts from the candidate list:
-      for (auto& candidate : validCandidateList) {
-         votesSet[candidate.GetCandidateID()] = candidate.GetNumOfVotes();
-                
-       }
-      // Convert the map to a vector of pairs
-      std::vector<std::pair<std::string, int64_t>> sortedVotes(votesSet.begin(), votesSet.end());
+    // Voters are looked up by every voter record, so the roll is kept sorted:
+    EnsureVoterRoll();
+    ReplicaFollower follower;
+    std::vector<ReplicaRecord> records;
+    bool restarted = false;
+    bool stopped = false;        // The primary being followed stopped cleanly.
+    size_t applied = 0, rejected = 0;
+    double lagMs = 0;            // Between writing and applying the last record.
+    auto reported = std::chrono::steady_clock::now();
+    Out() << "Standby: following " << DataPath("Replica.log") << '\n';
+    follower.Open(DataPath("Replica.log"));  // Polled for until a primary starts it.
+    while (true) {
+        rejected += follower.Poll(records, restarted);
+        if (restarted) {
+            Out() << "Standby: a new primary started\n";
+            stopped = false;
+        }
+        for (const ReplicaRecord& record : records) {
+            rejected += !ApplyReplicaRecord(record);
+            stopped = record.type == "shutdown";
+        }
+        if (!records.empty()) {
+            applied += records.size();
+            lagMs = (ReplicaLogNow() - records.back().micros) / 1000.0;
+        }
 
-      // Sort the vector based on values (second element of the pair)
-      std::sort(sortedVotes.begin(), sortedVotes.end(), [](const auto& a, const auto& b) {
-        return a.second > b.second; // descending order
-      });
+        // The lock goes with the primary; take what it wrote, then take over:
+        bool alive = follower.PrimaryAlive();
+        if (follower.IsOpen() && !alive && !stopped) {
+            rejected += follower.Poll(records, restarted);
+            for (const ReplicaRecord& record : records) {
+                rejected += !ApplyReplicaRecord(record);
+            }
+            applied += records.size();
+            Out() << "Standby: primary lost, taking over after " << applied << " records\n";
+            return true;
+        }
 
-     // Print the sorted vector
-    for (const auto& pair : sortedVotes) {
-        std::cout << pair.first << " has " << pair.second << " votes \n";
-       } 
-      return true;
+        // Replication metrics:
+        auto now = std::chrono::steady_clock::now();
+        if (now - reported >= std::chrono::seconds(1)) {
+            Out() << "Standby: " << applied << " records applied, lag " << lagMs << " ms, "
+                  << follower.BytesBehind() << " bytes behind";
+            if (rejected > 0) {
+                Out() << ", " << rejected << " records rejected";
+            }
+            Out() << (stopped ? ", primary stopped" : alive ? "" : ", waiting for a primary") << '\n';
+            Out().flush();
+            reported = now;
+        }
+        if (records.empty()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
     }
+  }
 
-  // Attempts to fill missing or correct invalid voter information.
+  // Exports the current results to a file. Readers never see a partial file,
+  // since the export is written beside it and renamed into place.
+  //
+  // Args:
+  //   path: The file to write.
+  //   format: The encoding to write.
+  //   grouping: How to group the vote counts.
   //
   // Returns:
-  //   true if the information was updated successfully, false if the user cancelled or an error occurred. 
-  bool ElectionSystem::FillMissingVoterInfo()
-  { 
-
-      if(invalidVoterList.empty())
-      { 
-         std::cout << "There is no Invalid data \n";
-         return true; 
-      }
-      std::cout << "Fill missing data or update invalid data \n";
-      int count = 1;
-      for (const auto& pair :invalidVoterList) {
-        std::cout << count << " Aadhar ID " << pair.first << " Status " << pair.second << '\n';
-        count++;
-      }
-      while(true)
-      {
-        int aadharIdChoice {GetChoice()};
-        if(aadharIdChoice >= 1 && aadharIdChoice <= count)
-         {  
-             
-            auto pair =invalidVoterList[aadharIdChoice-1];
-            std::string aadhar = pair.first;
-            std::string status = pair.second;
-            bool flag1 = false, flag2 = false;;
-            if(IsValidAadhar(aadhar) && (checkAadhar.find(aadhar) == checkAadhar.end()))
-            {
-                  flag1 = true;
-                  checkAadhar.insert(aadhar);
-            }
-            else
-            {
-              while(true)
-               {
-                  std::cout << "Enter New Aadhar Number (max 12 characters, numeric): ";
-                  std::getline(std::cin, aadhar);
-                   if (!std::cin) // if the previous extraction failed
-                   {
-                      if (std::cin.eof()) // if the stream was closed
-                      {
-                          exit(0); // shut down the program now
-                       }
-                     // let's handle the failure
-                      std::cin.clear();                           // put us back in 'normal' operation mode
-                      std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n'); // remove the bad input
-                       std::cout << "Oops, that input is invalid. Please try again.\n";
-                   }
-                   if(IsValidAadhar(aadhar))
-                   {
-                     if(checkAadhar.find(aadhar) == checkAadhar.end())
-                     {
-                        checkAadhar.insert(aadhar);
-                        flag1 =true;
-                        break;
-                     }
-                     else
-                     {
-                        std::cout << "Aadhar Already Exist \n";
-                        std::cout << "Do you want to continue ?  n for back \n";
-                         std::string characterChoice = "a character";
-                         char result = GetValidChar(characterChoice);
-                         if(result == 'n')
-                          { 
-                             return false;;
-                          }
-                     }
-                   }
-                   else
-                   {
-                     std::cout << "Invalid Aadhar ID \n";
-                     std::cout << "Do you want to continue ?  n for back \n";
-                  std::string characterChoice = "a character";
-                  char result = GetValidChar(characterChoice);
-                  if(result == 'n')
-                  { 
-                     return false;
-                  }
-                  
-                  }
-                 }
-             }
-             
-             if(IsValidStatus(status))
-             {
-                flag2 = true;
-             }
-             else
-             {
-              
-               while(true)
-               {
-                   std::cout << "Enter voting status (0 or 1):";
-                   std::getline(std::cin, status);
-                   if (!std::cin) // if the previous extraction failed
-  	           {
-   	            if (std::cin.eof()) // if the stream was closed
-   		    {
-   		       exit(0); // shut down the program now
-   		     }
-   	             // let's handle the failure
-                     std::cin.clear();   // put us back in 'normal' operation mode
-                     std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n'); // remove the bad input
-         	     std::cout << "Oops, that input is invalid. Please try again.\n";
-  	           }
-  	           if(IsValidStatus(status))
-  	           {
-  	                flag2 = true;
-  	                break;
-   	           }
-   	           else
-   	           {
-   	             std::cout << "Invalid Status \n";
-   	             std::cout << "Do you want to continue ?  n for back \n";
-                  std::string characterChoice = "a character";
-         char result = GetValidChar(characterChoice);
-                  if(result == 'n')
-                  { 
-                     return false;;
-                  }
-                  
-                  }
-  	      }
-  	      
-  	    }
-               
-          
-            if(flag1 && flag2)
-            {  
-               bool res = (status == "1" ? 1 : 0); 
-               Voter v(aadhar,(bool) res);
-               validVoterList.push_back(v);
-               invalidVoterList.erase(invalidVoterList.begin() + aadharIdChoice - 1);
-               std:: cout << "Voter Information Updated Successfully \n";
-               return true;
-            }
-
-            
-         }
-         else
-         {
-           std::cout << "Invalid Choice ";
-           std::cout << "Do you want to continue ?  n for back \n";
-                  std::string characterChoice = "a character";
-         char result = GetValidChar(characterChoice);
-                  if(result == 'n')
-                  { 
-                     return false;
-                  }
-         }
-         
-      }
-      
-      return true;
-    }
-  
-  // Writes the valid voter data to a CSV file
-  void ElectionSystem::WriteVoterDataToCSV() {
-    std::ofstream outputFile("Voter.csv");
+  //   true if the file was written, false otherwise.
+  bool ElectionSystem::ExportResultsTo(const std::string& path, ExportFormat format, ExportGrouping grouping)
+  {
+    std::string temporary = path + ".tmp";
+    std::ofstream outputFile(temporary, std::ios::binary);
     if (!outputFile.is_open()) {
-        std::cerr << "Error opening the output voter file.\n";
-        return ;
-    }
-
-    // Write the voter data:
-    for (const auto& voter : validVoterList) {
-        outputFile << voter.GetAadharID() << ","
-                   << voter.GetVotingStatus() << "\n";
+        std::cerr << "Error opening the result export file.\n";
+        return false;
     }
 
+    ExportResults(outputFile, validCandidates.Current()->candidates, votesSet.Snapshot(), grouping, format);
     outputFile.close();
-   }
-
-
-   // Writes the valid candidate data to a CSV file
-   void ElectionSystem::WriteCandidateDataToCSV() {
-    std::ofstream outputFile("Candidate.csv");
-    if (!outputFile.is_open()) {
-        std::cerr << "Error opening the output candidate file.\n";
-        return;
-    }
+    return outputFile && std::rename(temporary.c_str(), path.c_str()) == 0;
+  }
 
-    // Write the candidate data:
-    for (const auto& candidate : validCandidateList) {
-        outputFile << candidate.GetCandidateID() << ","
-                   << candidate.GetCandidateName() << ","
-                   << candidate.GetPartySymbol() << ","
-                   << candidate.GetRegion() << "," 
-                   << candidate.GetNumOfVotes() << "\n";
-    }
+  // Creates an election whose data files live in a directory.
+  //
+  // Args:
+  //   dataDirectory: The directory holding Admin.csv, Candidate.csv,
+  //                  Voter.csv and result.csv.
+  ElectionSystem::ElectionSystem(const std::string& dataDirectory) : dataDirectory(dataDirectory) {}
 
-    outputFile.close();
-   }
+  // Returns the path of a data file of this election.
+  //
+  // Args:
+  //   name: The file name, such as "Voter.csv".
+  std::string ElectionSystem::DataPath(const std::string& name) const
+  {
+    return dataDirectory == "." ? name : dataDirectory + "/" + name;
+  }
 
-   void ElectionSystem::WriteResultDataToCSV() {
-    std::ofstream outputFile("result.csv");
-    if (!outputFile.is_open()) {
-        std::cerr << "Error opening the result file.\n";
+  // Appends the ballots cast in this session to Ballots.csv.
+  void ElectionSystem::WriteBallotDataToCSV()
+  {
+    if (!ballots.Append(DataPath("Ballots.csv"), ballotsSaved)) {
+        std::cerr << "Error writing the ballot file.\n";
         return;
     }
-    std::vector<std::pair<std::string, int64_t>> sortedVotes(votesSet.begin(), votesSet.end());
-
-      // Sort the vector based on values (second element of the pair)
-      std::sort(sortedVotes.begin(), sortedVotes.end(), [](const auto& a, const auto& b) {
-        return a.second > b.second; // descending order
-      });
-       
-    // Iterate through the map and write data to the CSV file
-    for (const auto& entry : sortedVotes) {
-        outputFile << entry.first << "," << entry.second << std::endl;
-    }
-
-    outputFile.close();
+    ballotsSaved = ballots.Size();
   }
 
   // Destructor for the ElectionSystem class.
 // Writes election results, voter data, and candidate data to CSV files.
   ElectionSystem::~ElectionSystem()
  {
+   // Let a background voter load finish before anything is written:
+   if (voterLoad.valid())
+   {
+     voterLoad.wait();
+   }
+
+   // Let a running checkpoint finish, so the files below are written last:
+   ReapCheckpoint(true);
+
+   // Take in the last edits of other tools, so they are not written over:
+   ReloadChangedFiles();
+
    // Write election results to CSV
    ElectionSystem::WriteResultDataToCSV();
 
+   // Save the ranked ballots cast in this session:
+   ElectionSystem::WriteBallotDataToCSV();
+
+   // Publish the final result feed:
+   RefreshResultFeed(true);
+
    // Write voter data to CSV:
    ElectionSystem::WriteVoterDataToCSV();
 
    // Write candidate data to CSV:
    ElectionSystem::WriteCandidateDataToCSV();
+
+   // Tell the standby the files now hold everything:
+   ShipReplicaChanges();
+   replicaLog.RecordShutdown();
+
+   // Send the aggregator the final tally, and leave it on the board:
+   tallyReporter.Stop();
+   resultsBoard.Stop();
  }
  
  // Checks if there are enough valid voters and candidates to conduct an election.
@@ -1759,7 +4476,8 @@ bool ElectionSystem::CastVote()
 //   true if there's at least one valid voter and one valid candidate, false otherwise.
  bool ElectionSystem::checkCast()
  {
-   return validVoterList.size() >= 1 && validCandidateList.size() >= 1;
+   EnsureVoterRoll();
+   return VoterCount() >= 1 && validCandidates.Current()->candidates.size() >= 1;
  }
 
 // Checks if there are  candidates to show result.
@@ -1768,6 +4486,6 @@ bool ElectionSystem::CastVote()
 //   true if there's at least one valid candidate, false otherwise.
   bool ElectionSystem::checkCandidate()
  {
-   return validCandidateList.size() >= 1;
+   return validCandidates.Current()->candidates.size() >= 1;
  }
 
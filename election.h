@@ -2,7 +2,26 @@
 #define ElECTION
 
 #include "candidate.h"
+#include "field_rules.h"
 #include "voter.h"
+#include "voter_record_file.h"
+#include "voter_store.h"
+#include "aadhar_index.h"
+#include "credential.h"
+#include "candidate_index.h"
+#include "candidate_table.h"
+#include "result_export.h"
+#include "tally_store.h"
+#include "invalid_records.h"
+#include "field_parser.h"
+#include "ranked_ballots.h"
+#include "vote_journal.h"
+#include "turnout_series.h"
+#include "file_watch.h"
+#include "roll_archive.h"
+#include "replica_log.h"
+#include "tally_aggregator.h"
+#include "results_board.h"
 
 #include <iostream>  // C++ standard library header
 #include <cctype>    // C++ standard library header
@@ -13,41 +32,208 @@
 #include <set>       // C++ standard library header
 #include <vector>    // C++ standard library header
 #include <unordered_map>  // C++ standard library header
+#include <unordered_set>  // C++ standard library header
 #include <fstream>   // C++ standard library header
 #include <sstream>   // C++ standard library header
+#include <cstdio>    // C++ standard library header
+#include <future>    // C++ standard library header
+#include <thread>    // C++ standard library header
+#include <chrono>    // C++ standard library header
+#include <cstdint>   // C++ standard library header
+#include <functional> // C++ standard library header
+#include <sys/types.h> // POSIX header
+#include <sys/stat.h>  // POSIX header
+#include <sys/wait.h>  // POSIX header
+#include <unistd.h>    // POSIX header
+
+// Thrown when the operator input ends, to unwind the current session.
+struct EndOfInput {};
 
 // Class representing the core functionality of the election management system.
 class ElectionSystem {
  private:
-  // Stores valid admin credentials read from the CSV file.
-  std::unordered_map<std::string, std::string> adminValidate;
+  // Directory holding this election's data files.
+  std::string dataDirectory;
+
+  // Stores the verification records of the valid admins read from the CSV file.
+  std::unordered_map<std::string, CredentialRecord> adminCredentials;
+  std::vector<std::string> adminUnparsedRows;  // Admin.csv rows kept as they are when it is rewritten.
+
+  // Cost of the verification records created for legacy plaintext admin rows.
+  uint32_t adminSpaceCost = CredentialRecord::kDefaultSpaceCost;
+  uint32_t adminTimeCost = CredentialRecord::kDefaultTimeCost;
 
-  // Containers for valid and invalid candidate and voter data.
-  std::vector<Candidate> invalidCandidateList;
-  std::vector<Candidate> validCandidateList;
+  // Containers for valid and invalid candidate and voter data. Valid candidates
+  // are published as immutable versions, so readers never block on admin edits.
+  // Invalid rows are indexed by problem for the repair workflow.
+  InvalidRecords<Candidate> invalidCandidates;
+  VersionedCandidateTable validCandidates;
   std::vector<Voter> validVoterList;
-  std::vector<std::pair<std::string, std::string>> invalidVoterList;
+  InvalidRecords<std::pair<std::string, std::string>> invalidVoters;
 
 
-  // Sets for ensuring uniqueness of candidate IDs ,party symbols , aadhar IDs.
-  std::set<std::string> idSet;
-  std::set<std::string> symbolSet;
+  // Set for ensuring uniqueness of aadhar IDs. Candidate IDs and party symbols
+  // are tracked in each candidate table version.
   std::set<std::string> checkAadhar;
 
-  // Stores the current vote count for each candidate.
-  std::map<std::string, int64_t> votesSet;
+  // Cached candidate listing, printed in one write and rebuilt only when a new
+  // candidate table version is published.
+  static const size_t kListingPageSize = 50;
+  std::string candidateListing;
+  std::vector<size_t> listingLineStarts;
+  std::map<std::string, std::string> regionListings;
+  uint64_t candidateListingVersion = UINT64_MAX;
+
+  // Search index over candidate ID, name and party symbol for operator lookup.
+  static const size_t kSearchResults = 10;
+  static const size_t kSuggestions = 5;
+
+  // Invalid records listed per page in the repair workflow.
+  static const size_t kRepairPageSize = 20;
+  CandidateSearchIndex searchIndex;
+  uint64_t searchIndexVersion = UINT64_MAX;
+
+  // Stores the current vote count for each candidate. Results are read from
+  // snapshots, which always add up to the turnout at a single instant.
+  TallyStore votesSet;
+
+  // Votes per minute of each candidate and region, for live turnout curves.
+  TurnoutSeries turnout;
+
+  // Ranked contests keep every ballot for the counting engine; first
+  // preferences are also tallied in votesSet for plurality views and feeds.
+  CountMethod countMethod = CountMethod::kPlurality;
+  size_t countSeats = 1;
+  BallotStore ballots;
+  size_t ballotsSaved = 0;  // Ballots already in Ballots.csv.
+
+  // Every change to votesSet is also appended to Votes.journal, so an audit
+  // can recount the totals independently of Candidate.csv.
+  VoteJournal voteJournal;
+
+  // Result feed for downstream systems, rewritten at most every resultFeedInterval seconds.
+  std::string resultFeedPath;
+  ExportFormat resultFeedFormat = ExportFormat::kCsv;
+  ExportGrouping resultFeedGrouping = ExportGrouping::kCandidate;
+  double resultFeedInterval = 5;
+  std::chrono::steady_clock::time_point resultFeedWritten;
+
+  // Background checkpoints, started at most every checkpointInterval seconds
+  // (0 = off). A checkpoint forks, and the child writes the election as of
+  // the fork while this process keeps voting. The dirty state the checkpoint
+  // covers is set aside, and put back if the checkpoint fails.
+  double checkpointInterval = 0;
+  pid_t checkpointChild = -1;
+  bool checkpointVoters = false;  // The running checkpoint writes Voter.csv.
+  std::map<std::string, bool> checkpointDirtyVoters;
+  bool checkpointRollChanged = false;
+  bool checkpointCandidatesChanged = false;
+  std::set<std::string> checkpointDirtyCandidates;
+  std::chrono::steady_clock::time_point checkpointStarted;
+  double checkpointPauseMs = 0;  // Time the fork held up this process.
+
+  // Replication to a warm standby. Voter changes are logged as they are made;
+  // candidate and tally changes are shipped after each command, by diffing
+  // the current table and tally against the ones last shipped.
+  bool replicate = false;
+  ReplicaLog replicaLog;
+  std::shared_ptr<const CandidateTable> replicatedTable;
+  TallySnapshot replicatedTally;
+
+  // Reporting of the tally to a national aggregator, from a thread of its own.
+  TallyReporter tallyReporter;
+  std::string tallyReportSocket;
+  std::string tallyReportNode;
+  std::chrono::milliseconds tallyReportInterval{200};
+
+  // Live results in shared memory for local displays, published from a
+  // thread of its own.
+  ResultsBoard resultsBoard;
+  std::string resultsBoardName;
+  std::chrono::milliseconds resultsBoardInterval{20};
 
   // Stores any error messages for reporting to the user.
   std::string errorMessage;
 
+  // Operator console. Defaults to the terminal; a recorded script can be replayed
+  // through it with the output suppressed.
+  std::istream* input = &std::cin;
+  std::ostream* output = &std::cout;
+  std::ostream* errors = &std::cerr;
+
+  // Dirty tracking, so that shutdown I/O is proportional to what changed in the session.
+  std::map<std::string, bool> dirtyVoters;  // Aadhar ID -> new voting status.
+  bool voterRollChanged = false;            // Voters were added, removed or re-keyed.
+  std::set<std::string> dirtyCandidates;    // IDs of candidates whose vote counts changed.
+  bool candidatesChanged = false;           // Candidates were added, removed or edited.
+
+  // When true, status-only voter changes and vote count changes are appended to
+  // the delta files instead of rewriting the whole voter roll and candidate file.
+  bool deltaPersistence = true;
+
+  // When true and Voter.csv is in the fixed-width format, voting status changes are
+  // stored straight into the mapped voter file.
+  bool inPlacePersistence = false;
+  VoterRecordFile voterFile;
+
+  // When true, validVoterList is kept sorted by Aadhar ID and voterKeys holds the
+  // packed IDs in the same order for interpolation search.
+  bool sortedRoll = false;
+  std::vector<uint64_t> voterKeys;
+
+  // When outOfCoreCacheBytes is set, the voter roll stays on disk in voterStore
+  // and validVoterList and checkAadhar stay empty.
+  size_t outOfCoreCacheBytes = 0;
+  VoterStore voterStore;
+
+  // Hot reload. When hotReload is set, Candidate.csv and Voter.csv are watched,
+  // and edits made by other tools are diffed against the valid rows last read
+  // from the files; only the added, removed and changed rows are applied.
+  bool hotReload = false;
+  FileWatch dataWatch;
+  std::vector<Candidate> candidateFileRows;  // Sorted by candidate ID.
+  std::vector<uint64_t> voterFileRows;       // Packed Aadhar ID << 1 | voting status, sorted.
+  static const size_t kReloadInsertLimit = 64;  // More added voters re-sort a sorted roll.
+
+  // Checkpoints under hot reload. The rows a checkpoint writes become the
+  // baseline later edits are diffed against, and the files it renamed into
+  // place are not taken for edits while they are unchanged. Files that change
+  // while a checkpoint runs are reloaded once it is collected.
+  bool voterFileWatched = false;
+  std::unordered_map<uint64_t, int> voterFileEdits;  // Roll changes since voterFileRows matched Voter.csv.
+  std::unordered_map<uint64_t, int> checkpointVoterFileEdits;
+  std::vector<Candidate> checkpointCandidateRows;    // Sorted by candidate ID.
+  int checkpointStamps = -1;  // Read end of the pipe the child reports the files it wrote on.
+  std::map<std::string, std::string> ownFileStamps;  // FileStamp() of files written by checkpoints.
+  std::set<std::string> pendingReloads;
+
+  // Lazy voter roll loading. Until the roll is needed, only the background loader
+  // touches the voter containers.
+  std::future<bool> voterLoad;
+  bool voterRollLoaded = false;
+
   public:
   
-  // Reads admin credentials from a CSV file, validates them, and stores valid pairs.
+  // Reads admin credentials from a CSV file, validates them, and stores their
+  // verification records. Legacy plaintext rows are replaced by records on disk.
   //
   // Returns:
   //   true if at least one valid admin is found, false otherwise.
   bool AdminCsvCheck();
 
+
+  // Sets the cost of the verification records created for legacy admin rows.
+  //
+  // Args:
+  //   spaceCost: The number of 32 byte blocks the password hash fills.
+  //   timeCost: The number of mixing rounds over the blocks.
+  void SetAdminHashCost(uint32_t spaceCost, uint32_t timeCost);
+
+
+  // Writes the admin verification records, and the rows that could not be
+  // read, beside Admin.csv and renames them into place.
+  void WriteAdminDataToCSV();
+
   
   // Calculates a simple checksum by shifting each character in the message by a fixed value.
   //
@@ -69,6 +255,17 @@ class ElectionSystem {
   bool ValidateCandidateID(const std::string& id);
 
 
+  // Validates a candidate ID against a given candidate table version.
+  //
+  // Args:
+  //   id: The candidate ID to validate.
+  //   table: The table the ID must be unique in.
+  //
+  // Returns:
+  //   true if the ID is valid, false otherwise.
+  bool ValidateCandidateID(const std::string& id, const CandidateTable& table);
+
+
   // Validates a candidate name based on length and character composition.
   //
   // Args:
@@ -89,6 +286,17 @@ class ElectionSystem {
   bool ValidatePartySymbol(const std::string& symbol);
 
 
+  // Validates a party symbol against a given candidate table version.
+  //
+  // Args:
+  //   symbol: The party symbol to validate.
+  //   table: The table the symbol must be unique in.
+  //
+  // Returns:
+  //   true if the symbol is valid, false otherwise.
+  bool ValidatePartySymbol(const std::string& symbol, const CandidateTable& table);
+
+
   // Validates a region code based on its format and character composition.
   //
   // Args:
@@ -131,11 +339,226 @@ class ElectionSystem {
   // Returns:
   //   true if at least one valid voter was found, false otherwise.
   bool VoterCsvCheck() ;
+
+
+  // Loads the ranked ballots of earlier sessions from Ballots.csv, if the
+  // contest is ranked.
+  //
+  // Returns:
+  //   true if the ballots were loaded or the contest is not ranked.
+  bool BallotCsvCheck();
+
+
+  // Opens the vote journal. A new journal starts with the votes loaded from
+  // Candidate.csv carried into it.
+  //
+  // Returns:
+  //   true if the journal is open, false otherwise.
+  bool VoteJournalCheck();
+
+
+  // Recounts the vote journal in parallel and cross-checks it against the
+  // stored tallies and the number of voters marked as voted, printing every
+  // discrepancy with the candidate and journal line it was found at.
+  //
+  // Returns:
+  //   true if the audit found no discrepancy, false otherwise.
+  bool AuditVotes();
+
+
+  // Writes the voter roll to a compressed roll archive.
+  //
+  // Args:
+  //   path: The archive to write.
+  //
+  // Returns:
+  //   true if the archive was written, false otherwise.
+  bool BackupVoterRoll(const std::string& path);
+
+
+  // Replaces Voter.csv with the voters of a roll archive, as sorted
+  // fixed-width records, and drops the voter delta file. Run before the
+  // voter roll is loaded.
+  //
+  // Args:
+  //   path: The archive to read.
+  //
+  // Returns:
+  //   true if Voter.csv was replaced, false otherwise.
+  bool RestoreVoterRoll(const std::string& path);
   
+  // Starts loading the voter roll on a background thread.
+  void StartVoterRollLoad();
+
+
+  // Makes the voter roll available, waiting for the background load or loading it now.
+  //
+  // Returns:
+  //   true if at least one valid voter was found, false otherwise.
+  bool EnsureVoterRoll();
+
+
+  // Checks the Aadhar ID and voting status formats without touching errorMessage,
+  // so they are safe to call from the background voter loader.
+  static bool IsAadharFormat(const std::string& aadhar);
+  static bool IsStatusFormat(const std::string& status);
+
   bool IsValidAadhar(const std::string& aadhar);
 
   bool IsValidStatus(const std::string& status) ;
+
+
+  // Applies the status changes recorded in the voter delta file to validVoterList.
+  //
+  // Returns:
+  //   The number of delta rows applied.
+  size_t ApplyVoterDelta();
+
+
+  // Applies the vote counts recorded in the candidate delta file to the tally.
+  //
+  // Returns:
+  //   The number of delta rows applied.
+  size_t ApplyCandidateDelta();
+
+
+  // Opens the out-of-core voter roll and folds the voter delta file into it.
+  //
+  // Returns:
+  //   true if at least one valid voter was found, false otherwise.
+  bool LoadVoterStore();
+
+
+  // Records a voting status change of an existing voter for delta persistence.
+  //
+  // Args:
+  //   aadhar: The Aadhar ID of the voter whose status changed.
+  //   status: The new voting status.
+  void MarkVoterDirty(const std::string& aadhar, bool status);
+
+
+  // Selects between delta persistence and a full voter roll rewrite on exit.
+  //
+  // Args:
+  //   enabled: true to append status and vote count changes to the delta files.
+  void SetDeltaPersistence(bool enabled);
+
+
+  // Selects in-place status updates of the fixed-width voter file.
+  //
+  // Args:
+  //   enabled: true to map Voter.csv and update status bytes in place.
+  void SetInPlacePersistence(bool enabled);
+
+
+  // Selects keeping the voter roll sorted by Aadhar ID for interpolation search.
+  //
+  // Args:
+  //   enabled: true to sort the roll after loading and keep it sorted.
+  void SetSortedRoll(bool enabled);
+
+
+  // Selects the out-of-core voter roll, which keeps at most a page cache of the
+  // roll in memory.
+  //
+  // Args:
+  //   cacheBytes: The page cache size; 0 loads the whole roll into memory.
+  void SetOutOfCore(size_t cacheBytes);
+
+
+  // Selects how the contest is counted.
+  //
+  // Args:
+  //   method: The count method; ranked methods ask voters for preferences.
+  //   seats: The number of seats to fill by single transferable vote.
+  void SetCountMethod(CountMethod method, size_t seats);
+
+
+  // Selects reloading Candidate.csv and Voter.csv when other tools change them.
+  //
+  // Args:
+  //   enabled: true to watch the files and apply their changes while running.
+  void SetHotReload(bool enabled);
+
+
+  // Starts watching the data files for hot reload, before they are loaded so
+  // that no edit is missed. Voter.csv is not watched when the system keeps
+  // writing it itself, out of core or in place.
+  //
+  // Returns:
+  //   true if the files are watched, false if hot reload is off or failed.
+  bool WatchDataFiles();
+
+
+  // Applies the edits other tools made to the watched data files since the
+  // last call.
+  void ReloadChangedFiles();
+
+
+  // Diffs Candidate.csv against the rows last read and applies the added,
+  // removed and changed candidates, with validation. Vote counts stay those
+  // of the tally.
+  void ReloadCandidates();
+
+
+  // Diffs Voter.csv against the rows last read and applies the added, removed
+  // and changed voters, with validation.
+  void ReloadVoters();
+
+
+  // Sorts validVoterList by Aadhar ID and rebuilds voterKeys.
+  void SortVoterRoll();
+
+
+  // Returns true if an Aadhar ID is registered, in memory or in the out-of-core roll.
+  bool VoterRegistered(const std::string& aadhar);
+
+
+  // Records an Aadhar ID as taken. The out-of-core roll tracks its IDs itself.
+  void RegisterAadhar(const std::string& aadhar);
+
+
+  // Returns the number of registered voters.
+  size_t VoterCount() const;
+
+
+  // Finds a voter in validVoterList, by interpolation search for a sorted roll.
+  //
+  // Args:
+  //   aadhar: The voter's Aadhar ID.
+  //
+  // Returns:
+  //   The index of the voter, or -1 if the voter is not registered.
+  long FindVoter(const std::string& aadhar);
+
+
+  // Adds a voter to validVoterList, at its sorted position for a sorted roll.
+  //
+  // Args:
+  //   voter: The voter to add.
+  void InsertVoter(const Voter& voter);
+
+
+  // Removes a voter from validVoterList.
+  //
+  // Args:
+  //   index: The index of the voter to remove.
+  void EraseVoter(size_t index);
   
+  // Redirects the operator console, e.g. to replay a recorded script.
+  //
+  // Args:
+  //   in: The stream operator input is read from.
+  //   out: The stream prompts and messages are written to.
+  //   err: The stream error messages are written to.
+  void SetConsole(std::istream& in, std::ostream& out, std::ostream& err);
+
+  // The current operator console streams.
+  std::istream& In();
+  std::ostream& Out();
+  std::ostream& Err();
+
+
   // Repeatedly prompts the user to enter a valid integer choice.
   //
   // Returns:
@@ -171,32 +594,158 @@ class ElectionSystem {
   bool GetAdminAuthenicate() ;
 
 
-  // Gathers valid candidate information from the user and adds it to the valid_candidate_list_.
+  // Prompts for the password of the first admin, "admin", and stores its
+  // verification record in Admin.csv, so the default password stops working.
+  //
+  // Returns:
+  //   true if the password was set, false if the user cancels.
+  bool SetFirstAdminPassword();
+
+
+  // Gathers valid candidate information from the user and adds it to the candidate table.
   //
   // Returns:
   //   true if a candidate was successfully added, false if the user cancelled.
   bool AddCandidate();
   
 
-  // Identifies and guides the user to fill missing or invalid information in invalid_candidate_list_.
+  // Identifies and guides the user to fill missing or invalid information in invalidCandidates.
   //
   // Returns:
   //   true if candidates were successfully updated, false if the user cancelled.
   bool FillMissingCandidateInfo();
 
 
-  // Removes a candidate from the valid_candidate_list_ based on their ID.
+  // Finds every problem of a candidate row.
+  //
+  // Args:
+  //   candidate: The candidate row.
+  //   table: The table its ID and party symbol must be unique in.
+  //
+  // Returns:
+  //   The RecordProblem bits the row fails on.
+  unsigned CandidateProblems(const Candidate& candidate, const CandidateTable& table);
+
+
+  // Prints a page of the invalid candidates, with the count of each problem.
+  //
+  // Args:
+  //   problem: A single problem bit to list, or 0 for all records.
+  //   page: The 1-based page to print.
+  void PrintInvalidCandidates(unsigned problem, size_t page);
+
+
+  // Registers every invalid candidate that only needs its fields trimmed.
+  //
+  // Returns:
+  //   The number of candidates repaired.
+  size_t AutoRepairCandidates();
+
+
+  // Reads repair workflow commands until the operator picks a record: a record
+  // number picks it, "?<page>" prints a page, "?<problem>" lists the records
+  // with a problem, "!" runs the automatic repair and "n" goes back.
+  //
+  // Args:
+  //   records: The invalid records to pick from.
+  //   id: Receives the ID of the picked record.
+  //   printPage: Prints a page of the records, given a problem filter.
+  //   autoRepair: Repairs what can be fixed mechanically, returning the count.
+  //
+  // Returns:
+  //   true if a record was picked, false if the operator went back or ran the
+  //   automatic repair.
+  template <typename Record>
+  bool PickInvalidRecord(const InvalidRecords<Record>& records, size_t& id,
+                         const std::function<void(unsigned, size_t)>& printPage,
+                         const std::function<size_t()>& autoRepair);
+
+
+  // Returns a field without surrounding blanks, carriage returns or quotes.
+  std::string TrimField(const std::string& field);
+
+
+  // Builds the cached candidate listing, unless it was built from the same
+  // candidate table version.
+  //
+  // Args:
+  //   table: The candidate table version to list.
+  //
+  // Returns:
+  //   The listing, one line per candidate in table order.
+  const std::string& CandidateListing(const CandidateTable& table);
+
+
+  // Prints one page of the cached candidate listing in a single write. Short
+  // listings are printed whole.
+  //
+  // Args:
+  //   page: The 1-based page to print.
+  void PrintCandidateListing(size_t page);
+
+
+  // Prints the cached candidate listing of one region in a single write.
+  //
+  // Args:
+  //   region: The region ID to list.
+  void PrintRegionListing(const std::string& region);
+
+
+  // Prints the candidates that best match a query, best match first.
+  //
+  // Args:
+  //   query: Part of a candidate ID, name or party symbol.
+  //   limit: The maximum number of candidates to print.
+  //
+  // Returns:
+  //   The number of candidates printed.
+  size_t PrintCandidateMatches(const std::string& query, size_t limit);
+
+
+  // Suggests the candidates closest to a candidate ID that was not found.
+  //
+  // Args:
+  //   input: The text the user entered.
+  void SuggestCandidates(const std::string& input);
+
+
+  // Handles a listing command typed at a candidate ID prompt: "?<page>" prints a
+  // page of the candidate listing, "?<region>" the candidates of a region and
+  // "/<text>" the candidates whose ID, name or party symbol best match the text.
+  //
+  // Args:
+  //   input: The text the user entered.
+  //
+  // Returns:
+  //   true if the input was a listing command, false if it is a candidate ID.
+  bool HandleListingCommand(const std::string& input);
+
+
+  // Removes a candidate from the candidate table based on their ID.
   //
   // Returns:
   //   true if a candidate was successfully removed, false if the user cancelled.
   bool RemoveCandidate() ;
 
 
-  // Modifies a candidate's information in the valid_candidate_list_.
+  // Modifies a candidate's information in the candidate table.
   //
   // Returns:
   //   true if a candidate was successfully modified, false if the user cancelled.
   bool ModifyCandidate();
+
+
+  // Publishes a candidate table version with one candidate's details edited.
+  //
+  // Args:
+  //   candidateID: The candidate to edit.
+  //   edit: Applies the change to the candidate in a copy of the table; returns
+  //         false, with errorMessage set, to abandon it.
+  //
+  // Returns:
+  //   true if the edit was published, false if it was abandoned or the
+  //   candidate was removed in the meantime.
+  bool EditCandidate(const std::string& candidateID, const std::function<bool(Candidate&, CandidateTable&)>& edit);
   
   
   // Adds a new voter to the valid_voter_listt_ container.
@@ -213,6 +762,14 @@ class ElectionSystem {
   bool ModifyVoter();
 
 
+  // Modifies a voter of the out-of-core roll, picked by Aadhar ID since the
+  // roll is too large to list.
+  //
+  // Returns:
+  //   true if a voter was successfully modified, false if the user cancelled.
+  bool ModifyStoredVoter();
+
+
   // Removes a voter from the valid_voter_listt_ and check_aadhar_ containers.
   //
   // Returns:
@@ -237,6 +794,28 @@ class ElectionSystem {
   //   true if the results were displayed successfully
   bool ShowResult();
 
+
+  // Runs the ranked count over all ballots and prints each round.
+  void ShowRankedResult();
+
+
+  // Prints the votes cast in the last minutes, overall and per region, and
+  // the turnout curve of the last hour.
+  //
+  // Args:
+  //   turnoutTotal: The turnout the curve ends at.
+  void ShowTurnout(int64_t turnoutTotal);
+
+
+  // Asks a voter for their preferences after their first choice.
+  //
+  // Args:
+  //   ranking: Holds the first choice; receives the further preferences.
+  //
+  // Returns:
+  //   true if the ballot is complete, false if the voter cancelled.
+  bool ReadLaterPreferences(std::vector<std::string>& ranking);
+
   
   // Attempts to fill missing or correct invalid voter information.
   //
@@ -245,16 +824,248 @@ class ElectionSystem {
   bool FillMissingVoterInfo();
 
 
-  // Writes the valid voter data to a CSV file
+  // Finds every problem of a voter row.
+  //
+  // Args:
+  //   aadhar: The Aadhar ID as read.
+  //   status: The voting status as read.
+  //
+  // Returns:
+  //   The RecordProblem bits the row fails on.
+  unsigned VoterProblems(const std::string& aadhar, const std::string& status);
+
+
+  // Stores a voter row that failed validation for the repair workflow.
+  void AddInvalidVoter(const std::string& aadhar, const std::string& status);
+
+
+  // Prints a page of the invalid voters, with the count of each problem.
+  //
+  // Args:
+  //   problem: A single problem bit to list, or 0 for all records.
+  //   page: The 1-based page to print.
+  void PrintInvalidVoters(unsigned problem, size_t page);
+
+
+  // Registers every invalid voter whose Aadhar ID only has separators or blanks
+  // in it and whose status is spelled out ("yes", "true", ...).
+  //
+  // Returns:
+  //   The number of voters repaired.
+  size_t AutoRepairVoters();
+
+
+  // Writes the valid voter data to a CSV file, or only the changed rows to the
+  // voter delta file when the roll itself is unchanged.
   void WriteVoterDataToCSV() ;
 
 
-   // Writes the valid candidate data to a CSV file
+  // Appends the dirty voter rows to the voter delta file.
+  void AppendVoterDelta();
+
+
+   // Writes the valid candidate data to a CSV file, or only the changed vote
+   // counts to the candidate delta file when no candidate was added, removed
+   // or edited.
   void WriteCandidateDataToCSV() ;
 
 
+  // Appends the vote counts of the dirty candidates to the candidate delta file.
+  void AppendCandidateDelta();
+
+
+  // Writes the election results to a CSV file, if any candidate changed.
   void WriteResultDataToCSV();
+
+
+  // Writes the candidates, with the counts from the tally, beside a file and
+  // renames them into place.
+  //
+  // Returns:
+  //   true if the file was replaced, false otherwise.
+  bool WriteCandidateFile(const std::string& path);
+
+
+  // Writes the results, most votes first, beside a file and renames them into
+  // place.
+  //
+  // Returns:
+  //   true if the file was replaced, false otherwise.
+  bool WriteResultFile(const std::string& path);
+
+
+  // Forks a checkpoint child, setting the dirty state it covers aside.
+  void StartCheckpoint();
+
+
+  // Writes the checkpoint files. Runs in the checkpoint child.
+  //
+  // Returns:
+  //   true if every file was written, false otherwise.
+  bool WriteCheckpoint();
+
+
+  // Note a voter's registration, change or removal for the standby, and for
+  // the hot reload baseline a checkpoint brings up to date.
+  void NoteVoterChange(const std::string& aadhar, bool status);
+  void NoteVoterRemoval(const std::string& aadhar);
+
+  // Note a cast vote like NoteVoterChange, logging the voter and the
+  // candidate's new count as one record, so a standby never has one without
+  // the other.
+  //
+  // Args:
+  //   aadhar: The voter's Aadhar ID.
+  //   candidateID: The candidate voted for.
+  //   votes: The candidate's vote count including this vote.
+  void NoteVote(const std::string& aadhar, const std::string& candidateID, int64_t votes);
+
+
+  // Brings voterFileRows up to date with roll changes a checkpoint wrote.
+  //
+  // Args:
+  //   edits: Packed Aadhar ID to voting status, or -1 for a removed voter.
+  void ApplyVoterFileEdits(const std::unordered_map<uint64_t, int>& edits);
+
+
+  // Returns what identifies the current contents of a data file: its device,
+  // inode, size and modification time, or an empty string if it is missing.
+  //
+  // Args:
+  //   name: The file name, such as "Voter.csv".
+  std::string FileStamp(const std::string& name) const;
+
+
+  // Applies a replica log record on the standby.
+  //
+  // Returns:
+  //   true if the record was applied, false if it is not a known record.
+  bool ApplyReplicaRecord(const ReplicaRecord& record);
+
+
+  // Collects a finished checkpoint child and reports it.
+  //
+  // Args:
+  //   wait: true to wait for a running checkpoint to finish.
+  void ReapCheckpoint(bool wait);
+
+
+  // Appends the ballots cast in this session to Ballots.csv.
+  void WriteBallotDataToCSV();
    
+  // Configures a result feed that is rewritten periodically for downstream systems.
+  //
+  // Args:
+  //   path: The feed file.
+  //   format: The encoding of the feed.
+  //   grouping: How vote counts are grouped in the feed.
+  //   intervalSeconds: The minimum time between two feed refreshes.
+  void SetResultFeed(const std::string& path, ExportFormat format, ExportGrouping grouping,
+                     double intervalSeconds);
+
+
+  // Rewrites the result feed if its refresh interval has passed.
+  //
+  // Args:
+  //   force: true to rewrite the feed regardless of the interval.
+  void RefreshResultFeed(bool force);
+
+
+  // Selects periodic background checkpoints of the whole election.
+  //
+  // Args:
+  //   seconds: The minimum time between two checkpoints, or 0 for none.
+  void SetCheckpointInterval(double seconds);
+
+
+  // Reports a finished checkpoint, and starts a new one if the interval has
+  // passed and anything changed since the last one. Called between commands.
+  void CheckpointIfDue();
+
+
+  // Selects logging every change to Replica.log for a warm standby.
+  void SetReplication(bool enabled);
+
+
+  // Starts a new replica log, beginning with every candidate and tally.
+  //
+  // Returns:
+  //   true if the log is open or replication is off, false otherwise.
+  bool StartReplicaLog();
+
+
+  // Logs the candidate and tally changes made since the last call. Called
+  // after each command.
+  void ShipReplicaChanges();
+
+
+  // Runs as a warm standby: applies the replica log of the primary running on
+  // the same data directory as it grows, printing the replication lag every
+  // second, until the primary dies. A primary that stops cleanly is followed
+  // again once a new one starts. Nothing is written while on standby.
+  //
+  // Returns:
+  //   true when the primary is gone and this process should take over.
+  bool RunStandby();
+
+
+  // Selects reporting the tally to an aggregator.
+  //
+  // Args:
+  //   socketPath: The aggregator's socket.
+  //   node: The name this election reports under; the data directory if empty.
+  //   interval: The time between two reports.
+  void SetTallyReport(const std::string& socketPath, const std::string& node, std::chrono::milliseconds interval);
+
+
+  // Starts reporting the tally, if an aggregator was selected.
+  //
+  // Returns:
+  //   true if reporting started or no aggregator was selected, false otherwise.
+  bool StartTallyReport();
+
+
+  // Selects publishing the results on a shared memory board.
+  //
+  // Args:
+  //   name: The shared memory name of the board.
+  //   interval: The time between two checks for changes.
+  void SetResultsBoard(const std::string& name, std::chrono::milliseconds interval);
+
+
+  // Starts publishing the results board, if one was selected.
+  //
+  // Returns:
+  //   true if the board was created or none was selected, false otherwise.
+  bool StartResultsBoard();
+
+
+  // Exports the current results to a file. Readers never see a partial file,
+  // since the export is written beside it and renamed into place.
+  //
+  // Args:
+  //   path: The file to write.
+  //   format: The encoding to write.
+  //   grouping: How to group the vote counts.
+  //
+  // Returns:
+  //   true if the file was written, false otherwise.
+  bool ExportResultsTo(const std::string& path, ExportFormat format, ExportGrouping grouping);
+
+  // Creates an election whose data files live in a directory.
+  //
+  // Args:
+  //   dataDirectory: The directory holding Admin.csv, Candidate.csv,
+  //                  Voter.csv and result.csv.
+  explicit ElectionSystem(const std::string& dataDirectory = ".");
+
+
+  // Returns the path of a data file of this election.
+  //
+  // Args:
+  //   name: The file name, such as "Voter.csv".
+  std::string DataPath(const std::string& name) const;
+
   // Destructor for the ElectionSystem class.
   // Writes election results, voter data, and candidate data to CSV files.
   ~ElectionSystem();
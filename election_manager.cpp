@@ -0,0 +1,95 @@
+#include "election_manager.h"
+
+#include <algorithm>
+#include <filesystem>
+
+ElectionManager::ElectionManager(const std::string& root, size_t maxLoaded, bool backgroundVoterLoad,
+                                 std::function<void(ElectionSystem&)> configure)
+    : root(root), maxLoaded(std::max<size_t>(maxLoaded, 1)), backgroundVoterLoad(backgroundVoterLoad),
+      configure(std::move(configure))
+{
+}
+
+// Returns the IDs of the elections under the root, sorted.
+std::vector<std::string> ElectionManager::ElectionIDs() const
+{
+  std::vector<std::string> ids;
+  std::error_code error;
+  for (const auto& entry : std::filesystem::directory_iterator(root, error))
+  {
+    if (entry.is_directory(error))
+    {
+      ids.push_back(entry.path().filename().string());
+    }
+  }
+  std::sort(ids.begin(), ids.end());
+  return ids;
+}
+
+// Returns a loaded election, loading it first if needed.
+ElectionSystem* ElectionManager::Open(const std::string& electionID)
+{
+  auto it = loaded.find(electionID);
+  if (it != loaded.end())
+  {
+    recentlyUsed.remove(electionID);
+    recentlyUsed.push_front(electionID);
+    return it->second.get();
+  }
+
+  // Election IDs name a directory directly under the root:
+  std::error_code error;
+  std::string directory = root + "/" + electionID;
+  if (electionID.empty() || electionID == "." || electionID == ".." ||
+      electionID.find('/') != std::string::npos || !std::filesystem::is_directory(directory, error))
+  {
+    return nullptr;
+  }
+
+  // Make room before loading, so at most maxLoaded elections hold data:
+  while (loaded.size() >= maxLoaded)
+  {
+    std::string oldest = recentlyUsed.back();
+    Evict(oldest);
+  }
+
+  auto election = std::make_unique<ElectionSystem>(directory);
+  if (configure)
+  {
+    configure(*election);
+  }
+  election->WatchDataFiles();
+  if (backgroundVoterLoad)
+  {
+    election->StartVoterRollLoad();
+  }
+  election->AdminCsvCheck();
+  election->CandidateCsvCheck();
+  election->BallotCsvCheck();
+  election->VoteJournalCheck();
+  election->StartReplicaLog();
+  election->StartTallyReport();
+
+  ElectionSystem* opened = election.get();
+  loaded[electionID] = std::move(election);
+  recentlyUsed.push_front(electionID);
+  return opened;
+}
+
+// Persists and unloads an election.
+bool ElectionManager::Evict(const std::string& electionID)
+{
+  auto it = loaded.find(electionID);
+  if (it == loaded.end())
+  {
+    return false;
+  }
+  loaded.erase(it);  // The destructor writes whatever changed.
+  recentlyUsed.remove(electionID);
+  return true;
+}
+
+bool ElectionManager::IsLoaded(const std::string& electionID) const
+{
+  return loaded.count(electionID) != 0;
+}
@@ -0,0 +1,64 @@
+#ifndef ELECTION_MANAGER
+#define ELECTION_MANAGER
+
+#include "election.h"
+
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Hosts many elections in one process.
+//
+// Each election keeps its data files in its own directory under a common root,
+// named by its election ID. Elections are loaded on first use and evicted,
+// which persists their data, when more than maxLoaded are resident; the least
+// recently used election is evicted first.
+class ElectionManager {
+public:
+    // Args:
+    //   root: The directory holding one data directory per election.
+    //   maxLoaded: The maximum number of elections kept loaded.
+    //   backgroundVoterLoad: Whether voter rolls load in the background as soon
+    //                        as an election is opened, or on first use.
+    //   configure: Applies options to an election before its data is loaded.
+    ElectionManager(const std::string& root, size_t maxLoaded, bool backgroundVoterLoad,
+                    std::function<void(ElectionSystem&)> configure);
+
+    ElectionManager(const ElectionManager&) = delete;
+    ElectionManager& operator=(const ElectionManager&) = delete;
+
+    // Returns the IDs of the elections under the root, sorted.
+    std::vector<std::string> ElectionIDs() const;
+
+    // Returns a loaded election, loading it first if needed.
+    //
+    // Args:
+    //   electionID: The name of the election's data directory.
+    //
+    // Returns:
+    //   The election, or nullptr if there is no election with that ID.
+    ElectionSystem* Open(const std::string& electionID);
+
+    // Persists and unloads an election.
+    //
+    // Returns:
+    //   true if the election was loaded, false otherwise.
+    bool Evict(const std::string& electionID);
+
+    bool IsLoaded(const std::string& electionID) const;
+
+private:
+    std::string root;
+    size_t maxLoaded;
+    bool backgroundVoterLoad;
+    std::function<void(ElectionSystem&)> configure;
+
+    std::map<std::string, std::unique_ptr<ElectionSystem>> loaded;
+    std::list<std::string> recentlyUsed;  // Loaded election IDs, most recent first.
+};
+
+#endif
@@ -0,0 +1,53 @@
+#include "field_parser.h"
+
+#include <charconv>
+
+CsvFields::CsvFields(std::string_view line, char separator) : rest(line), separator(separator)
+{
+  if (!rest.empty() && rest.back() == '\r')
+  {
+    rest.remove_suffix(1);
+  }
+}
+
+// Reads the next field.
+bool CsvFields::Next(std::string_view& field)
+{
+  if (rest.empty())
+  {
+    return false;
+  }
+  size_t end = rest.find(separator);
+  field = rest.substr(0, end);
+  rest = (end == std::string_view::npos) ? std::string_view() : rest.substr(end + 1);
+  return true;
+}
+
+// Parses a non-negative decimal count in one pass.
+bool ParseCount(std::string_view field, int64_t& value)
+{
+  // from_chars accepts a leading '-' for signed types, so check the first digit here:
+  if (field.empty() || field[0] < '0' || field[0] > '9')
+  {
+    return false;
+  }
+  int64_t parsed = 0;
+  auto [end, error] = std::from_chars(field.data(), field.data() + field.size(), parsed);
+  if (error != std::errc() || end != field.data() + field.size())
+  {
+    return false;
+  }
+  value = parsed;
+  return true;
+}
+
+// Parses a voting status, "0" or "1".
+bool ParseStatus(std::string_view field, bool& status)
+{
+  if (field.size() != 1 || (field[0] != '0' && field[0] != '1'))
+  {
+    return false;
+  }
+  status = field[0] == '1';
+  return true;
+}
@@ -0,0 +1,55 @@
+#ifndef FIELD_PARSER
+#define FIELD_PARSER
+
+#include <cstdint>
+#include <string_view>
+
+// Splits a data file line into its fields without copying them.
+//
+// Fields are views into the line, so the line must outlive them. A trailing
+// carriage return is dropped, so files with Windows line endings load the same.
+// Like std::getline, an empty line has no fields and a separator at the end of
+// the line does not start another field.
+class CsvFields {
+public:
+    // Args:
+    //   line: The line, without its '\n'.
+    //   separator: The field separator.
+    explicit CsvFields(std::string_view line, char separator = ',');
+
+    // Reads the next field.
+    //
+    // Args:
+    //   field: Receives the field.
+    //
+    // Returns:
+    //   true if there was another field, false at the end of the line.
+    bool Next(std::string_view& field);
+
+private:
+    std::string_view rest;
+    char separator;
+};
+
+// Parses a non-negative decimal count, such as a vote count, in one pass with
+// std::from_chars: no allocation, no exceptions and no locale.
+//
+// Args:
+//   field: The field; only digits are accepted, with no sign or blanks.
+//   value: Receives the count.
+//
+// Returns:
+//   true if the field is a count that fits in 63 bits, false otherwise.
+bool ParseCount(std::string_view field, int64_t& value);
+
+// Parses a voting status, "0" or "1".
+//
+// Args:
+//   field: The field.
+//   status: Receives true for "1".
+//
+// Returns:
+//   true if the field is a voting status, false otherwise.
+bool ParseStatus(std::string_view field, bool& status);
+
+#endif
@@ -0,0 +1,108 @@
+#ifndef FIELD_RULES
+#define FIELD_RULES
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// Character classes a field rule can allow or require.
+enum CharClass : unsigned { kNoClass = 0, kAlpha = 1, kDigit = 2, kAnyChar = ~0u };
+
+// Compile-time description of what a field value must look like.
+struct FieldRule {
+    size_t minLength;
+    size_t maxLength;
+    unsigned allowed;    // Classes every character must belong to.
+    unsigned required;   // Classes that must each appear at least once.
+    bool noLeadingZero;  // For numeric IDs, which must not start with '0'.
+};
+
+// Why a value failed its rule.
+enum class RuleCheck { kOk, kBadLength, kBadCharacter, kMissingClass, kLeadingZero };
+
+
+// Field rules of the election data. Compile with -DELECTION_RULES_HEADER=<file>
+// and -DELECTION_RULES=<struct> to build in another rule set with the same
+// members; the checks below are generated from whichever set is active.
+struct DefaultRules {
+    static constexpr FieldRule kCandidateID{3, 5, kAnyChar, kAlpha | kDigit, false};
+    static constexpr FieldRule kCandidateName{2, 20, kAlpha, kNoClass, false};
+    static constexpr FieldRule kPartySymbol{2, 20, kAlpha, kNoClass, false};
+    static constexpr FieldRule kRegionCode{0, std::string::npos, kAnyChar, kAlpha | kDigit, false};
+    static constexpr FieldRule kAadhar{12, 12, kDigit, kNoClass, true};
+};
+
+#ifdef ELECTION_RULES_HEADER
+#include ELECTION_RULES_HEADER
+#endif
+
+#ifndef ELECTION_RULES
+#define ELECTION_RULES DefaultRules
+#endif
+
+using ActiveRules = ELECTION_RULES;
+
+// Aadhar IDs are stored as fixed-width records and packed into 64 bit keys.
+static_assert(ActiveRules::kAadhar.minLength == ActiveRules::kAadhar.maxLength,
+              "Aadhar IDs must have a fixed length");
+static_assert(ActiveRules::kAadhar.maxLength <= 19 && ActiveRules::kAadhar.allowed == kDigit,
+              "Aadhar IDs must be numeric and fit a 64 bit key");
+
+
+// Returns the classes a character belongs to.
+constexpr unsigned ClassOf(char c)
+{
+    return (c >= '0' && c <= '9') ? kDigit : ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')) ? kAlpha : kNoClass;
+}
+
+// Checks a value against a field rule. The rule is a template argument, so
+// each field gets its own inlined check with the tests it does not need
+// compiled out.
+//
+// Args:
+//   value: The field value to check.
+//
+// Returns:
+//   RuleCheck::kOk if the value satisfies the rule, otherwise why not.
+template <const FieldRule& Rule>
+inline RuleCheck CheckField(std::string_view value)
+{
+    if constexpr (Rule.minLength == Rule.maxLength) {
+        if (value.size() != Rule.minLength) return RuleCheck::kBadLength;
+    } else {
+        if constexpr (Rule.minLength > 0) {
+            if (value.size() < Rule.minLength) return RuleCheck::kBadLength;
+        }
+        if constexpr (Rule.maxLength != std::string::npos) {
+            if (value.size() > Rule.maxLength) return RuleCheck::kBadLength;
+        }
+    }
+
+    unsigned seen = kNoClass;
+    for (char c : value) {
+        unsigned cls = ClassOf(c);
+        if constexpr (Rule.allowed != kAnyChar) {
+            if ((cls & Rule.allowed) == 0) return RuleCheck::kBadCharacter;
+        }
+        if constexpr (Rule.required != kNoClass) {
+            seen |= cls;
+        }
+    }
+    if constexpr (Rule.required != kNoClass) {
+        if ((seen & Rule.required) != Rule.required) return RuleCheck::kMissingClass;
+    }
+
+    if constexpr (Rule.noLeadingZero) {
+        if (!value.empty() && value[0] == '0') return RuleCheck::kLeadingZero;
+    }
+    return RuleCheck::kOk;
+}
+
+// Returns true if a value satisfies a field rule.
+template <const FieldRule& Rule>
+inline bool MatchesField(std::string_view value)
+{
+    return CheckField<Rule>(value) == RuleCheck::kOk;
+}
+
+#endif
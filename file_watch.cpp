@@ -0,0 +1,77 @@
+#include "file_watch.h"
+
+#include <algorithm>
+
+#include <sys/inotify.h>
+#include <unistd.h>
+
+FileWatch::~FileWatch() { Close(); }
+
+// Starts watching files.
+bool FileWatch::Open(const std::string& directory, const std::vector<std::string>& names)
+{
+  Close();
+  fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (fd < 0)
+  {
+    return false;
+  }
+  if (inotify_add_watch(fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0)
+  {
+    Close();
+    return false;
+  }
+  this->names = names;
+  return true;
+}
+
+void FileWatch::Close()
+{
+  if (fd >= 0)
+  {
+    close(fd);
+    fd = -1;
+  }
+}
+
+bool FileWatch::IsOpen() const { return fd >= 0; }
+
+// Returns the watched files that changed since the last call.
+std::set<std::string> FileWatch::Changed()
+{
+  std::set<std::string> changed;
+  if (fd < 0)
+  {
+    return changed;
+  }
+
+  alignas(struct inotify_event) char buffer[4096];
+  while (true)
+  {
+    ssize_t length = read(fd, buffer, sizeof(buffer));
+    if (length <= 0)
+    {
+      // EAGAIN: no more events queued.
+      break;
+    }
+    for (char* position = buffer; position < buffer + length;)
+    {
+      const struct inotify_event* event = reinterpret_cast<const struct inotify_event*>(position);
+      if (event->mask & IN_Q_OVERFLOW)
+      {
+        // Events were dropped; any of the files may have changed:
+        changed.insert(names.begin(), names.end());
+      }
+      else if (event->len > 0)
+      {
+        std::string name(event->name);
+        if (std::find(names.begin(), names.end(), name) != names.end())
+        {
+          changed.insert(name);
+        }
+      }
+      position += sizeof(struct inotify_event) + event->len;
+    }
+  }
+  return changed;
+}
@@ -0,0 +1,46 @@
+#ifndef FILE_WATCH
+#define FILE_WATCH
+
+#include <set>
+#include <string>
+#include <vector>
+
+// Watches files of a directory for changes made by other programs.
+//
+// The directory itself is watched through inotify, so a file that is replaced
+// by renaming a new one over it is seen as well as one written in place. A
+// file counts as changed when a writer closes it or a new file is moved to its
+// name, never while it is still being written. Events are read without
+// blocking, so the watch can be polled between operator commands.
+class FileWatch {
+public:
+    FileWatch() = default;
+    ~FileWatch();
+
+    FileWatch(const FileWatch&) = delete;
+    FileWatch& operator=(const FileWatch&) = delete;
+
+    // Starts watching files.
+    //
+    // Args:
+    //   directory: The directory holding the files.
+    //   names: The names of the files to report.
+    //
+    // Returns:
+    //   true if the watch is set up, false otherwise.
+    bool Open(const std::string& directory, const std::vector<std::string>& names);
+
+    void Close();
+
+    bool IsOpen() const;
+
+    // Returns the watched files that changed since the last call, without
+    // waiting for changes.
+    std::set<std::string> Changed();
+
+private:
+    int fd = -1;
+    std::vector<std::string> names;
+};
+
+#endif
@@ -0,0 +1,33 @@
+#include "invalid_records.h"
+
+namespace {
+
+// Filter names, in bit order.
+const char* const kProblemNames[kRecordProblemCount] = {
+  "missing", "candidate-id", "duplicate-id", "name", "symbol",
+  "duplicate-symbol", "region", "aadhar", "duplicate-aadhar", "status",
+};
+
+}  // namespace
+
+// Returns the filter name of a single problem bit, such as "duplicate-aadhar".
+const char* RecordProblemName(unsigned problem)
+{
+  for (size_t bit = 0; bit < kRecordProblemCount; bit++) {
+    if (problem == (1u << bit)) {
+      return kProblemNames[bit];
+    }
+  }
+  return "";
+}
+
+// Returns the problem bit with a filter name, or 0 if there is none.
+unsigned ParseRecordProblem(const std::string& name)
+{
+  for (size_t bit = 0; bit < kRecordProblemCount; bit++) {
+    if (name == kProblemNames[bit]) {
+      return 1u << bit;
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,213 @@
+#ifndef INVALID_RECORDS
+#define INVALID_RECORDS
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Why a candidate or voter row could not be accepted. A record carries a mask
+// of every problem found, so it can be listed under each of them.
+enum RecordProblem : unsigned {
+    kMissingField = 1 << 0,
+    kBadCandidateID = 1 << 1,
+    kDuplicateCandidateID = 1 << 2,
+    kBadName = 1 << 3,
+    kBadSymbol = 1 << 4,
+    kDuplicateSymbol = 1 << 5,
+    kBadRegion = 1 << 6,
+    kBadAadhar = 1 << 7,
+    kDuplicateAadhar = 1 << 8,
+    kBadStatus = 1 << 9,
+};
+
+const size_t kRecordProblemCount = 10;
+
+// Returns the filter name of a single problem bit, such as "duplicate-aadhar".
+const char* RecordProblemName(unsigned problem);
+
+// Returns the problem bit with a filter name, or 0 if there is none.
+unsigned ParseRecordProblem(const std::string& name);
+
+
+// Rows that failed validation, kept for the operator to repair.
+//
+// Every record gets an ID that stays valid until the record is removed, so the
+// operator can pick records by ID from any page. Records live in a vector
+// indexed by ID; removing one only clears its slot. Each problem keeps the IDs
+// of its records in ascending order, so a filtered page is found without
+// looking at records of other problems, and problem counts are kept up to date.
+// The ID lists drop removed IDs once they make up half of them.
+template <typename Record>
+class InvalidRecords {
+public:
+    using ID = size_t;
+
+    // Adds a record.
+    //
+    // Args:
+    //   record: The row as read or entered.
+    //   problems: The RecordProblem bits the row fails on.
+    //
+    // Returns:
+    //   The record's ID.
+    ID Add(Record record, unsigned problems)
+    {
+        ID id = entries.size();
+        entries.push_back(Entry{std::move(record), problems});
+        all.push_back(id);
+        for (size_t bit = 0; bit < kRecordProblemCount; bit++) {
+            if (problems & (1u << bit)) {
+                byProblem[bit].push_back(id);
+                counts[bit]++;
+            }
+        }
+        live++;
+        return id;
+    }
+
+    // Removes a record in constant amortized time.
+    //
+    // Returns:
+    //   true if the record was removed, false if there is no such record.
+    bool Remove(ID id)
+    {
+        if (id >= entries.size() || !entries[id].record) {
+            return false;
+        }
+        Entry& entry = entries[id];
+        for (size_t bit = 0; bit < kRecordProblemCount; bit++) {
+            counts[bit] -= (entry.problems >> bit) & 1;
+        }
+        entry.record.reset();
+        entry.problems = 0;
+        live--;
+        if (++removed > live) {
+            Compact();
+        }
+        return true;
+    }
+
+    // Returns a record, or nullptr if there is no record with the ID.
+    const Record* Find(ID id) const
+    {
+        return (id < entries.size() && entries[id].record) ? &*entries[id].record : nullptr;
+    }
+
+    // Returns the problems of a record, or 0 if there is no record with the ID.
+    unsigned Problems(ID id) const
+    {
+        return (id < entries.size() && entries[id].record) ? entries[id].problems : 0;
+    }
+
+    size_t Size() const { return live; }
+    bool Empty() const { return live == 0; }
+
+    // Returns the number of records with a single problem bit.
+    size_t Count(unsigned problem) const
+    {
+        for (size_t bit = 0; bit < kRecordProblemCount; bit++) {
+            if (problem == (1u << bit)) {
+                return counts[bit];
+            }
+        }
+        return 0;
+    }
+
+    // Returns the count of each problem that occurs, such as "aadhar: 3, status: 1".
+    std::string Summary() const
+    {
+        std::string summary;
+        for (size_t bit = 0; bit < kRecordProblemCount; bit++) {
+            if (counts[bit] > 0) {
+                summary += (summary.empty() ? "" : ", ") + std::string(RecordProblemName(1u << bit)) + ": " +
+                           std::to_string(counts[bit]);
+            }
+        }
+        return summary;
+    }
+
+    // Returns the number of records listed under a filter.
+    //
+    // Args:
+    //   problem: A single problem bit, or 0 for all records.
+    size_t FilteredSize(unsigned problem) const
+    {
+        return problem == 0 ? live : Count(problem);
+    }
+
+    // Returns one page of record IDs in ascending order.
+    //
+    // Args:
+    //   problem: A single problem bit to list, or 0 for all records.
+    //   page: The 1-based page.
+    //   pageSize: The number of records per page.
+    std::vector<ID> Page(unsigned problem, size_t page, size_t pageSize) const
+    {
+        const std::vector<ID>* ids = &all;
+        for (size_t bit = 0; bit < kRecordProblemCount; bit++) {
+            if (problem == (1u << bit)) {
+                ids = &byProblem[bit];
+            }
+        }
+
+        std::vector<ID> result;
+        size_t skip = (page > 0 ? page - 1 : 0) * pageSize;
+        for (ID id : *ids) {
+            if (!entries[id].record) {
+                continue;
+            }
+            if (skip > 0) {
+                skip--;
+                continue;
+            }
+            if (result.size() == pageSize) {
+                break;
+            }
+            result.push_back(id);
+        }
+        return result;
+    }
+
+    // Returns the IDs of all records, in ascending order.
+    std::vector<ID> IDs() const
+    {
+        return Page(0, 1, live);
+    }
+
+private:
+    struct Entry {
+        std::optional<Record> record;  // Empty once removed.
+        unsigned problems;
+    };
+
+    // Drops removed IDs from the ID lists.
+    void Compact()
+    {
+        auto drop = [this](std::vector<ID>& ids) {
+            size_t kept = 0;
+            for (ID id : ids) {
+                if (entries[id].record) {
+                    ids[kept++] = id;
+                }
+            }
+            ids.resize(kept);
+        };
+        drop(all);
+        for (std::vector<ID>& ids : byProblem) {
+            drop(ids);
+        }
+        removed = 0;
+    }
+
+    std::vector<Entry> entries;  // Indexed by ID.
+    std::vector<ID> all;
+    std::vector<ID> byProblem[kRecordProblemCount];
+    size_t counts[kRecordProblemCount] = {};
+    size_t live = 0;
+    size_t removed = 0;  // Removed IDs still in the ID lists.
+};
+
+#endif
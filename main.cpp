@@ -1,182 +1,781 @@
 #include "election.h"
-// Main function that drives the Election Management System.
-int main()
+#include "election_manager.h"
+
+#include <cstring>   // C++ standard library header
+#include <cstdlib>   // C++ standard library header
+#include <chrono>    // C++ standard library header
+
+// Returns the value of a "--name=value" option, or nullptr if arg is not that option.
+const char* OptionValue(const char* arg, const char* name)
 {
+  size_t length = std::strlen(name);
+  if (std::strncmp(arg, name, length) == 0 && arg[length] == '=')
+  {
+    return arg + length + 1;
+  }
+  return nullptr;
+}
 
- // Create an instance of the ElectionSystem class:
- ElectionSystem e;
+// Runs one operator session of the menu on the system's console, until the
+// operator exits or the input ends.
+//
+// Args:
+//   e: The election system to operate.
+//   adminOption: Whether the admin menu is available.
+void RunSession(ElectionSystem& e, bool adminOption)
+{
+ try
+ {
+   bool software = true;
 
- // Check for necessary files and data: 
- bool adminOption = e.AdminCsvCheck() || true;
- bool candidateCast = e.CandidateCsvCheck();
- bool voterCast = e.VoterCsvCheck();
- bool castOption = candidateCast & voterCast;
- bool software = true;
-
-
- while(software)
- {
-   // Display main menu:
-   std::cout << "Welcome to the Election Management System!" << std::endl;
-   std::cout << "Choose an option:\n";
-   std::cout << "1. Enter as Admin\n";
-   std::cout << "2. Cast Vote\n";
-   std::cout << "3. Show Results\n";
-   std::cout << "4. View Individual Results\n";
-   std::cout << "5. Exit\n";
-   int choice {e.GetChoice()};
-
-   switch(choice)
-   {
-
-     case 1:
-     { 
-       //Check for Admin Option
-       if(adminOption)
-       {
-         //Check Admin Credentials
-         bool adminAuthenticate = e.GetAdminAuthenicate();
-         while (adminAuthenticate) 
+   while(software)
+   {
+     // Keep the result feed fresh, the standby current and the checkpoints
+     // going between commands:
+     e.RefreshResultFeed(false);
+     e.ShipReplicaChanges();
+     e.CheckpointIfDue();
+
+     // Display main menu:
+     e.Out() << "Welcome to the Election Management System!" << '\n';
+     e.Out() << "Choose an option:\n";
+     e.Out() << "1. Enter as Admin\n";
+     e.Out() << "2. Cast Vote\n";
+     e.Out() << "3. Show Results\n";
+     e.Out() << "4. View Individual Results\n";
+     e.Out() << "5. Exit\n";
+     int choice {e.GetChoice()};
+
+     // Run the command on the data files as they are now:
+     e.ReloadChangedFiles();
+
+     switch(choice)
+     {
+
+       case 1:
+       { 
+         //Check for Admin Option
+         if(adminOption)
          {
-            // Admin options:
-            std::cout << "Admin Options:\n";
-            std::cout << "1. Candidate Registration\n";
-            std::cout << "2. Fill missing informations of candidates\n";
-            std::cout << "3. Modify Candidate Details\n";
-            std::cout << "4. Remove Candidate\n";
-            std::cout << "5. Add Voter\n";
-            std::cout << "6. Fill missing informations of voters\n";
-            std::cout << "7. Modify Voter Details\n";
-            std::cout << "8. Remove Voter\n";
-            std::cout << "9. Back to Main Menu\n";
-            int adminChoice {e.GetChoice() };
-            switch(adminChoice)
-            {
-              case 1: 
-              {
-                std::cout << "Register Candidate \n" ; 
-                e.AddCandidate();
-                break;
-              }
-              case 2: 
-              {
-                std::cout << "Fill Missing Candidate \n" ;
-                e.FillMissingCandidateInfo();
-                break;
-              }
-              case 3: 
-              {
-                std::cout << "Modify  Candidate \n";
-                e.ModifyCandidate();
-                break;
-              }
-              case 4: 
-              {
-                std:: cout << "Remove Candidate \n";
-                e.RemoveCandidate();
-                break;
-              }
-              case 5: 
-              {
-                std::cout << "Add Voter \n";
-                e.AddVoter();
-                break;
-              }
-              case 6:
-              {
-                std::cout << "Fill Missing Voter \n" ;
-                e.FillMissingVoterInfo();
-                break;
-              }
-              case 7: 
-              {
-                std::cout << "Modify Voter \n";
-                e.ModifyVoter();
-                break;
-              }
-              case 8: 
-              {
-                std::cout << "Remove Voter \n";
-                e.RemoveVoter();  
-                break;
-              }
-              case 9: 
-              {
-                // Exit the Admin Option
-                adminAuthenticate = false;;
-                break;
-              }
-              default: 
+           //Check Admin Credentials
+           bool adminAuthenticate = e.GetAdminAuthenicate();
+           while (adminAuthenticate) 
+           {
+              e.ShipReplicaChanges();
+
+              // Admin options:
+              e.Out() << "Admin Options:\n";
+              e.Out() << "1. Candidate Registration\n";
+              e.Out() << "2. Fill missing informations of candidates\n";
+              e.Out() << "3. Modify Candidate Details\n";
+              e.Out() << "4. Remove Candidate\n";
+              e.Out() << "5. Add Voter\n";
+              e.Out() << "6. Fill missing informations of voters\n";
+              e.Out() << "7. Modify Voter Details\n";
+              e.Out() << "8. Remove Voter\n";
+              e.Out() << "9. Back to Main Menu\n";
+              int adminChoice {e.GetChoice() };
+              e.ReloadChangedFiles();
+              e.CheckpointIfDue();
+              switch(adminChoice)
               {
-                // Invalid choice:
-                std::cout << "Invalid choice. Please try again.\n";
-              }
+                case 1: 
+                {
+                  e.Out() << "Register Candidate \n" ; 
+                  e.AddCandidate();
+                  break;
+                }
+                case 2: 
+                {
+                  e.Out() << "Fill Missing Candidate \n" ;
+                  e.FillMissingCandidateInfo();
+                  break;
+                }
+                case 3: 
+                {
+                  e.Out() << "Modify  Candidate \n";
+                  e.ModifyCandidate();
+                  break;
+                }
+                case 4: 
+                {
+                  e.Out() << "Remove Candidate \n";
+                  e.RemoveCandidate();
+                  break;
+                }
+                case 5: 
+                {
+                  e.Out() << "Add Voter \n";
+                  e.AddVoter();
+                  break;
+                }
+                case 6:
+                {
+                  e.Out() << "Fill Missing Voter \n" ;
+                  e.FillMissingVoterInfo();
+                  break;
+                }
+                case 7: 
+                {
+                  e.Out() << "Modify Voter \n";
+                  e.ModifyVoter();
+                  break;
+                }
+                case 8: 
+                {
+                  e.Out() << "Remove Voter \n";
+                  e.RemoveVoter();  
+                  break;
+                }
+                case 9: 
+                {
+                  // Exit the Admin Option
+                  adminAuthenticate = false;;
+                  break;
+                }
+                default: 
+                {
+                  // Invalid choice:
+                  e.Out() << "Invalid choice. Please try again.\n";
+                }
+             }
            }
-         }
+        }
+         else
+         e.Out() << "There is no Admin to access Admin Option\n";
+         break;
       }
-       else
-       std::cout << "There is no Admin to access Admin Option\n";
-       break;
-    }
-    case 2:
-    { 
-      // Check to Cast vote 
-      if(e.checkCast())
-      {
-      std::cout << "Cast Vote \n";
-      // Cast Vote
-      e.CastVote();  
+      case 2:
+      { 
+        // Check to Cast vote 
+        if(e.checkCast())
+        {
+        e.Out() << "Cast Vote \n";
+        // Cast Vote
+        e.CastVote();  
+        }
+        else
+        {
+          e.Out() << "There is no Candidate or Voter to Cast Vote \n";
+        }
+        break;
       }
-      else
-      {
-        std::cout << "There is no Candidate or Voter to Cast Vote \n";
-      }
-      break;
-    }
     
-    case 3:
-    {
-      // Check to Show results
-      if(e.checkCandidate())
+      case 3:
       {
-      std::cout << "Show Result \n";
-      // Show Results
-      e.ShowResult();
+        // Check to Show results
+        if(e.checkCandidate())
+        {
+        e.Out() << "Show Result \n";
+        // Show Results
+        e.ShowResult();
+        }
+        else
+        {
+          e.Out() << "There is no Candidate to Show Result \n";
+        }
+        break;
       }
-      else
-      {
-        std::cout << "There is no Candidate to Show Result \n";
-      }
-      break;
-    }
-    case 4:
-    { 
-      // Check to Show Individual Results
-      if(e.checkCandidate())
+      case 4:
+      { 
+        // Check to Show Individual Results
+        if(e.checkCandidate())
+        {
+        e.Out() << "Individual Result \n";
+        // View individual results:
+        e.IndividualResult();
+        }
+        else
+        {
+          e.Out() << "There is no Candidate to Individual Result \n";
+        }
+      
+        break;
+      } 
+      case 5:
       {
-      std::cout << "Individual Result \n";
-      // View individual results:
-      e.IndividualResult();
+        // Exit the program:
+        software = false;;
+        break;
       }
-      else
+      default:
       {
-        std::cout << "There is no Candidate to Individual Result \n";
+        // Invalid choice:
+        e.Out() << "Invalid choice. Please try again.\n";
       }
-      
-      break;
-    } 
-    case 5:
-    {
-      // Exit the program:
-      software = false;;
-      break;
-    }
-    default:
-    {
-      // Invalid choice:
-      std::cout << "Invalid choice. Please try again.\n";
     }
-  }
+   }
+ }
+ catch (const EndOfInput&)
+ {
+   // The operator input ended, the session is over.
+ }
+}
+
+// Replays a recorded operator script, for benchmarking and regression testing
+// of the full command path.
+//
+// Args:
+//   e: The election system to operate.
+//   adminOption: Whether the admin menu is available.
+//   path: The script file, holding the operator input of one session.
+//   repeat: The number of sessions to replay.
+//   quiet: Whether to discard the console output.
+//
+// Returns:
+//   The process exit status.
+int ReplaySessions(ElectionSystem& e, bool adminOption, const char* path, long repeat, bool quiet)
+{
+ std::ifstream scriptFile(path);
+ if (!scriptFile.is_open())
+ {
+   std::cerr << "Error opening the replay script " << path << '\n';
+   return 1;
+ }
+ std::stringstream content;
+ content << scriptFile.rdbuf();
+ const std::string script = content.str();
+
+ // A stream without a buffer drops everything written to it:
+ std::ostream discard(nullptr);
+ auto start = std::chrono::steady_clock::now();
+ for (long i = 0; i < repeat; i++)
+ {
+   std::istringstream input(script);
+   e.SetConsole(input, quiet ? discard : std::cout, quiet ? discard : std::cerr);
+   RunSession(e, adminOption);
+ }
+ double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+ e.SetConsole(std::cin, std::cout, std::cerr);
+
+ std::cerr << "Replayed " << repeat << " sessions in " << seconds << " s ("
+           << repeat / std::max(seconds, 1e-9) << " sessions/s)\n";
+ return 0;
+}
+
+// Lets the operator pick elections hosted by a manager and runs a session on
+// each, until the input ends or the operator exits.
+//
+// Args:
+//   manager: The manager hosting the elections.
+//
+// Returns:
+//   The process exit status.
+int RunElections(ElectionManager& manager)
+{
+ while (true)
+ {
+   std::cout << "Elections:\n";
+   for (const std::string& id : manager.ElectionIDs())
+   {
+     std::cout << " " << id << (manager.IsLoaded(id) ? " (loaded)" : "") << '\n';
+   }
+   std::cout << "Enter Election ID (exit to quit): ";
+   std::string electionID;
+   if (!(std::cin >> electionID) || electionID == "exit")
+   {
+     return 0;
+   }
+
+   ElectionSystem* e = manager.Open(electionID);
+   if (e == nullptr)
+   {
+     std::cout << "Election " << electionID << " not found\n";
+     continue;
+   }
+   RunSession(*e, true);
+   if (std::cin.eof())
+   {
+     return 0;
+   }
+ }
+}
+
+// Merges the tallies district elections report to a socket, printing the
+// national and regional totals whenever they change, until the process is
+// stopped.
+//
+// Args:
+//   socketPath: The socket the districts report to.
+//   feedPath: A result feed to rewrite with the merged totals, or nullptr.
+//   format: The encoding of the feed.
+//   grouping: How vote counts are grouped in the feed.
+//
+// Returns:
+//   The process exit status.
+int RunAggregator(const char* socketPath, const char* feedPath, ExportFormat format, ExportGrouping grouping)
+{
+ TallyAggregator aggregator;
+ if (!aggregator.Open(socketPath))
+ {
+   std::cerr << "Error binding the aggregator socket " << socketPath << '\n';
+   return 1;
+ }
+ std::cout << "Aggregating the tallies reported to " << socketPath << '\n';
+
+ // Show at most five views a second, however fast reports arrive:
+ const auto showInterval = std::chrono::milliseconds(200);
+ auto shown = std::chrono::steady_clock::now() - showInterval;
+ bool changed = false;
+ while (true)
+ {
+   changed = aggregator.Receive(showInterval) > 0 || changed;
+   auto now = std::chrono::steady_clock::now();
+   if (!changed || now - shown < showInterval)
+   {
+     continue;
+   }
+   shown = now;
+   changed = false;
+
+   std::cout << "National total: " << aggregator.Total() << " votes from " << aggregator.NodeCount()
+             << " districts (" << aggregator.Duplicates() << " duplicate and " << aggregator.Rejected()
+             << " rejected reports)\n";
+   TallySnapshot merged;
+   merged.turnout = aggregator.Total();
+   merged.counts = aggregator.CandidateTotals();
+   for (const auto& count : merged.counts)
+   {
+     std::cout << "  Candidate " << count.first << ": " << count.second << '\n';
+   }
+   for (const auto& count : aggregator.RegionTotals())
+   {
+     std::cout << "  Region " << count.first << ": " << count.second << '\n';
+   }
+   std::cout << std::flush;
+
+   // Readers of the feed never see a partial file:
+   if (feedPath != nullptr)
+   {
+     std::string temporary = std::string(feedPath) + ".tmp";
+     std::ofstream feed(temporary, std::ios::binary | std::ios::trunc);
+     ExportResults(feed, aggregator.CandidateList(), merged, grouping, format);
+     feed.close();
+     if (!feed || std::rename(temporary.c_str(), feedPath) != 0)
+     {
+       std::cerr << "Error writing the result feed " << feedPath << '\n';
+     }
+   }
+ }
+}
+
+// Prints the results published on a board by a running election, as a
+// result export.
+//
+// Args:
+//   name: The shared memory name of the board.
+//   format: The encoding to print.
+//   grouping: How to group the vote counts.
+//
+// Returns:
+//   The process exit status.
+int ShowBoard(const char* name, ExportFormat format, ExportGrouping grouping)
+{
+ ResultsBoardReader reader;
+ ResultsBoardView view;
+ if (!reader.Open(name) || !reader.Read(view))
+ {
+   std::cerr << "Error reading the results board " << name << '\n';
+   return 1;
+ }
+ std::vector<Candidate> candidates;
+ TallySnapshot votes;
+ votes.epoch = view.epoch;
+ votes.turnout = view.turnout;
+ for (const ResultsBoardEntry& entry : view.entries)
+ {
+   candidates.emplace_back(entry.id, entry.name, entry.symbol, entry.region, entry.votes);
+   votes.counts.emplace_back(entry.id, entry.votes);
+ }
+ ExportResults(std::cout, candidates, votes, grouping, format);
+ return 0;
+}
+
+// Main function that drives the Election Management System.
+//
+// Options:
+//   --full-rewrite: Rewrite the whole voter roll and candidate file on exit
+//                   instead of appending changes to the delta files.
+//   --in-place: Update voting statuses directly in a fixed-width Voter.csv.
+//   --sorted-roll: Keep the voter roll sorted and look voters up by interpolation search.
+//   --load-voters-on-demand: Load the voter roll on first use instead of in the background.
+//   --admin-hash-cost=S,T: Space and time cost of new admin verification records,
+//                          within CredentialRecord::kMaxSpaceCost and kMaxTimeCost.
+//   --calibrate-admin-hash=MS: Print the space cost that makes admin login take MS
+//                              milliseconds on this machine, then exit.
+//   --hash-admin-password=USER: Read a password from standard input, print the
+//                               Admin.csv row for USER, then exit.
+//   --replay=FILE: Replay the operator input recorded in FILE instead of reading
+//                  the terminal, and report the session throughput.
+//   --repeat=N: Replay the script N times.
+//   --quiet: Discard the console output of replayed sessions.
+//   --result-feed=PATH: Rewrite a result feed at PATH while the system runs.
+//   --feed-format=csv|jsonl|binary: Encoding of the result feed or export.
+//   --feed-group=candidate|region|party: Grouping of the result feed or export.
+//   --feed-interval=SECONDS: Minimum time between two feed refreshes (default 5).
+//   --export=PATH: Export the results to PATH once, then exit.
+//   --data-dir=DIR: Read and write the election's data files in DIR.
+//   --elections=ROOT: Host every election under ROOT, one data directory per
+//                     election ID, and pick them from the console.
+//   --max-loaded=N: Keep at most N hosted elections loaded (default 8).
+//   --out-of-core=MB: Keep the voter roll on disk with an MB megabyte page cache.
+//   --count=plurality|irv|stv:SEATS: How the contest is counted (default plurality).
+//   --watch: Apply edits other tools make to Candidate.csv and Voter.csv while running.
+//   --checkpoint-interval=SECONDS: Save the whole election in a forked child at
+//                                  most every SECONDS while voting goes on.
+//   --audit: Recount the vote journal, cross-check it against the stored
+//            tallies and voter roll, print every discrepancy, then exit.
+//   --replicate: Log every change to Replica.log for a standby.
+//   --standby: Follow the Replica.log of a primary on the same data directory,
+//              and take over as the primary when it dies.
+//   --backup-roll=PATH: Write the voter roll to a compressed roll archive at PATH, then exit.
+//   --restore-roll=PATH: Replace Voter.csv with the roll archive at PATH, then exit.
+//   --report-to=SOCKET: Report the tally to the aggregator listening on SOCKET.
+//   --node=NAME: The name the tally is reported under (default: the data directory).
+//   --report-interval=MS: Time between two tally reports (default 200).
+//   --results-board=NAME: Publish live results in the shared memory segment NAME.
+//   --board-interval=MS: Time between two checks for board changes (default 20).
+//   --show-board=NAME: Print the results on the board NAME, then exit.
+//   --aggregate=SOCKET: Merge the tallies reported to SOCKET into national and
+//                       regional totals, printing them and rewriting any
+//                       --result-feed as they change.
+int main(int argc, char* argv[])
+{
+
+ // Read command line options:
+ bool deltaPersistence = true;
+ bool inPlacePersistence = false;
+ bool sortedRoll = false;
+ bool backgroundVoterLoad = true;
+ uint32_t adminSpaceCost = CredentialRecord::kDefaultSpaceCost;
+ uint32_t adminTimeCost = CredentialRecord::kDefaultTimeCost;
+ const char* replayScript = nullptr;
+ long replayCount = 1;
+ bool quiet = false;
+ const char* feedPath = nullptr;
+ const char* exportPath = nullptr;
+ ExportFormat feedFormat = ExportFormat::kCsv;
+ ExportGrouping feedGrouping = ExportGrouping::kCandidate;
+ double feedInterval = 5;
+ std::string dataDirectory = ".";
+ const char* electionsRoot = nullptr;
+ size_t maxLoaded = 8;
+ size_t outOfCoreMB = 0;
+ CountMethod countMethod = CountMethod::kPlurality;
+ size_t countSeats = 1;
+ bool audit = false;
+ bool hotReload = false;
+ double checkpointInterval = 0;
+ bool replicate = false;
+ bool standby = false;
+ const char* backupPath = nullptr;
+ const char* restorePath = nullptr;
+ const char* reportSocket = nullptr;
+ std::string reportNode;
+ long reportInterval = 200;
+ const char* aggregateSocket = nullptr;
+ const char* boardName = nullptr;
+ long boardInterval = 20;
+ const char* showBoardName = nullptr;
+ for (int i = 1; i < argc; i++)
+ {
+   if (std::strcmp(argv[i], "--full-rewrite") == 0)
+   {
+     deltaPersistence = false;
+   }
+   else if (std::strcmp(argv[i], "--in-place") == 0)
+   {
+     inPlacePersistence = true;
+   }
+   else if (std::strcmp(argv[i], "--sorted-roll") == 0)
+   {
+     sortedRoll = true;
+   }
+   else if (std::strcmp(argv[i], "--load-voters-on-demand") == 0)
+   {
+     backgroundVoterLoad = false;
+   }
+   else if (const char* cost = OptionValue(argv[i], "--admin-hash-cost"))
+   {
+     unsigned long spaceCost = 0, timeCost = 0;
+     if (std::sscanf(cost, "%lu,%lu", &spaceCost, &timeCost) != 2 || spaceCost == 0 || timeCost == 0 ||
+         spaceCost > CredentialRecord::kMaxSpaceCost || timeCost > CredentialRecord::kMaxTimeCost)
+     {
+       std::cerr << "Invalid admin hash cost " << cost << '\n';
+       return 1;
+     }
+     adminSpaceCost = spaceCost;
+     adminTimeCost = timeCost;
+   }
+   else if (const char* target = OptionValue(argv[i], "--calibrate-admin-hash"))
+   {
+     double measuredMs = 0;
+     uint32_t spaceCost = CalibrateSpaceCost(std::atof(target), adminTimeCost, measuredMs);
+     std::cout << "Space cost " << spaceCost << " blocks (" << spaceCost * 32 / 1024 << " KiB), time cost "
+               << adminTimeCost << ": " << measuredMs << " ms per login\n";
+     std::cout << "Use --admin-hash-cost=" << spaceCost << "," << adminTimeCost << '\n';
+     return 0;
+   }
+   else if (const char* username = OptionValue(argv[i], "--hash-admin-password"))
+   {
+     std::string password;
+     std::getline(std::cin, password);
+     std::cout << username << "," << CredentialRecord::Create(password, adminSpaceCost, adminTimeCost).ToString() << '\n';
+     return 0;
+   }
+   else if (const char* script = OptionValue(argv[i], "--replay"))
+   {
+     replayScript = script;
+   }
+   else if (const char* count = OptionValue(argv[i], "--repeat"))
+   {
+     replayCount = std::atol(count);
+   }
+   else if (std::strcmp(argv[i], "--quiet") == 0)
+   {
+     quiet = true;
+   }
+   else if (const char* path = OptionValue(argv[i], "--result-feed"))
+   {
+     feedPath = path;
+   }
+   else if (const char* path = OptionValue(argv[i], "--export"))
+   {
+     exportPath = path;
+   }
+   else if (const char* format = OptionValue(argv[i], "--feed-format"))
+   {
+     if (!ParseExportFormat(format, feedFormat))
+     {
+       std::cerr << "Unknown feed format " << format << '\n';
+       return 1;
+     }
+   }
+   else if (const char* group = OptionValue(argv[i], "--feed-group"))
+   {
+     if (!ParseExportGrouping(group, feedGrouping))
+     {
+       std::cerr << "Unknown feed grouping " << group << '\n';
+       return 1;
+     }
+   }
+   else if (const char* interval = OptionValue(argv[i], "--feed-interval"))
+   {
+     feedInterval = std::atof(interval);
+   }
+   else if (const char* directory = OptionValue(argv[i], "--data-dir"))
+   {
+     dataDirectory = directory;
+   }
+   else if (const char* root = OptionValue(argv[i], "--elections"))
+   {
+     electionsRoot = root;
+   }
+   else if (const char* count = OptionValue(argv[i], "--max-loaded"))
+   {
+     maxLoaded = std::strtoul(count, nullptr, 10);
+   }
+   else if (const char* size = OptionValue(argv[i], "--out-of-core"))
+   {
+     outOfCoreMB = std::strtoul(size, nullptr, 10);
+   }
+   else if (const char* method = OptionValue(argv[i], "--count"))
+   {
+     if (!ParseCountMethod(method, countMethod, countSeats))
+     {
+       std::cerr << "Unknown count method " << method << '\n';
+       return 1;
+     }
+   }
+   else if (std::strcmp(argv[i], "--watch") == 0)
+   {
+     hotReload = true;
+   }
+   else if (const char* interval = OptionValue(argv[i], "--checkpoint-interval"))
+   {
+     checkpointInterval = std::atof(interval);
+   }
+   else if (std::strcmp(argv[i], "--audit") == 0)
+   {
+     audit = true;
+   }
+   else if (std::strcmp(argv[i], "--replicate") == 0)
+   {
+     replicate = true;
+   }
+   else if (std::strcmp(argv[i], "--standby") == 0)
+   {
+     standby = true;
+   }
+   else if (const char* path = OptionValue(argv[i], "--backup-roll"))
+   {
+     backupPath = path;
+   }
+   else if (const char* path = OptionValue(argv[i], "--restore-roll"))
+   {
+     restorePath = path;
+   }
+   else if (const char* path = OptionValue(argv[i], "--report-to"))
+   {
+     reportSocket = path;
+   }
+   else if (const char* name = OptionValue(argv[i], "--node"))
+   {
+     reportNode = name;
+   }
+   else if (const char* interval = OptionValue(argv[i], "--report-interval"))
+   {
+     reportInterval = std::strtol(interval, nullptr, 10);
+   }
+   else if (const char* path = OptionValue(argv[i], "--aggregate"))
+   {
+     aggregateSocket = path;
+   }
+   else if (const char* name = OptionValue(argv[i], "--results-board"))
+   {
+     boardName = name;
+   }
+   else if (const char* interval = OptionValue(argv[i], "--board-interval"))
+   {
+     boardInterval = std::strtol(interval, nullptr, 10);
+   }
+   else if (const char* name = OptionValue(argv[i], "--show-board"))
+   {
+     showBoardName = name;
+   }
+   else
+   {
+     std::cerr << "Unknown option " << argv[i] << '\n';
+     return 1;
+   }
+ }
+
+ // The aggregator runs no election of its own:
+ if (aggregateSocket != nullptr)
+ {
+   return RunAggregator(aggregateSocket, feedPath, feedFormat, feedGrouping);
+ }
+ if (showBoardName != nullptr)
+ {
+   return ShowBoard(showBoardName, feedFormat, feedGrouping);
  }
+ if (reportInterval <= 0 || boardInterval <= 0)
+ {
+   std::cerr << "--report-interval and --board-interval must be positive numbers of milliseconds\n";
+   return 1;
+ }
+
+ // The standby keeps its copy of the roll in memory and writes nothing:
+ if (standby && (inPlacePersistence || outOfCoreMB > 0 || hotReload))
+ {
+   std::cerr << "--standby cannot be used with --in-place, --out-of-core or --watch\n";
+   return 1;
+ }
+
+ // Options every election is created with:
+ auto configure = [&](ElectionSystem& election) {
+   election.SetDeltaPersistence(deltaPersistence);
+   election.SetInPlacePersistence(inPlacePersistence);
+   election.SetSortedRoll(sortedRoll);
+   election.SetAdminHashCost(adminSpaceCost, adminTimeCost);
+   election.SetOutOfCore(outOfCoreMB << 20);
+   election.SetCountMethod(countMethod, countSeats);
+   election.SetHotReload(hotReload);
+   election.SetCheckpointInterval(checkpointInterval);
+   election.SetReplication(replicate);
+   if (reportSocket != nullptr)
+   {
+     election.SetTallyReport(reportSocket, reportNode, std::chrono::milliseconds(reportInterval));
+   }
+   if (boardName != nullptr)
+   {
+     election.SetResultsBoard(boardName, std::chrono::milliseconds(boardInterval));
+   }
+ };
+
+ // Host many elections, each with its own result feed in its data directory:
+ if (electionsRoot != nullptr)
+ {
+   if (exportPath != nullptr || replayScript != nullptr || audit || backupPath != nullptr || restorePath != nullptr ||
+       standby || !reportNode.empty() || boardName != nullptr)
+   {
+     std::cerr << "--export, --replay, --audit, --backup-roll, --restore-roll, --standby, --node and --results-board "
+                  "need a single election\n";
+     return 1;
+   }
+   ElectionManager manager(electionsRoot, maxLoaded, backgroundVoterLoad, [&](ElectionSystem& election) {
+     configure(election);
+     if (feedPath != nullptr)
+     {
+       election.SetResultFeed(election.DataPath(feedPath), feedFormat, feedGrouping, feedInterval);
+     }
+   });
+   return RunElections(manager);
+ }
+
+ // Create an instance of the ElectionSystem class:
+ ElectionSystem e(dataDirectory);
+ configure(e);
+
+ // The standby looks up a voter for every voter record it applies:
+ if (standby)
+ {
+   e.SetSortedRoll(true);
+ }
+
+ // A restore replaces the voter file before anything reads it:
+ if (restorePath != nullptr)
+ {
+   return e.RestoreVoterRoll(restorePath) ? 0 : 1;
+ }
+ e.WatchDataFiles();
+
+ // The voter roll is only needed for voting and voter administration,
+ // so it loads alongside the rest of the startup:
+ if (backgroundVoterLoad)
+ {
+   e.StartVoterRollLoad();
+ }
+
+ // Check for necessary files and data: 
+ bool adminOption = e.AdminCsvCheck() || true;
+ e.CandidateCsvCheck();
+ e.BallotCsvCheck();
+
+ // Results only need the candidate table:
+ if (exportPath != nullptr)
+ {
+   return e.ExportResultsTo(exportPath, feedFormat, feedGrouping) ? 0 : 1;
+ }
+
+ // The audit reads the journal as it is, without starting one:
+ if (audit)
+ {
+   return e.AuditVotes() ? 0 : 1;
+ }
+ if (backupPath != nullptr)
+ {
+   return e.BackupVoterRoll(backupPath) ? 0 : 1;
+ }
+ // Follow the primary until it dies, then carry on as the primary:
+ if (standby && !e.RunStandby())
+ {
+   return 1;
+ }
+ e.VoteJournalCheck();
+ e.StartReplicaLog();
+ e.StartTallyReport();
+ e.StartResultsBoard();
+ if (feedPath != nullptr)
+ {
+   e.SetResultFeed(feedPath, feedFormat, feedGrouping, feedInterval);
+ }
+
+ if (replayScript != nullptr)
+ {
+   return ReplaySessions(e, adminOption, replayScript, replayCount, quiet);
+ }
+
+ RunSession(e, adminOption);
  return 0;
 }
@@ -0,0 +1,300 @@
+#include "ranked_ballots.h"
+#include "field_parser.h"
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
+
+// Parses a count option value: "plurality", "irv" or "stv:SEATS".
+bool ParseCountMethod(const std::string& text, CountMethod& method, size_t& seats)
+{
+  int64_t parsed = 1;
+  if (text == "plurality") method = CountMethod::kPlurality;
+  else if (text == "irv") method = CountMethod::kInstantRunoff;
+  else if (text.compare(0, 4, "stv:") == 0 && ParseCount(std::string_view(text).substr(4), parsed) && parsed > 0)
+    method = CountMethod::kSingleTransferable;
+  else return false;
+  seats = static_cast<size_t>(parsed);
+  return true;
+}
+
+// Adds a ballot.
+bool BallotStore::Add(const std::vector<std::string>& ranking)
+{
+  if (ranking.empty() || preferences.size() + ranking.size() > std::numeric_limits<uint32_t>::max())
+  {
+    return false;
+  }
+
+  size_t start = preferences.size();
+  for (const std::string& candidateID : ranking)
+  {
+    auto it = indices.find(candidateID);
+    if (it == indices.end())
+    {
+      if (candidates.size() > std::numeric_limits<Index>::max())
+      {
+        preferences.resize(start);
+        return false;
+      }
+      it = indices.emplace(candidateID, static_cast<Index>(candidates.size())).first;
+      candidates.push_back(candidateID);
+    }
+    // Reject a ballot that ranks a candidate twice:
+    if (std::find(preferences.begin() + start, preferences.end(), it->second) != preferences.end())
+    {
+      preferences.resize(start);
+      return false;
+    }
+    preferences.push_back(it->second);
+  }
+  rowEnds.push_back(static_cast<uint32_t>(preferences.size()));
+  return true;
+}
+
+size_t BallotStore::Size() const
+{
+  return rowEnds.size();
+}
+
+const std::string& BallotStore::CandidateID(Index index) const
+{
+  return candidates[index];
+}
+
+// Returns the dense index of a candidate, or -1 if no ballot ranks it.
+long BallotStore::Find(const std::string& candidateID) const
+{
+  auto it = indices.find(candidateID);
+  return it == indices.end() ? -1 : it->second;
+}
+
+size_t BallotStore::CandidateCount() const
+{
+  return candidates.size();
+}
+
+// Returns the preferences of a ballot.
+const BallotStore::Index* BallotStore::Row(size_t ballot, size_t& length) const
+{
+  size_t start = ballot == 0 ? 0 : rowEnds[ballot - 1];
+  length = rowEnds[ballot] - start;
+  return preferences.data() + start;
+}
+
+// Reads ballots from a file with one ballot per line.
+size_t BallotStore::Load(const std::string& path)
+{
+  std::ifstream inputFile(path);
+  size_t rejected = 0;
+  std::string line;
+  std::vector<std::string> ranking;
+  while (std::getline(inputFile, line))
+  {
+    CsvFields fields(line);
+    std::string_view candidateID;
+    ranking.clear();
+    while (fields.Next(candidateID))
+    {
+      ranking.emplace_back(candidateID);
+    }
+    rejected += !Add(ranking);
+  }
+  return rejected;
+}
+
+// Appends ballots to a ballot file.
+bool BallotStore::Append(const std::string& path, size_t first) const
+{
+  if (first >= Size())
+  {
+    return true;
+  }
+  std::ofstream outputFile(path, std::ios::app);
+  for (size_t ballot = first; ballot < Size(); ballot++)
+  {
+    size_t length = 0;
+    const Index* row = Row(ballot, length);
+    for (size_t i = 0; i < length; i++)
+    {
+      outputFile << (i == 0 ? "" : ",") << candidates[row[i]];
+    }
+    outputFile << '\n';
+  }
+  return static_cast<bool>(outputFile);
+}
+
+namespace {
+
+enum class Standing : uint8_t { kContinuing, kElected, kExcluded };
+
+// A candidate during a count, with the ballots currently counting for them.
+struct Contestant {
+  std::string id;
+  Standing standing = Standing::kContinuing;
+  int64_t tally = 0;
+  int64_t firstPreferences = 0;
+  std::vector<uint32_t> pile;
+};
+
+}  // namespace
+
+// Formats a vote value in kVoteScale units.
+std::string FormatVoteValue(int64_t value)
+{
+  const int64_t unit = CountResult::kVoteScale;
+  std::string text = std::to_string(value / unit);
+  int64_t hundredths = value % unit * 100 / unit;
+  if (value % unit != 0)
+  {
+    text += (hundredths < 10 ? ".0" : ".") + std::to_string(hundredths);
+  }
+  return text;
+}
+
+// Counts ranked ballots.
+CountResult CountRankedBallots(const BallotStore& ballots, const std::vector<std::string>& candidates,
+                               CountMethod method, size_t seats)
+{
+  const int64_t unit = CountResult::kVoteScale;
+  if (method != CountMethod::kSingleTransferable)
+  {
+    seats = 1;
+  }
+
+  // Candidates standing, and the standing candidate of each store index:
+  std::vector<Contestant> contestants(candidates.size());
+  std::vector<long> contestantOf(ballots.CandidateCount(), -1);
+  for (size_t i = 0; i < candidates.size(); i++)
+  {
+    contestants[i].id = candidates[i];
+    long index = ballots.Find(candidates[i]);
+    if (index >= 0)
+    {
+      contestantOf[index] = static_cast<long>(i);
+    }
+  }
+
+  // Per ballot: the preference it counts for and its weight in vote units.
+  std::vector<uint16_t> cursor(ballots.Size(), 0);
+  std::vector<uint32_t> weight(ballots.Size(), static_cast<uint32_t>(unit));
+  int64_t exhausted = 0;
+
+  // Moves a ballot to its first continuing preference from its cursor on.
+  auto place = [&](uint32_t ballot) {
+    size_t length = 0;
+    const BallotStore::Index* row = ballots.Row(ballot, length);
+    for (; cursor[ballot] < length; cursor[ballot]++)
+    {
+      long to = contestantOf[row[cursor[ballot]]];
+      if (to >= 0 && contestants[to].standing == Standing::kContinuing)
+      {
+        contestants[to].pile.push_back(ballot);
+        contestants[to].tally += weight[ballot];
+        return;
+      }
+    }
+    exhausted += weight[ballot];
+  };
+
+  // Moves the ballots of an elected or excluded candidate on, at a weight of
+  // numerator / denominator of their current weight.
+  auto transfer = [&](Contestant& from, int64_t numerator, int64_t denominator) {
+    std::vector<uint32_t> pile;
+    pile.swap(from.pile);
+    from.tally = 0;
+    for (uint32_t ballot : pile)
+    {
+      weight[ballot] = static_cast<uint32_t>(weight[ballot] * numerator / denominator);
+      cursor[ballot]++;
+      place(ballot);
+    }
+  };
+
+  for (uint32_t ballot = 0; ballot < ballots.Size(); ballot++)
+  {
+    place(ballot);
+  }
+  int64_t valid = 0;
+  for (Contestant& contestant : contestants)
+  {
+    contestant.firstPreferences = contestant.tally;
+    valid += contestant.tally;
+  }
+
+  CountResult result;
+  result.quota = (valid / unit / static_cast<int64_t>(seats + 1) + 1) * unit;  // Droop quota.
+  size_t continuing = contestants.size();
+  while (result.winners.size() < seats && continuing > 0)
+  {
+    // Record the standings at the start of the round:
+    CountRound round;
+    round.exhausted = exhausted;
+    int64_t continuingTotal = 0;
+    std::vector<size_t> order;
+    for (size_t i = 0; i < contestants.size(); i++)
+    {
+      if (contestants[i].standing == Standing::kContinuing)
+      {
+        order.push_back(i);
+        continuingTotal += contestants[i].tally;
+      }
+    }
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+      return contestants[a].tally > contestants[b].tally;
+    });
+    for (size_t i : order)
+    {
+      round.tallies.emplace_back(contestants[i].id, contestants[i].tally);
+    }
+
+    // The continuing candidates fill the remaining seats:
+    if (continuing <= seats - result.winners.size())
+    {
+      for (size_t i : order)
+      {
+        contestants[i].standing = Standing::kElected;
+        round.elected.push_back(contestants[i].id);
+        result.winners.push_back(contestants[i].id);
+      }
+      continuing = 0;
+      result.rounds.push_back(std::move(round));
+      break;
+    }
+
+    Contestant& leader = contestants[order.front()];
+    bool elected = method == CountMethod::kSingleTransferable ? leader.tally >= result.quota
+                                                              : 2 * leader.tally > continuingTotal;
+    if (elected)
+    {
+      leader.standing = Standing::kElected;
+      continuing--;
+      round.elected.push_back(leader.id);
+      result.winners.push_back(leader.id);
+      int64_t surplus = leader.tally - result.quota;
+      if (result.winners.size() < seats && surplus > 0)
+      {
+        transfer(leader, surplus, leader.tally);
+      }
+    }
+    else
+    {
+      // Exclude the last candidate; ties go against fewer first
+      // preferences, then the higher candidate ID:
+      size_t last = *std::min_element(order.begin(), order.end(), [&](size_t a, size_t b) {
+        const Contestant& x = contestants[a];
+        const Contestant& y = contestants[b];
+        if (x.tally != y.tally) return x.tally < y.tally;
+        if (x.firstPreferences != y.firstPreferences) return x.firstPreferences < y.firstPreferences;
+        return x.id > y.id;
+      });
+      Contestant& loser = contestants[last];
+      loser.standing = Standing::kExcluded;
+      continuing--;
+      round.excluded = loser.id;
+      transfer(loser, 1, 1);
+    }
+    result.rounds.push_back(std::move(round));
+  }
+  return result;
+}
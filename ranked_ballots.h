@@ -0,0 +1,137 @@
+#ifndef RANKED_BALLOTS
+#define RANKED_BALLOTS
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// How the ballots of a contest are counted.
+//
+// kPlurality:          One choice per ballot; the highest count wins.
+// kInstantRunoff:      Ranked ballots; the last candidate is excluded and their
+//                      ballots move on until a candidate has a majority of the
+//                      continuing ballots.
+// kSingleTransferable: Ranked ballots for several seats; candidates reaching the
+//                      Droop quota are elected and their surplus is passed on at
+//                      a reduced weight (Gregory method).
+enum class CountMethod { kPlurality, kInstantRunoff, kSingleTransferable };
+
+// Parses a count option value: "plurality", "irv" or "stv:SEATS".
+//
+// Returns:
+//   true if the value names a count method, false otherwise.
+bool ParseCountMethod(const std::string& text, CountMethod& method, size_t& seats);
+
+
+// Ranked ballots, packed for counting.
+//
+// Candidate IDs are interned to dense 16 bit indices, and every ballot is a
+// variable-length row of indices stored back to back in one array, so a
+// ballot costs two bytes per preference plus its row end.
+class BallotStore {
+public:
+    using Index = uint16_t;
+
+    // Adds a ballot.
+    //
+    // Args:
+    //   ranking: Candidate IDs, most preferred first.
+    //
+    // Returns:
+    //   true if the ballot was added, false if it is empty, repeats a
+    //   candidate or does not fit the store.
+    bool Add(const std::vector<std::string>& ranking);
+
+    // Returns the number of ballots.
+    size_t Size() const;
+
+    // Returns the candidate ID of a dense index.
+    const std::string& CandidateID(Index index) const;
+
+    // Returns the dense index of a candidate, or -1 if no ballot ranks it.
+    long Find(const std::string& candidateID) const;
+
+    // Returns the number of interned candidates.
+    size_t CandidateCount() const;
+
+    // Returns the preferences of a ballot.
+    //
+    // Args:
+    //   ballot: The ballot number.
+    //   length: Receives the number of preferences.
+    //
+    // Returns:
+    //   The first preference; the others follow it.
+    const Index* Row(size_t ballot, size_t& length) const;
+
+    // Reads ballots from a file with one ballot of comma separated candidate
+    // IDs per line. A missing file holds no ballots.
+    //
+    // Returns:
+    //   The number of lines that were not valid ballots.
+    size_t Load(const std::string& path);
+
+    // Appends ballots to a ballot file.
+    //
+    // Args:
+    //   path: The ballot file.
+    //   first: The first ballot to append; earlier ones are already saved.
+    //
+    // Returns:
+    //   true if the ballots were written, false otherwise.
+    bool Append(const std::string& path, size_t first) const;
+
+private:
+    std::vector<std::string> candidates;  // Dense index -> candidate ID.
+    std::unordered_map<std::string, Index> indices;
+    std::vector<Index> preferences;       // All rows back to back.
+    std::vector<uint32_t> rowEnds;        // End of each row in preferences.
+};
+
+
+// One round of a ranked count.
+struct CountRound {
+    std::vector<std::pair<std::string, int64_t>> tallies;  // Continuing candidates, highest first.
+    std::vector<std::string> elected;                      // Elected in this round.
+    std::string excluded;                                  // Excluded in this round, if any.
+    int64_t exhausted = 0;                                 // Ballots with no continuing preference left.
+};
+
+// Outcome of a ranked count. Vote values are fixed point in kVoteScale units,
+// so transferred fractions of a vote are exact and repeatable.
+struct CountResult {
+    static const int64_t kVoteScale = 100000;
+
+    int64_t quota = 0;
+    std::vector<CountRound> rounds;
+    std::vector<std::string> winners;  // In order of election.
+};
+
+// Formats a vote value in kVoteScale units, with two decimals if it has a
+// fraction, such as "1520" or "1519.67".
+std::string FormatVoteValue(int64_t value);
+
+// Counts ranked ballots.
+//
+// Every candidate keeps the ballots currently counting for them. When a
+// candidate is excluded or elected with a surplus, only that candidate's
+// ballots are moved on to their next continuing preference, so a round costs
+// time in proportion to the ballots transferred rather than all ballots.
+// Ties for exclusion are broken against the candidate with the fewer first
+// preferences, then the higher candidate ID.
+//
+// Args:
+//   ballots: The ballots.
+//   candidates: The candidates standing; preferences for others are skipped.
+//   method: kInstantRunoff or kSingleTransferable.
+//   seats: The number of seats to fill; instant runoff fills one.
+//
+// Returns:
+//   The rounds of the count and the winners.
+CountResult CountRankedBallots(const BallotStore& ballots, const std::vector<std::string>& candidates,
+                               CountMethod method, size_t seats);
+
+#endif
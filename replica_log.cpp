@@ -0,0 +1,207 @@
+#include "replica_log.h"
+#include "field_parser.h"
+
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <string_view>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+ReplicaLog::~ReplicaLog() { Close(); }
+
+// Starts a new log and locks it.
+bool ReplicaLog::Open(const std::string& path)
+{
+  Close();
+
+  // Lock the new file before it is in place, so a standby never sees it unlocked:
+  std::string temporary = path + ".tmp";
+  fd = open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC, 0644);
+  if (fd < 0)
+  {
+    return false;
+  }
+  if (flock(fd, LOCK_EX) != 0 || std::rename(temporary.c_str(), path.c_str()) != 0)
+  {
+    Close();
+    return false;
+  }
+  return true;
+}
+
+// Closes the log, which releases the lock once no other process shares it.
+void ReplicaLog::Close()
+{
+  if (fd >= 0)
+  {
+    close(fd);
+    fd = -1;
+  }
+}
+
+bool ReplicaLog::IsOpen() const { return fd >= 0; }
+
+void ReplicaLog::RecordVoter(const std::string& aadhar, bool status)
+{
+  Write("voter", aadhar + (status ? ",1" : ",0"));
+}
+
+void ReplicaLog::RecordVoterRemoval(const std::string& aadhar)
+{
+  Write("unvoter", aadhar);
+}
+
+void ReplicaLog::RecordVote(const std::string& aadhar, const std::string& id, int64_t votes)
+{
+  Write("vote", aadhar + "," + id + "," + std::to_string(votes));
+}
+
+void ReplicaLog::RecordCandidate(const std::string& id, const std::string& name, const std::string& symbol,
+                                 const std::string& region)
+{
+  Write("candidate", id + "," + name + "," + symbol + "," + region);
+}
+
+void ReplicaLog::RecordCandidateRemoval(const std::string& id)
+{
+  Write("uncandidate", id);
+}
+
+void ReplicaLog::RecordTally(const std::string& id, int64_t votes)
+{
+  Write("tally", id + "," + std::to_string(votes));
+}
+
+void ReplicaLog::RecordShutdown()
+{
+  Write("shutdown", "");
+}
+
+void ReplicaLog::Write(const std::string& type, const std::string& fields)
+{
+  if (fd < 0)
+  {
+    return;
+  }
+  std::string record = std::to_string(ReplicaLogNow()) + "," + type + (fields.empty() ? "" : ",") + fields + "\n";
+  if (write(fd, record.data(), record.size()) != static_cast<ssize_t>(record.size()))
+  {
+    // A standby cannot follow a log with a record missing:
+    Close();
+  }
+}
+
+// Returns the time of the replica log clock, in microseconds.
+int64_t ReplicaLogNow()
+{
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+ReplicaFollower::~ReplicaFollower() { Close(); }
+
+// Opens a log, if it exists.
+bool ReplicaFollower::Open(const std::string& logPath)
+{
+  Close();
+  path = logPath;
+  fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  return fd >= 0;
+}
+
+bool ReplicaFollower::IsOpen() const { return fd >= 0; }
+
+void ReplicaFollower::Close()
+{
+  if (fd >= 0)
+  {
+    close(fd);
+    fd = -1;
+  }
+  offset = 0;
+  partial.clear();
+}
+
+// Reads the complete records appended since the last call.
+size_t ReplicaFollower::Poll(std::vector<ReplicaRecord>& records, bool& restarted)
+{
+  records.clear();
+  restarted = false;
+
+  // A new primary renames its own log into place:
+  struct stat current, followed;
+  if (stat(path.c_str(), &current) == 0 && (fd < 0 || (fstat(fd, &followed) == 0 && current.st_ino != followed.st_ino)))
+  {
+    restarted = fd >= 0;
+    Open(path);
+  }
+  if (fd < 0)
+  {
+    return 0;
+  }
+
+  size_t malformed = 0;
+  char buffer[1 << 16];
+  ssize_t length;
+  while ((length = pread(fd, buffer, sizeof(buffer), offset)) > 0)
+  {
+    offset += length;
+    std::string_view text(buffer, length);
+    size_t newline;
+    while ((newline = text.find('\n')) != std::string_view::npos)
+    {
+      partial.append(text.substr(0, newline));
+      text.remove_prefix(newline + 1);
+
+      CsvFields fields(partial);
+      std::string_view micros, type, field;
+      ReplicaRecord record;
+      if (fields.Next(micros) && ParseCount(micros, record.micros) && fields.Next(type) && !type.empty())
+      {
+        record.type.assign(type);
+        while (fields.Next(field))
+        {
+          record.fields.emplace_back(field);
+        }
+        records.push_back(std::move(record));
+      }
+      else
+      {
+        malformed++;
+      }
+      partial.clear();
+    }
+    partial.append(text);
+  }
+  return malformed;
+}
+
+// Returns true if a primary holds the log's lock.
+bool ReplicaFollower::PrimaryAlive() const
+{
+  if (fd < 0)
+  {
+    return false;
+  }
+  if (flock(fd, LOCK_SH | LOCK_NB) == 0)
+  {
+    flock(fd, LOCK_UN);
+    return false;
+  }
+  return errno == EWOULDBLOCK;
+}
+
+// Returns the bytes written to the log that have not been read.
+uint64_t ReplicaFollower::BytesBehind() const
+{
+  struct stat info;
+  if (fd < 0 || fstat(fd, &info) != 0)
+  {
+    return 0;
+  }
+  return static_cast<uint64_t>(info.st_size) > offset ? info.st_size - offset : 0;
+}
@@ -0,0 +1,115 @@
+#ifndef REPLICA_LOG
+#define REPLICA_LOG
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Change log shipped from a primary election process to a warm standby
+// through a shared file in the data directory.
+//
+// Each line is one record, stamped with the primary's monotonic clock in
+// microseconds, which every process on the machine shares:
+//   <micros>,voter,<aadhar>,<status>                  Voter registered or changed.
+//   <micros>,unvoter,<aadhar>                         Voter removed.
+//   <micros>,vote,<aadhar>,<id>,<votes>               Voter marked voted, with the
+//                                                     candidate's new vote count.
+//   <micros>,candidate,<id>,<name>,<symbol>,<region>  Candidate registered or changed.
+//   <micros>,uncandidate,<id>                         Candidate removed.
+//   <micros>,tally,<id>,<votes>                       A candidate's vote count.
+//   <micros>,shutdown                                 The primary saved and stopped.
+// Records hold values rather than changes, so replaying a log over data files
+// saved after it started still ends in the primary's state. Every record is a
+// single append, so a reader never sees one half written.
+//
+// The primary holds an exclusive flock on the log while it runs. The kernel
+// drops the lock when the process dies, which is how a standby notices. A new
+// primary writes a new log file and renames it into place.
+class ReplicaLog {
+public:
+    ReplicaLog() = default;
+    ~ReplicaLog();
+
+    ReplicaLog(const ReplicaLog&) = delete;
+    ReplicaLog& operator=(const ReplicaLog&) = delete;
+
+    // Starts a new log and locks it.
+    //
+    // Returns:
+    //   true if the log is open, false otherwise.
+    bool Open(const std::string& path);
+
+    // Closes the log, which releases the lock once no other process shares it.
+    void Close();
+
+    bool IsOpen() const;
+
+    void RecordVoter(const std::string& aadhar, bool status);
+    void RecordVoterRemoval(const std::string& aadhar);
+    void RecordVote(const std::string& aadhar, const std::string& id, int64_t votes);
+    void RecordCandidate(const std::string& id, const std::string& name, const std::string& symbol,
+                         const std::string& region);
+    void RecordCandidateRemoval(const std::string& id);
+    void RecordTally(const std::string& id, int64_t votes);
+    void RecordShutdown();
+
+private:
+    void Write(const std::string& type, const std::string& fields);
+
+    int fd = -1;
+};
+
+
+// Returns the time of the replica log clock, in microseconds.
+int64_t ReplicaLogNow();
+
+
+// A record read from a replica log.
+struct ReplicaRecord {
+    int64_t micros = 0;
+    std::string type;
+    std::vector<std::string> fields;  // The fields after the type.
+};
+
+// Follows the replica log of a primary as it grows.
+class ReplicaFollower {
+public:
+    ReplicaFollower() = default;
+    ~ReplicaFollower();
+
+    ReplicaFollower(const ReplicaFollower&) = delete;
+    ReplicaFollower& operator=(const ReplicaFollower&) = delete;
+
+    // Opens a log, if it exists.
+    bool Open(const std::string& path);
+
+    bool IsOpen() const;
+
+    // Reads the complete records appended since the last call.
+    //
+    // Args:
+    //   records: Receives the records.
+    //   restarted: Receives true if a new primary replaced the log, in which
+    //              case the records are read from its start.
+    //
+    // Returns:
+    //   The number of lines that were not valid records.
+    size_t Poll(std::vector<ReplicaRecord>& records, bool& restarted);
+
+    // Returns true if a primary holds the log's lock.
+    bool PrimaryAlive() const;
+
+    // Returns the bytes written to the log that have not been read.
+    uint64_t BytesBehind() const;
+
+private:
+    void Close();
+
+    std::string path;
+    int fd = -1;
+    uint64_t offset = 0;   // Bytes read, including a partial last line.
+    std::string partial;   // A record whose end is not written yet.
+};
+
+#endif
@@ -0,0 +1,103 @@
+#include "result_export.h"
+
+namespace {
+
+const char* GroupName(ExportGrouping grouping)
+{
+  switch (grouping)
+  {
+    case ExportGrouping::kRegion: return "region";
+    case ExportGrouping::kParty: return "party";
+    default: return "candidate";
+  }
+}
+
+void WriteLittleEndian(std::ostream& out, uint64_t value, int bytes)
+{
+  char buffer[8];
+  for (int i = 0; i < bytes; i++)
+  {
+    buffer[i] = static_cast<char>(value >> (8 * i));
+  }
+  out.write(buffer, bytes);
+}
+
+// Writes the records of a (key, votes) range in the requested format.
+template <typename Range>
+void WriteRecords(std::ostream& out, const Range& records, ExportGrouping grouping, ExportFormat format)
+{
+  if (format == ExportFormat::kBinary)
+  {
+    out.write("EVR1", 4);
+    out.put(static_cast<char>(grouping));
+    WriteLittleEndian(out, records.size(), 4);
+  }
+
+  for (const auto& record : records)
+  {
+    const std::string& key = record.first;
+    switch (format)
+    {
+      case ExportFormat::kCsv:
+        out << key << ',' << record.second << '\n';
+        break;
+      case ExportFormat::kJsonLines:
+        out << "{\"" << GroupName(grouping) << "\":\"";
+        for (char c : key)
+        {
+          if (c == '"' || c == '\\')
+          {
+            out << '\\';
+          }
+          out << c;
+        }
+        out << "\",\"votes\":" << record.second << "}\n";
+        break;
+      case ExportFormat::kBinary:
+        WriteLittleEndian(out, key.size(), 2);
+        out.write(key.data(), key.size());
+        WriteLittleEndian(out, static_cast<uint64_t>(record.second), 8);
+        break;
+    }
+  }
+}
+
+}  // namespace
+
+bool ParseExportGrouping(const std::string& text, ExportGrouping& grouping)
+{
+  if (text == "candidate") grouping = ExportGrouping::kCandidate;
+  else if (text == "region") grouping = ExportGrouping::kRegion;
+  else if (text == "party") grouping = ExportGrouping::kParty;
+  else return false;
+  return true;
+}
+
+bool ParseExportFormat(const std::string& text, ExportFormat& format)
+{
+  if (text == "csv") format = ExportFormat::kCsv;
+  else if (text == "jsonl") format = ExportFormat::kJsonLines;
+  else if (text == "binary") format = ExportFormat::kBinary;
+  else return false;
+  return true;
+}
+
+// Streams the vote counts of a tally snapshot.
+void ExportResults(std::ostream& out, const std::vector<Candidate>& candidates,
+                   const TallySnapshot& votes, ExportGrouping grouping, ExportFormat format)
+{
+  if (grouping == ExportGrouping::kCandidate)
+  {
+    WriteRecords(out, votes.counts, grouping, format);
+    return;
+  }
+
+  // Sum the candidates' counts per region or party:
+  std::map<std::string, int64_t> totals;
+  for (const Candidate& candidate : candidates)
+  {
+    totals[grouping == ExportGrouping::kRegion ? candidate.GetRegion() : candidate.GetPartySymbol()] +=
+        votes.Find(candidate.GetCandidateID());
+  }
+  WriteRecords(out, totals, grouping, format);
+}
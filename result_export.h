@@ -0,0 +1,46 @@
+#ifndef RESULT_EXPORT
+#define RESULT_EXPORT
+
+#include "candidate.h"
+#include "tally_store.h"
+
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// How exported vote counts are grouped.
+enum class ExportGrouping { kCandidate, kRegion, kParty };
+
+// Encoding of an exported result feed.
+//
+// kCsv:       "key,votes" lines.
+// kJsonLines: {"candidate"|"region"|"party":"key","votes":n} lines.
+// kBinary:    "EVR1", grouping byte, uint32 record count, then per record a
+//             uint16 key length, the key bytes and an int64 vote count, all
+//             little-endian.
+enum class ExportFormat { kCsv, kJsonLines, kBinary };
+
+// Parses export option values ("candidate", "region", "party" and "csv",
+// "jsonl", "binary").
+//
+// Returns:
+//   true if the value names a grouping or format, false otherwise.
+bool ParseExportGrouping(const std::string& text, ExportGrouping& grouping);
+bool ParseExportFormat(const std::string& text, ExportFormat& format);
+
+
+// Streams the vote counts of a tally snapshot. Candidate counts are written in
+// candidate ID order; region and party totals are summed per group first.
+//
+// Args:
+//   out: The stream to write to.
+//   candidates: The candidate list, for regions and party symbols.
+//   votes: The vote counts to export, taken at a single instant.
+//   grouping: How to group the counts.
+//   format: The encoding to write.
+void ExportResults(std::ostream& out, const std::vector<Candidate>& candidates,
+                   const TallySnapshot& votes, ExportGrouping grouping, ExportFormat format);
+
+#endif
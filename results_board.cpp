@@ -0,0 +1,285 @@
+#include "results_board.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const char kMagic[8] = "RBOARD1";
+
+// A reader gives up on a writer that never finishes its update.
+const long kMaxReadAttempts = 1 << 20;
+
+// Returns a shared memory name with its leading '/'.
+std::string SegmentName(const std::string& name)
+{
+  return !name.empty() && name[0] == '/' ? name : "/" + name;
+}
+
+size_t SegmentSize(uint32_t capacity)
+{
+  return sizeof(ResultsBoardHeader) + size_t{capacity} * sizeof(ResultsBoardEntry);
+}
+
+ResultsBoardEntry* Entries(ResultsBoardHeader* header)
+{
+  return reinterpret_cast<ResultsBoardEntry*>(header + 1);
+}
+
+const ResultsBoardEntry* Entries(const ResultsBoardHeader* header)
+{
+  return reinterpret_cast<const ResultsBoardEntry*>(header + 1);
+}
+
+// Copies text into a board field, cutting it short if needed.
+void CopyField(char (&field)[ResultsBoardEntry::kFieldBytes], const std::string& text)
+{
+  size_t length = std::min(text.size(), sizeof(field) - 1);
+  std::memcpy(field, text.data(), length);
+  std::memset(field + length, 0, sizeof(field) - length);
+}
+
+// Maps a board segment, checking its layout.
+//
+// Returns:
+//   The header, or nullptr if the segment is missing or not a board.
+ResultsBoardHeader* MapSegment(const std::string& name, bool writable, size_t& size)
+{
+  int fd = shm_open(name.c_str(), writable ? O_RDWR : O_RDONLY, 0);
+  if (fd < 0)
+  {
+    return nullptr;
+  }
+  struct stat info;
+  void* mapping = MAP_FAILED;
+  if (fstat(fd, &info) == 0 && static_cast<size_t>(info.st_size) >= sizeof(ResultsBoardHeader))
+  {
+    size = info.st_size;
+    mapping = mmap(nullptr, size, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+  }
+  close(fd);
+  if (mapping == MAP_FAILED)
+  {
+    return nullptr;
+  }
+  ResultsBoardHeader* header = static_cast<ResultsBoardHeader*>(mapping);
+  if (std::memcmp(header->magic, kMagic, sizeof(kMagic)) != 0 || header->entryBytes != sizeof(ResultsBoardEntry) ||
+      SegmentSize(header->capacity) > size)
+  {
+    munmap(mapping, size);
+    return nullptr;
+  }
+  return header;
+}
+
+}  // namespace
+
+ResultsBoard::~ResultsBoard() { Stop(); }
+
+// Creates the board and starts publishing from a background thread.
+bool ResultsBoard::Start(const std::string& boardName, std::chrono::milliseconds every, const TallyStore& counts,
+                         const VersionedCandidateTable& candidates)
+{
+  Stop();
+  name = SegmentName(boardName);
+  interval = every;
+  tally = &counts;
+  table = &candidates;
+
+  // Readers of a board left by an earlier run move to the new one:
+  size_t staleSize = 0;
+  if (ResultsBoardHeader* stale = MapSegment(name, true, staleSize))
+  {
+    stale->retired.store(1, std::memory_order_release);
+    munmap(stale, staleSize);
+  }
+  if (!Create(kMinCapacity))
+  {
+    return false;
+  }
+  Publish();
+  stopping = false;
+  thread = std::thread(&ResultsBoard::Run, this);
+  return true;
+}
+
+// Publishes the last changes and stops the thread.
+void ResultsBoard::Stop()
+{
+  if (thread.joinable())
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stopping = true;
+    }
+    wake.notify_one();
+    thread.join();
+    Publish();
+  }
+  if (header != nullptr)
+  {
+    munmap(header, size);
+    header = nullptr;
+  }
+}
+
+// Maps a new segment with room for at least a number of entries, and retires
+// the one it replaces.
+bool ResultsBoard::Create(uint32_t capacity)
+{
+  shm_unlink(name.c_str());
+  int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+  if (fd < 0)
+  {
+    return false;
+  }
+  size_t newSize = SegmentSize(capacity);
+  void* mapping = MAP_FAILED;
+  if (ftruncate(fd, newSize) == 0)
+  {
+    mapping = mmap(nullptr, newSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  }
+  close(fd);
+  if (mapping == MAP_FAILED)
+  {
+    shm_unlink(name.c_str());
+    return false;
+  }
+
+  // The segment starts zeroed, so a reader sees an empty board until the
+  // first update:
+  ResultsBoardHeader* created = static_cast<ResultsBoardHeader*>(mapping);
+  created->capacity = capacity;
+  created->entryBytes = sizeof(ResultsBoardEntry);
+  std::memcpy(created->magic, kMagic, sizeof(kMagic));
+
+  if (header != nullptr)
+  {
+    header->retired.store(1, std::memory_order_release);
+    munmap(header, size);
+  }
+  header = created;
+  size = newSize;
+  publishedTable.reset();
+  return true;
+}
+
+// Publishes the tally if it or the candidate table changed.
+void ResultsBoard::Publish()
+{
+  std::shared_ptr<const CandidateTable> candidates = table->Current();
+  if (tally->Epoch() == publishedEpoch && candidates == publishedTable)
+  {
+    return;
+  }
+  TallySnapshot snapshot = tally->Snapshot();
+  if (snapshot.counts.size() > header->capacity &&
+      !Create(static_cast<uint32_t>(std::max<size_t>(2 * snapshot.counts.size(), kMinCapacity))))
+  {
+    return;
+  }
+
+  uint64_t sequence = header->sequence.load(std::memory_order_relaxed);
+  header->sequence.store(sequence + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  ResultsBoardEntry* entries = Entries(header);
+  for (size_t i = 0; i < snapshot.counts.size(); i++)
+  {
+    const Candidate* candidate = candidates->Find(snapshot.counts[i].first);
+    CopyField(entries[i].id, snapshot.counts[i].first);
+    CopyField(entries[i].name, candidate != nullptr ? candidate->GetCandidateName() : "");
+    CopyField(entries[i].symbol, candidate != nullptr ? candidate->GetPartySymbol() : "");
+    CopyField(entries[i].region, candidate != nullptr ? candidate->GetRegion() : "");
+    entries[i].votes = snapshot.counts[i].second;
+  }
+  header->count = static_cast<uint32_t>(snapshot.counts.size());
+  header->epoch = snapshot.epoch;
+  header->turnout = snapshot.turnout;
+  header->publishedMicros = std::chrono::duration_cast<std::chrono::microseconds>(
+                                std::chrono::system_clock::now().time_since_epoch()).count();
+
+  header->sequence.store(sequence + 2, std::memory_order_release);
+  publishedEpoch = snapshot.epoch;
+  publishedTable = candidates;
+}
+
+// Holds the publishing thread between two updates.
+void ResultsBoard::Pause()
+{
+  mutex.lock();
+}
+
+void ResultsBoard::Resume()
+{
+  mutex.unlock();
+}
+
+void ResultsBoard::Run()
+{
+  // The mutex is only released while waiting, so Pause() never catches the
+  // thread inside the tally or candidate table:
+  std::unique_lock<std::mutex> lock(mutex);
+  while (!wake.wait_for(lock, interval, [this] { return stopping; }))
+  {
+    Publish();
+  }
+}
+
+
+ResultsBoardReader::~ResultsBoardReader() { Close(); }
+
+// Maps a board.
+bool ResultsBoardReader::Open(const std::string& boardName)
+{
+  Close();
+  name = SegmentName(boardName);
+  header = MapSegment(name, false, size);
+  return header != nullptr;
+}
+
+// Copies the board at a single instant.
+bool ResultsBoardReader::Read(ResultsBoardView& view)
+{
+  for (long attempt = 0; header != nullptr && attempt < kMaxReadAttempts; attempt++)
+  {
+    uint64_t begin = header->sequence.load(std::memory_order_acquire);
+    if (begin & 1)
+    {
+      continue;
+    }
+    if (header->retired.load(std::memory_order_acquire) != 0)
+    {
+      Open(name);
+      continue;
+    }
+
+    uint32_t count = std::min(header->count, header->capacity);
+    view.entries.resize(count);
+    std::memcpy(view.entries.data(), Entries(header), count * sizeof(ResultsBoardEntry));
+    view.epoch = header->epoch;
+    view.turnout = header->turnout;
+    view.publishedMicros = header->publishedMicros;
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (header->sequence.load(std::memory_order_relaxed) == begin)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+void ResultsBoardReader::Close()
+{
+  if (header != nullptr)
+  {
+    munmap(const_cast<ResultsBoardHeader*>(header), size);
+    header = nullptr;
+  }
+}
@@ -0,0 +1,176 @@
+#ifndef RESULTS_BOARD
+#define RESULTS_BOARD
+
+#include "candidate_table.h"
+#include "tally_store.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Live results published in a POSIX shared memory segment, for local displays
+// that read them without talking to the election process.
+//
+// The segment is a header followed by capacity fixed-size entries, in host
+// byte order:
+//   magic (8)          "RBOARD1", NUL padded.
+//   capacity (4)       Entries the segment has room for.
+//   entry bytes (4)    sizeof(ResultsBoardEntry).
+//   sequence (8)       Odd while the board is being written.
+//   retired (4)        Non-zero once a newer segment replaced this one.
+//   count (4)          Entries in use, sorted by candidate ID.
+//   epoch (8)          The tally epoch published.
+//   turnout (8)        Sum of all counts.
+//   published (8)      Microseconds since the Unix epoch of the last update.
+//   entries
+// Updates are bracketed by two increments of the sequence (a seqlock): a
+// reader copies the board between two reads of the sequence and retries if
+// they differ, so a reader never waits on the writer, the writer never waits
+// on readers, and reading costs no system call. The writer is a thread of its
+// own that publishes a new tally snapshot when the tally epoch or candidate
+// table changes, so voting never touches the segment. When the board needs
+// more entries, a larger segment is created under the same name and the old
+// one is marked retired, so readers move to it on their next read.
+
+// One candidate on the board. Text fields are NUL terminated, and cut short
+// if they do not fit.
+struct ResultsBoardEntry {
+    static const size_t kFieldBytes = 32;
+
+    char id[kFieldBytes];
+    char name[kFieldBytes];
+    char symbol[kFieldBytes];
+    char region[kFieldBytes];
+    int64_t votes;
+};
+
+// The segment header, laid out as above.
+struct ResultsBoardHeader {
+    char magic[8];
+    uint32_t capacity;
+    uint32_t entryBytes;
+    std::atomic<uint64_t> sequence;
+    std::atomic<uint32_t> retired;
+    uint32_t count;
+    uint64_t epoch;
+    int64_t turnout;
+    int64_t publishedMicros;
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free,
+              "Board readers in other processes need lock-free atomics");
+
+// A consistent copy of the board.
+struct ResultsBoardView {
+    uint64_t epoch = 0;
+    int64_t turnout = 0;
+    int64_t publishedMicros = 0;
+    std::vector<ResultsBoardEntry> entries;  // Sorted by candidate ID.
+};
+
+
+// Publishes a tally on a board.
+class ResultsBoard {
+public:
+    static const uint32_t kMinCapacity = 64;
+
+    ResultsBoard() = default;
+    ~ResultsBoard();
+
+    ResultsBoard(const ResultsBoard&) = delete;
+    ResultsBoard& operator=(const ResultsBoard&) = delete;
+
+    // Creates the board, retiring any board left under the same name, and
+    // starts publishing from a background thread.
+    //
+    // Args:
+    //   name: The shared memory name; a leading '/' is added if missing.
+    //   interval: The time between two checks for changes.
+    //   tally: The vote counts to publish.
+    //   table: The candidates, for their names, party symbols and regions.
+    //
+    // Returns:
+    //   true if the board was created, false otherwise.
+    bool Start(const std::string& name, std::chrono::milliseconds interval, const TallyStore& tally,
+               const VersionedCandidateTable& table);
+
+    // Publishes the last changes and stops the thread. The board stays in
+    // place with the final results until the next Start() replaces it.
+    void Stop();
+
+    // Holds the publishing thread between two updates, so the process can
+    // fork without the child inheriting a lock the thread held, until
+    // Resume().
+    void Pause();
+    void Resume();
+
+private:
+    // Maps a new segment with room for at least a number of entries, and
+    // retires the one it replaces.
+    bool Create(uint32_t capacity);
+
+    void Publish();
+    void Run();
+
+    std::string name;
+    ResultsBoardHeader* header = nullptr;  // The mapped segment.
+    size_t size = 0;
+    std::chrono::milliseconds interval{20};
+    const TallyStore* tally = nullptr;
+    const VersionedCandidateTable* table = nullptr;
+    uint64_t publishedEpoch = 0;
+    std::shared_ptr<const CandidateTable> publishedTable;
+
+    std::thread thread;
+    std::mutex mutex;  // Held by the thread while it publishes.
+    std::condition_variable wake;
+    bool stopping = false;
+};
+
+
+// Reads a board published by another process.
+class ResultsBoardReader {
+public:
+    ResultsBoardReader() = default;
+    ~ResultsBoardReader();
+
+    ResultsBoardReader(const ResultsBoardReader&) = delete;
+    ResultsBoardReader& operator=(const ResultsBoardReader&) = delete;
+
+    // Maps a board.
+    //
+    // Args:
+    //   name: The shared memory name; a leading '/' is added if missing.
+    //
+    // Returns:
+    //   true if the board exists and has the expected layout, false otherwise.
+    bool Open(const std::string& name);
+
+    // Copies the board at a single instant. Only a retired board is reopened,
+    // so reads otherwise make no system call, and a view reused across reads
+    // is not reallocated.
+    //
+    // Args:
+    //   view: Receives the board.
+    //
+    // Returns:
+    //   true if the board was read, false if it is gone or its writer died in
+    //   the middle of an update.
+    bool Read(ResultsBoardView& view);
+
+private:
+    void Close();
+
+    std::string name;
+    const ResultsBoardHeader* header = nullptr;
+    size_t size = 0;
+};
+
+#endif
@@ -0,0 +1,362 @@
+#include "roll_archive.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const char kMagic[4] = {'V', 'R', 'A', '1'};
+const size_t kIndexEntrySize = 20;
+const size_t kFooterSize = 36;
+const size_t kPadding = 3;  // Lets the decoder read every gap as four bytes.
+const uint64_t kChecksumBasis = 14695981039346656037ull;
+
+void PutInt(std::string& bytes, uint64_t value, size_t width)
+{
+  for (size_t i = 0; i < width; i++, value >>= 8)
+  {
+    bytes += static_cast<char>(value & 0xff);
+  }
+}
+
+uint64_t GetInt(const char* bytes, size_t width)
+{
+  uint64_t value = 0;
+  for (size_t i = width; i-- > 0;)
+  {
+    value = value << 8 | static_cast<unsigned char>(bytes[i]);
+  }
+  return value;
+}
+
+// FNV-1a over 8 byte words, then the remaining bytes.
+uint64_t Checksum(uint64_t hash, const char* bytes, size_t length)
+{
+  size_t i = 0;
+  for (; i + 8 <= length; i += 8)
+  {
+    hash = (hash ^ GetInt(bytes + i, 8)) * 1099511628211ull;
+  }
+  for (; i < length; i++)
+  {
+    hash = (hash ^ static_cast<unsigned char>(bytes[i])) * 1099511628211ull;
+  }
+  return hash;
+}
+
+// Masks that cut a four byte read down to a gap of 1 to 4 bytes.
+const uint32_t kGapMasks[4] = {0xff, 0xffff, 0xffffff, 0xffffffff};
+
+// The offsets of the four gaps a control byte describes, relative to the
+// first, and the bytes they take together.
+struct ControlEntry {
+  uint8_t offsets[4];
+  uint8_t length;
+};
+
+struct ControlTable {
+  ControlEntry entries[256];
+
+  ControlTable()
+  {
+    for (unsigned control = 0; control < 256; control++)
+    {
+      uint8_t offset = 0;
+      for (unsigned i = 0; i < 4; i++)
+      {
+        entries[control].offsets[i] = offset;
+        offset += ((control >> (2 * i)) & 3) + 1;
+      }
+      entries[control].length = offset;
+    }
+  }
+};
+
+const ControlTable kControlTable;
+
+// Reads a gap of the given length code.
+inline uint32_t ReadGap(const unsigned char* bytes, unsigned code)
+{
+  return (bytes[0] | bytes[1] << 8 | bytes[2] << 16 | static_cast<uint32_t>(bytes[3]) << 24) & kGapMasks[code];
+}
+
+}  // namespace
+
+// Creates an archive.
+bool RollArchiveWriter::Open(const std::string& path)
+{
+  file.open(path, std::ios::binary | std::ios::trunc);
+  if (!file.is_open())
+  {
+    return false;
+  }
+  file.write(kMagic, sizeof(kMagic));
+  offset = sizeof(kMagic);
+  checksum = kChecksumBasis;
+  voters = blocks = 0;
+  index.clear();
+  gaps.clear();
+  statuses.clear();
+  return static_cast<bool>(file);
+}
+
+// Adds a voter; IDs must be added in ascending order.
+void RollArchiveWriter::Add(uint64_t key, bool voted)
+{
+  // A gap that does not fit four bytes starts a new block instead:
+  if (!statuses.empty() && (statuses.size() == kBlockVoters || key - lastKey - 1 > UINT32_MAX))
+  {
+    FlushBlock();
+  }
+  if (statuses.empty())
+  {
+    firstKey = key;
+  }
+  else
+  {
+    gaps.push_back(static_cast<uint32_t>(key - lastKey - 1));
+  }
+  statuses.push_back(voted);
+  lastKey = key;
+  voters++;
+}
+
+// Writes the last block and the index.
+bool RollArchiveWriter::Close()
+{
+  if (!file.is_open())
+  {
+    return false;
+  }
+  FlushBlock();
+  uint64_t indexOffset = offset;
+  Write(index);
+
+  std::string footer;
+  PutInt(footer, indexOffset, 8);
+  PutInt(footer, blocks, 8);
+  PutInt(footer, voters, 8);
+  PutInt(footer, checksum, 8);
+  footer.append(kMagic, sizeof(kMagic));
+  file.write(footer.data(), footer.size());
+  offset += footer.size();
+  file.close();
+  return static_cast<bool>(file);
+}
+
+uint64_t RollArchiveWriter::Size() const { return voters; }
+
+uint64_t RollArchiveWriter::Bytes() const { return offset; }
+
+void RollArchiveWriter::FlushBlock()
+{
+  if (statuses.empty())
+  {
+    return;
+  }
+
+  std::string block;
+  size_t count = statuses.size();
+  block.reserve((count + 7) / 8 + (gaps.size() + 3) / 4 + gaps.size() * 4 + kPadding);
+
+  // Status bitmap:
+  for (size_t i = 0; i < count; i += 8)
+  {
+    unsigned char bits = 0;
+    for (size_t j = i; j < std::min(count, i + 8); j++)
+    {
+      bits |= statuses[j] << (j - i);
+    }
+    block += static_cast<char>(bits);
+  }
+
+  // Control bytes, then the gap bytes:
+  std::string bytes;
+  for (size_t i = 0; i < gaps.size(); i += 4)
+  {
+    unsigned char control = 0;
+    for (size_t j = i; j < std::min(gaps.size(), i + 4); j++)
+    {
+      uint32_t gap = gaps[j];
+      size_t code = gap < (1u << 8) ? 0 : gap < (1u << 16) ? 1 : gap < (1u << 24) ? 2 : 3;
+      control |= code << (2 * (j - i));
+      PutInt(bytes, gap, code + 1);
+    }
+    block += static_cast<char>(control);
+  }
+  block += bytes;
+  block.append(kPadding, '\0');
+
+  PutInt(index, firstKey, 8);
+  PutInt(index, count, 4);
+  PutInt(index, offset, 8);
+  blocks++;
+  Write(block);
+  gaps.clear();
+  statuses.clear();
+}
+
+void RollArchiveWriter::Write(const std::string& bytes)
+{
+  checksum = Checksum(checksum, bytes.data(), bytes.size());
+  file.write(bytes.data(), bytes.size());
+  offset += bytes.size();
+}
+
+RollArchive::~RollArchive() { Close(); }
+
+void RollArchive::Close()
+{
+  if (data != nullptr)
+  {
+    munmap(const_cast<char*>(data), size);
+    data = nullptr;
+  }
+  blocks.clear();
+  voters = size = 0;
+}
+
+// Maps an archive and checks it.
+bool RollArchive::Open(const std::string& path)
+{
+  Close();
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+  {
+    return false;
+  }
+  struct stat info;
+  if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(kMagic) + kFooterSize)
+  {
+    close(fd);
+    return false;
+  }
+  size = info.st_size;
+  void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED)
+  {
+    size = 0;
+    return false;
+  }
+  data = static_cast<const char*>(mapping);
+  madvise(mapping, size, MADV_SEQUENTIAL);
+
+  // Read the footer and the index:
+  const char* footer = data + size - kFooterSize;
+  uint64_t indexOffset = GetInt(footer, 8);
+  uint64_t blockCount = GetInt(footer + 8, 8);
+  voters = GetInt(footer + 16, 8);
+  uint64_t expected = GetInt(footer + 24, 8);
+  if (std::memcmp(data, kMagic, sizeof(kMagic)) != 0 || std::memcmp(footer + 32, kMagic, sizeof(kMagic)) != 0 ||
+      indexOffset > size - kFooterSize || (size - kFooterSize - indexOffset) != blockCount * kIndexEntrySize)
+  {
+    Close();
+    return false;
+  }
+  uint64_t counted = 0;
+  for (uint64_t i = 0; i < blockCount; i++)
+  {
+    const char* entry = data + indexOffset + i * kIndexEntrySize;
+    Block block{GetInt(entry, 8), static_cast<uint32_t>(GetInt(entry + 8, 4)), GetInt(entry + 12, 8)};
+    uint64_t end = i + 1 < blockCount ? GetInt(entry + kIndexEntrySize + 12, 8) : indexOffset;
+    if (block.voters == 0 || block.offset < sizeof(kMagic) || block.offset >= end || end > indexOffset)
+    {
+      Close();
+      return false;
+    }
+    counted += block.voters;
+    blocks.push_back(block);
+  }
+
+  // Check the blocks and the index, in the pieces they were written in:
+  uint64_t checksum = kChecksumBasis;
+  for (size_t i = 0; i < blocks.size(); i++)
+  {
+    uint64_t end = i + 1 < blocks.size() ? blocks[i + 1].offset : indexOffset;
+    checksum = Checksum(checksum, data + blocks[i].offset, end - blocks[i].offset);
+  }
+  checksum = Checksum(checksum, data + indexOffset, blockCount * kIndexEntrySize);
+  if (counted != voters || checksum != expected)
+  {
+    Close();
+    return false;
+  }
+  return true;
+}
+
+uint64_t RollArchive::Size() const { return voters; }
+
+size_t RollArchive::BlockCount() const { return blocks.size(); }
+
+// Decodes a block.
+void RollArchive::DecodeBlock(size_t block, std::vector<uint64_t>& keys, std::vector<uint8_t>& statuses) const
+{
+  const Block& entry = blocks[block];
+  size_t count = entry.voters;
+  size_t gapCount = count - 1;
+  const unsigned char* bitmap = reinterpret_cast<const unsigned char*>(data + entry.offset);
+  const unsigned char* control = bitmap + (count + 7) / 8;
+  const unsigned char* bytes = control + (gapCount + 3) / 4;
+
+  statuses.resize(count);
+  for (size_t i = 0; i < count; i++)
+  {
+    statuses[i] = (bitmap[i / 8] >> (i % 8)) & 1;
+  }
+
+  keys.resize(count);
+  uint64_t key = entry.firstKey;
+  keys[0] = key;
+  uint64_t* out = keys.data() + 1;
+
+  // Four gaps per control byte, then the gaps of the last, partial one:
+  size_t quads = gapCount / 4;
+  for (size_t q = 0; q < quads; q++, out += 4)
+  {
+    unsigned c = control[q];
+    const ControlEntry& lengths = kControlTable.entries[c];
+    uint64_t g0 = ReadGap(bytes + lengths.offsets[0], c & 3);
+    uint64_t g1 = ReadGap(bytes + lengths.offsets[1], (c >> 2) & 3);
+    uint64_t g2 = ReadGap(bytes + lengths.offsets[2], (c >> 4) & 3);
+    uint64_t g3 = ReadGap(bytes + lengths.offsets[3], c >> 6);
+    bytes += lengths.length;
+    out[0] = key += g0 + 1;
+    out[1] = key += g1 + 1;
+    out[2] = key += g2 + 1;
+    out[3] = key += g3 + 1;
+  }
+  for (size_t i = quads * 4; i < gapCount; i++)
+  {
+    unsigned code = (control[i / 4] >> (2 * (i % 4))) & 3;
+    key += static_cast<uint64_t>(ReadGap(bytes, code)) + 1;
+    bytes += code + 1;
+    *out++ = key;
+  }
+}
+
+// Looks a voter up, decoding only the block that can hold them.
+bool RollArchive::Find(uint64_t key, bool& voted) const
+{
+  auto next = std::upper_bound(blocks.begin(), blocks.end(), key,
+                               [](uint64_t k, const Block& block) { return k < block.firstKey; });
+  if (next == blocks.begin())
+  {
+    return false;
+  }
+  std::vector<uint64_t> keys;
+  std::vector<uint8_t> statuses;
+  DecodeBlock(next - blocks.begin() - 1, keys, statuses);
+  auto it = std::lower_bound(keys.begin(), keys.end(), key);
+  if (it == keys.end() || *it != key)
+  {
+    return false;
+  }
+  voted = statuses[it - keys.begin()];
+  return true;
+}
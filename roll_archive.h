@@ -0,0 +1,131 @@
+#ifndef ROLL_ARCHIVE
+#define ROLL_ARCHIVE
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Compressed voter roll archive, for backups and transfers of the roll.
+//
+// Voters are stored sorted by packed Aadhar ID, in blocks of at most
+// kBlockVoters. A block holds its voting statuses as a bitmap, then the gaps
+// between consecutive IDs (minus one) in the Stream VByte layout: one control
+// byte gives the 1 to 4 byte lengths of four gaps, and the control bytes come
+// before all the gap bytes. Since a control byte alone says where the next
+// four gaps are, a block decodes with one table lookup per four gaps and no
+// branch per byte. An index at the end of the file gives the first ID, voter
+// count and offset of every block, so a single voter is found by decoding
+// one block.
+//
+// File layout, little endian throughout:
+//   "VRA1"                          Magic.
+//   blocks                          Status bitmap, control bytes, gap bytes and
+//                                   3 bytes of padding each.
+//   index                           Per block: first ID (8), voters (4), offset (8).
+//   index offset (8), blocks (8), voters (8), checksum (8), "VRA1"
+// The checksum is FNV-1a over the blocks and the index.
+class RollArchiveWriter {
+public:
+    static const size_t kBlockVoters = 4096;
+
+    // Creates an archive.
+    //
+    // Returns:
+    //   true if the file was created, false otherwise.
+    bool Open(const std::string& path);
+
+    // Adds a voter; IDs must be added in ascending order.
+    //
+    // Args:
+    //   key: The packed Aadhar ID.
+    //   voted: The voting status.
+    void Add(uint64_t key, bool voted);
+
+    // Writes the last block and the index.
+    //
+    // Returns:
+    //   true if the whole archive was written, false otherwise.
+    bool Close();
+
+    // Returns the number of voters added.
+    uint64_t Size() const;
+
+    // Returns the number of bytes written.
+    uint64_t Bytes() const;
+
+private:
+    void FlushBlock();
+    void Write(const std::string& bytes);
+
+    std::ofstream file;
+    uint64_t offset = 0;     // Bytes written.
+    uint64_t checksum = 0;
+    uint64_t voters = 0;
+
+    // The block being filled:
+    uint64_t firstKey = 0;
+    uint64_t lastKey = 0;
+    std::vector<uint32_t> gaps;
+    std::vector<uint8_t> statuses;
+
+    std::string index;
+    uint64_t blocks = 0;
+};
+
+
+// Reads a roll archive.
+class RollArchive {
+public:
+    RollArchive() = default;
+    ~RollArchive();
+
+    RollArchive(const RollArchive&) = delete;
+    RollArchive& operator=(const RollArchive&) = delete;
+
+    // Maps an archive and checks it.
+    //
+    // Returns:
+    //   true if the archive is complete and its checksum matches, false otherwise.
+    bool Open(const std::string& path);
+
+    // Returns the number of voters.
+    uint64_t Size() const;
+
+    size_t BlockCount() const;
+
+    // Decodes a block.
+    //
+    // Args:
+    //   block: The block number.
+    //   keys: Receives the packed Aadhar IDs, in ascending order.
+    //   statuses: Receives the voting statuses.
+    void DecodeBlock(size_t block, std::vector<uint64_t>& keys, std::vector<uint8_t>& statuses) const;
+
+    // Looks a voter up, decoding only the block that can hold them.
+    //
+    // Args:
+    //   key: The packed Aadhar ID.
+    //   voted: Receives the voting status.
+    //
+    // Returns:
+    //   true if the voter is in the archive, false otherwise.
+    bool Find(uint64_t key, bool& voted) const;
+
+private:
+    struct Block {
+        uint64_t firstKey;
+        uint32_t voters;
+        uint64_t offset;
+    };
+
+    void Close();
+
+    const char* data = nullptr;  // The mapped file.
+    size_t size = 0;
+    std::vector<Block> blocks;
+    uint64_t voters = 0;
+};
+
+#endif
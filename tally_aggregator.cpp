@@ -0,0 +1,387 @@
+#include "tally_aggregator.h"
+#include "field_parser.h"
+
+#include <cerrno>
+#include <cstring>
+#include <string_view>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+// Datagrams are kept well below the default socket buffer size.
+const size_t kMaxDatagram = 32 * 1024;
+
+// Fills a socket address, if the path fits.
+bool SocketAddress(const std::string& path, sockaddr_un& address)
+{
+  std::memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  if (path.empty() || path.size() >= sizeof(address.sun_path))
+  {
+    return false;
+  }
+  std::memcpy(address.sun_path, path.data(), path.size());
+  return true;
+}
+
+}  // namespace
+
+constexpr std::chrono::seconds TallyReporter::kFullInterval;
+constexpr std::chrono::seconds TallyReporter::kFinalTimeout;
+
+bool TallyReporter::Entry::operator!=(const Entry& other) const
+{
+  return votes != other.votes || region != other.region || symbol != other.symbol;
+}
+
+TallyReporter::~TallyReporter() { Stop(); }
+
+// Starts reporting a tally from a background thread.
+bool TallyReporter::Start(const std::string& path, const std::string& name, std::chrono::milliseconds every,
+                          const TallyStore& counts, const VersionedCandidateTable& candidates)
+{
+  Stop();
+  fd = socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+  if (fd < 0)
+  {
+    return false;
+  }
+  // Only the last report blocks, and never for longer than this:
+  timeval timeout{static_cast<time_t>(kFinalTimeout.count()), 0};
+  setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+  socketPath = path;
+  node = name;
+  interval = every;
+  tally = &counts;
+  table = &candidates;
+  generation = std::chrono::duration_cast<std::chrono::microseconds>(
+                   std::chrono::system_clock::now().time_since_epoch()).count();
+  sequence = 0;
+  sent.clear();
+  stopping = false;
+  thread = std::thread(&TallyReporter::Run, this);
+  return true;
+}
+
+// Sends a last report and stops the thread.
+void TallyReporter::Stop()
+{
+  if (!thread.joinable())
+  {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  wake.notify_one();
+  thread.join();
+  Report(false, true);
+  close(fd);
+  fd = -1;
+}
+
+// Holds the reporting thread between two reports.
+void TallyReporter::Pause()
+{
+  mutex.lock();
+}
+
+void TallyReporter::Resume()
+{
+  mutex.unlock();
+}
+
+void TallyReporter::Run()
+{
+  // The mutex is only released while waiting, so Pause() never catches the
+  // thread inside the tally or candidate table:
+  auto lastFull = std::chrono::steady_clock::time_point();
+  std::unique_lock<std::mutex> lock(mutex);
+  while (!stopping)
+  {
+    auto now = std::chrono::steady_clock::now();
+    bool full = sequence == 0 || now - lastFull >= kFullInterval;
+    Report(full);
+    if (full)
+    {
+      lastFull = now;
+    }
+    wake.wait_for(lock, interval, [this] { return stopping; });
+  }
+}
+
+// Sends the entries that changed since they were last sent.
+void TallyReporter::Report(bool full, bool final)
+{
+  TallySnapshot snapshot = tally->Snapshot();
+  std::shared_ptr<const CandidateTable> candidates = table->Current();
+
+  // The changes, removals included:
+  std::vector<std::pair<std::string, Entry>> changes;
+  auto previous = sent.begin();
+  for (const auto& count : snapshot.counts)
+  {
+    const Candidate* candidate = candidates->Find(count.first);
+    Entry entry{candidate != nullptr ? candidate->GetRegion() : "",
+                candidate != nullptr ? candidate->GetPartySymbol() : "", count.second};
+    for (; previous != sent.end() && previous->first < count.first; ++previous)
+    {
+      changes.emplace_back(previous->first, Entry{"", "", -1});
+    }
+    bool known = previous != sent.end() && previous->first == count.first;
+    if (full || !known || previous->second != entry)
+    {
+      changes.emplace_back(count.first, std::move(entry));
+    }
+    if (known)
+    {
+      ++previous;
+    }
+  }
+  for (; previous != sent.end(); ++previous)
+  {
+    changes.emplace_back(previous->first, Entry{"", "", -1});
+  }
+
+  // Send them in datagrams of whole entries; the aggregator has an entry once
+  // its datagram is sent:
+  std::string entries;
+  size_t first = 0;
+  for (size_t i = 0; i <= changes.size(); i++)
+  {
+    std::string line;
+    if (i < changes.size())
+    {
+      const Entry& entry = changes[i].second;
+      line = changes[i].first + "," + entry.region + "," + entry.symbol + "," + std::to_string(entry.votes) + "\n";
+    }
+    if (i == changes.size() ? !entries.empty() : entries.size() + line.size() > kMaxDatagram && !entries.empty())
+    {
+      if (!Send(entries, final))
+      {
+        return;
+      }
+      for (; first < i; first++)
+      {
+        if (changes[first].second.votes < 0)
+        {
+          sent.erase(changes[first].first);
+        }
+        else
+        {
+          sent[changes[first].first] = changes[first].second;
+        }
+      }
+      entries.clear();
+    }
+    entries += line;
+  }
+}
+
+// Sends one datagram with the next sequence number.
+bool TallyReporter::Send(const std::string& entries, bool wait)
+{
+  sockaddr_un address;
+  if (!SocketAddress(socketPath, address))
+  {
+    return false;
+  }
+  std::string datagram = "tally," + node + "," + std::to_string(generation) + "," + std::to_string(sequence + 1) +
+                         "\n" + entries;
+  // A missing or busy aggregator gets the same changes on the next report:
+  if (sendto(fd, datagram.data(), datagram.size(), wait ? 0 : MSG_DONTWAIT, reinterpret_cast<const sockaddr*>(&address),
+             sizeof(address)) != static_cast<ssize_t>(datagram.size()))
+  {
+    return false;
+  }
+  sequence++;
+  return true;
+}
+
+
+TallyAggregator::~TallyAggregator()
+{
+  if (fd >= 0)
+  {
+    close(fd);
+    unlink(socketPath.c_str());
+  }
+}
+
+// Binds the aggregator's socket, replacing a stale one.
+bool TallyAggregator::Open(const std::string& path)
+{
+  sockaddr_un address;
+  if (!SocketAddress(path, address))
+  {
+    return false;
+  }
+  fd = socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+  if (fd < 0)
+  {
+    return false;
+  }
+  unlink(path.c_str());
+  if (bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0)
+  {
+    close(fd);
+    fd = -1;
+    return false;
+  }
+  socketPath = path;
+  return true;
+}
+
+// Applies the datagrams that arrive within a timeout.
+size_t TallyAggregator::Receive(std::chrono::milliseconds timeout)
+{
+  pollfd waiting{fd, POLLIN, 0};
+  if (poll(&waiting, 1, static_cast<int>(timeout.count())) <= 0)
+  {
+    return 0;
+  }
+  size_t applied = 0;
+  std::string buffer(2 * kMaxDatagram, '\0');
+  ssize_t length;
+  while ((length = recv(fd, &buffer[0], buffer.size(), MSG_DONTWAIT)) >= 0)
+  {
+    applied += Apply(buffer.substr(0, length));
+  }
+  return applied;
+}
+
+// Applies one datagram.
+bool TallyAggregator::Apply(const std::string& datagram)
+{
+  // Parse it whole before anything is applied:
+  std::string_view text(datagram);
+  size_t newline = text.find('\n');
+  CsvFields header(text.substr(0, newline));
+  std::string_view tag, name, extra;
+  int64_t generation = 0, sequence = 0;
+  std::string_view generationField, sequenceField;
+  bool valid = newline != std::string_view::npos && header.Next(tag) && tag == "tally" && header.Next(name) &&
+               !name.empty() && header.Next(generationField) && ParseCount(generationField, generation) &&
+               header.Next(sequenceField) && ParseCount(sequenceField, sequence) && sequence > 0 &&
+               !header.Next(extra);
+  std::vector<std::pair<std::string, Entry>> changes;
+  for (text.remove_prefix(valid ? newline + 1 : text.size()); valid && !text.empty();)
+  {
+    newline = text.find('\n');
+    CsvFields fields(text.substr(0, newline));
+    text.remove_prefix(newline == std::string_view::npos ? text.size() : newline + 1);
+    std::string_view id, region, symbol, votes;
+    Entry entry;
+    valid = fields.Next(id) && !id.empty() && fields.Next(region) && fields.Next(symbol) && fields.Next(votes) &&
+            !fields.Next(extra) && (votes == "-1" || ParseCount(votes, entry.votes));
+    entry.region.assign(region);
+    entry.symbol.assign(symbol);
+    entry.votes = votes == "-1" ? -1 : entry.votes;
+    changes.emplace_back(std::string(id), std::move(entry));
+  }
+  if (!valid)
+  {
+    rejected++;
+    return false;
+  }
+
+  // Older generations and sequence numbers are retries of what was applied:
+  Node& node = nodes[std::string(name)];
+  if (generation < node.generation || (generation == node.generation && static_cast<uint64_t>(sequence) <= node.sequence))
+  {
+    duplicates++;
+    return false;
+  }
+  if (generation > node.generation)
+  {
+    for (const auto& entry : node.entries)
+    {
+      Count(entry.first, entry.second, -1);
+    }
+    node.entries.clear();
+    node.generation = generation;
+  }
+  node.sequence = sequence;
+
+  for (auto& change : changes)
+  {
+    auto it = node.entries.find(change.first);
+    if (it != node.entries.end())
+    {
+      Count(it->first, it->second, -1);
+      node.entries.erase(it);
+    }
+    if (change.second.votes >= 0)
+    {
+      Count(change.first, change.second, 1);
+      details[change.first] = change.second;
+      node.entries.emplace(change.first, std::move(change.second));
+    }
+  }
+  return true;
+}
+
+// Adds an entry's votes to the totals, or takes them out.
+void TallyAggregator::Count(const std::string& candidateID, const Entry& entry, int sign)
+{
+  auto adjust = [&](std::map<std::string, Merged>& totals, const std::string& key) {
+    Merged& counted = totals[key];
+    counted.votes += sign * entry.votes;
+    counted.entries += sign;
+    if (counted.entries == 0)
+    {
+      totals.erase(key);
+    }
+  };
+  adjust(candidates, candidateID);
+  adjust(regions, entry.region);
+  total += sign * entry.votes;
+  if (candidates.count(candidateID) == 0)
+  {
+    details.erase(candidateID);
+  }
+}
+
+std::vector<std::pair<std::string, int64_t>> TallyAggregator::CandidateTotals() const
+{
+  std::vector<std::pair<std::string, int64_t>> totals;
+  for (const auto& entry : candidates)
+  {
+    totals.emplace_back(entry.first, entry.second.votes);
+  }
+  return totals;
+}
+
+std::vector<std::pair<std::string, int64_t>> TallyAggregator::RegionTotals() const
+{
+  std::vector<std::pair<std::string, int64_t>> totals;
+  for (const auto& entry : regions)
+  {
+    totals.emplace_back(entry.first, entry.second.votes);
+  }
+  return totals;
+}
+
+int64_t TallyAggregator::Total() const { return total; }
+
+// Candidates with the region and party symbol last reported for them.
+std::vector<Candidate> TallyAggregator::CandidateList() const
+{
+  std::vector<Candidate> list;
+  for (const auto& entry : details)
+  {
+    list.emplace_back(entry.first, "", entry.second.symbol, entry.second.region);
+  }
+  return list;
+}
+
+size_t TallyAggregator::NodeCount() const { return nodes.size(); }
+
+uint64_t TallyAggregator::Duplicates() const { return duplicates; }
+
+uint64_t TallyAggregator::Rejected() const { return rejected; }
@@ -0,0 +1,177 @@
+#ifndef TALLY_AGGREGATOR
+#define TALLY_AGGREGATOR
+
+#include "candidate_table.h"
+#include "tally_store.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Tally updates sent by district elections to an aggregator over a Unix
+// datagram socket.
+//
+// A datagram is a header line and one line per candidate whose count changed:
+//   tally,<node>,<generation>,<sequence>
+//   <candidate ID>,<region>,<party symbol>,<votes>   (votes -1: removed)
+// Entries hold counts rather than increments, and every datagram of a node
+// carries the next sequence number of its generation, the time its process
+// started. The aggregator skips sequence numbers it has already applied, so a
+// retried or repeated datagram changes nothing, and a new generation replaces
+// everything the node sent before. A node sends all its counts when it
+// starts, and again every kFullInterval, so an aggregator that restarted
+// catches up without asking.
+class TallyReporter {
+public:
+    static constexpr std::chrono::seconds kFullInterval{10};
+    static constexpr std::chrono::seconds kFinalTimeout{1};
+
+    TallyReporter() = default;
+    ~TallyReporter();
+
+    TallyReporter(const TallyReporter&) = delete;
+    TallyReporter& operator=(const TallyReporter&) = delete;
+
+    // Starts reporting a tally from a background thread. The tally and table
+    // are read through their snapshots, so voting is never held up.
+    //
+    // Args:
+    //   socketPath: The aggregator's socket.
+    //   node: The name of this election, without commas or line breaks.
+    //   interval: The time between two reports.
+    //   tally: The vote counts to report.
+    //   table: The candidates, for their regions and party symbols.
+    //
+    // Returns:
+    //   true if the reporter started, false if no socket could be created.
+    bool Start(const std::string& socketPath, const std::string& node, std::chrono::milliseconds interval,
+               const TallyStore& tally, const VersionedCandidateTable& table);
+
+    // Sends a last report and stops the thread.
+    void Stop();
+
+    // Holds the reporting thread between two reports, so the process can
+    // fork without the child inheriting a lock the thread held, until
+    // Resume().
+    void Pause();
+    void Resume();
+
+private:
+    struct Entry {
+        std::string region;
+        std::string symbol;
+        int64_t votes;
+
+        bool operator!=(const Entry& other) const;
+    };
+
+    // Sends the entries that changed since they were last sent; entries that
+    // could not be sent are tried again next time.
+    // The last report waits for room in a full socket buffer, up to
+    // kFinalTimeout, rather than being dropped.
+    void Report(bool full, bool final = false);
+
+    // Sends one datagram with the next sequence number.
+    bool Send(const std::string& entries, bool wait);
+
+    void Run();
+
+    int fd = -1;
+    std::string socketPath;
+    std::string node;
+    int64_t generation = 0;
+    uint64_t sequence = 0;
+    std::chrono::milliseconds interval{0};
+    const TallyStore* tally = nullptr;
+    const VersionedCandidateTable* table = nullptr;
+    std::map<std::string, Entry> sent;  // Last entries the aggregator took, by candidate ID.
+
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool stopping = false;
+};
+
+
+// Merged totals of many district elections.
+class TallyAggregator {
+public:
+    TallyAggregator() = default;
+    ~TallyAggregator();
+
+    TallyAggregator(const TallyAggregator&) = delete;
+    TallyAggregator& operator=(const TallyAggregator&) = delete;
+
+    // Binds the aggregator's socket, replacing a stale one.
+    bool Open(const std::string& socketPath);
+
+    // Applies the datagrams that arrive within a timeout.
+    //
+    // Args:
+    //   timeout: The longest time to wait for the first datagram.
+    //
+    // Returns:
+    //   The number of datagrams that changed the totals.
+    size_t Receive(std::chrono::milliseconds timeout);
+
+    // Merged counts, sorted by key. A candidate standing in several districts
+    // is summed.
+    std::vector<std::pair<std::string, int64_t>> CandidateTotals() const;
+    std::vector<std::pair<std::string, int64_t>> RegionTotals() const;
+    int64_t Total() const;
+
+    // Candidates with the region and party symbol last reported for them,
+    // for exporting the merged totals.
+    std::vector<Candidate> CandidateList() const;
+
+    size_t NodeCount() const;
+    uint64_t Duplicates() const;  // Datagrams skipped as already applied.
+    uint64_t Rejected() const;    // Datagrams that could not be parsed.
+
+private:
+    struct Entry {
+        std::string region;
+        std::string symbol;
+        int64_t votes = 0;
+    };
+
+    struct Node {
+        int64_t generation = 0;
+        uint64_t sequence = 0;  // Last applied.
+        std::map<std::string, Entry> entries;
+    };
+
+    // Applies one datagram.
+    //
+    // Returns:
+    //   true if the totals changed, false otherwise.
+    bool Apply(const std::string& datagram);
+
+    // A merged count and the number of node entries in it.
+    struct Merged {
+        int64_t votes = 0;
+        size_t entries = 0;
+    };
+
+    // Adds an entry's votes to the totals, or takes them out.
+    void Count(const std::string& candidateID, const Entry& entry, int sign);
+
+    int fd = -1;
+    std::string socketPath;
+    std::map<std::string, Node> nodes;
+    std::map<std::string, Merged> candidates;
+    std::map<std::string, Merged> regions;
+    std::map<std::string, Entry> details;  // Last region and symbol by candidate ID.
+    int64_t total = 0;
+    uint64_t duplicates = 0;
+    uint64_t rejected = 0;
+};
+
+#endif
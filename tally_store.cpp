@@ -0,0 +1,159 @@
+#include "tally_store.h"
+
+#include <algorithm>
+#include <thread>
+
+// Returns the count of a candidate, or 0 if it is not in the snapshot.
+int64_t TallySnapshot::Find(const std::string& candidateID) const
+{
+  auto it = std::lower_bound(counts.begin(), counts.end(), candidateID,
+                             [](const std::pair<std::string, int64_t>& entry, const std::string& id) {
+                 return entry.first < id;
+               });
+  return (it != counts.end() && it->first == candidateID) ? it->second : 0;
+}
+
+long TallyStore::Layout::Find(const std::string& candidateID) const
+{
+  auto it = std::lower_bound(ids.begin(), ids.end(), candidateID);
+  return (it != ids.end() && *it == candidateID) ? it - ids.begin() : -1;
+}
+
+TallyStore::TallyStore() : layout(std::make_shared<Layout>()) {}
+
+// Sets the count of a candidate, adding the candidate if needed.
+void TallyStore::Set(const std::string& candidateID, int64_t votes)
+{
+  std::lock_guard<std::mutex> lock(writerMutex);
+  BeginUpdate();
+  size_t slot = Slot(candidateID);  // May publish a new layout.
+  std::atomic<int64_t>& count = layout->counts[slot];
+  turnout.store(turnout.load(std::memory_order_relaxed) + votes - count.load(std::memory_order_relaxed),
+                std::memory_order_relaxed);
+  count.store(votes, std::memory_order_relaxed);
+  EndUpdate();
+}
+
+// Adds votes to a candidate's count.
+int64_t TallyStore::Add(const std::string& candidateID, int64_t votes)
+{
+  std::lock_guard<std::mutex> lock(writerMutex);
+  BeginUpdate();
+  size_t slot = Slot(candidateID);  // May publish a new layout.
+  std::atomic<int64_t>& count = layout->counts[slot];
+  int64_t updated = count.load(std::memory_order_relaxed) + votes;
+  count.store(updated, std::memory_order_relaxed);
+  turnout.store(turnout.load(std::memory_order_relaxed) + votes, std::memory_order_relaxed);
+  EndUpdate();
+  return updated;
+}
+
+// Removes a candidate and its votes from the tally.
+void TallyStore::Remove(const std::string& candidateID)
+{
+  std::lock_guard<std::mutex> lock(writerMutex);
+  long slot = layout->Find(candidateID);
+  if (slot < 0)
+  {
+    return;
+  }
+
+  auto next = std::make_shared<Layout>();
+  next->ids = layout->ids;
+  next->ids.erase(next->ids.begin() + slot);
+  next->counts.reset(new std::atomic<int64_t>[next->ids.size()]);
+  for (size_t i = 0, from = 0; i < next->ids.size(); i++, from++)
+  {
+    from += (from == static_cast<size_t>(slot));
+    next->counts[i].store(layout->counts[from].load(std::memory_order_relaxed), std::memory_order_relaxed);
+  }
+
+  BeginUpdate();
+  turnout.store(turnout.load(std::memory_order_relaxed) - layout->counts[slot].load(std::memory_order_relaxed),
+                std::memory_order_relaxed);
+  std::atomic_store(&layout, std::shared_ptr<const Layout>(std::move(next)));
+  EndUpdate();
+}
+
+// Returns the current count of a candidate, or 0 if it is not tallied.
+int64_t TallyStore::Get(const std::string& candidateID) const
+{
+  std::shared_ptr<const Layout> current = std::atomic_load(&layout);
+  long slot = current->Find(candidateID);
+  return slot < 0 ? 0 : current->counts[slot].load(std::memory_order_relaxed);
+}
+
+// Copies all counts at a single logical instant, without stopping writers.
+TallySnapshot TallyStore::Snapshot() const
+{
+  TallySnapshot snapshot;
+  while (true)
+  {
+    uint64_t begin = sequence.load(std::memory_order_acquire);
+    if (begin & 1)
+    {
+      // An update is in progress; it holds no locks a reader waits on.
+      std::this_thread::yield();
+      continue;
+    }
+
+    std::shared_ptr<const Layout> current = std::atomic_load(&layout);
+    snapshot.counts.resize(current->ids.size());
+    for (size_t i = 0; i < current->ids.size(); i++)
+    {
+      snapshot.counts[i].first = current->ids[i];
+      snapshot.counts[i].second = current->counts[i].load(std::memory_order_relaxed);
+    }
+    snapshot.turnout = turnout.load(std::memory_order_relaxed);
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (sequence.load(std::memory_order_relaxed) == begin)
+    {
+      snapshot.epoch = begin / 2;
+      return snapshot;
+    }
+  }
+}
+
+// Returns the number of tally updates completed so far.
+uint64_t TallyStore::Epoch() const
+{
+  return sequence.load(std::memory_order_acquire) / 2;
+}
+
+// Returns the slot of a candidate, publishing a layout with the candidate
+// added if needed. Called by writers inside an update.
+size_t TallyStore::Slot(const std::string& candidateID)
+{
+  long slot = layout->Find(candidateID);
+  if (slot >= 0)
+  {
+    return slot;
+  }
+
+  // Copy the counters into a layout with the new ID; readers still holding
+  // the old layout keep it alive until they finish.
+  auto position = std::lower_bound(layout->ids.begin(), layout->ids.end(), candidateID) - layout->ids.begin();
+  auto next = std::make_shared<Layout>();
+  next->ids = layout->ids;
+  next->ids.insert(next->ids.begin() + position, candidateID);
+  next->counts.reset(new std::atomic<int64_t>[next->ids.size()]);
+  for (size_t i = 0, from = 0; i < next->ids.size(); i++)
+  {
+    int64_t value = (i == static_cast<size_t>(position)) ? 0 : layout->counts[from++].load(std::memory_order_relaxed);
+    next->counts[i].store(value, std::memory_order_relaxed);
+  }
+  std::atomic_store(&layout, std::shared_ptr<const Layout>(std::move(next)));
+  return position;
+}
+
+void TallyStore::BeginUpdate()
+{
+  sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+}
+
+void TallyStore::EndUpdate()
+{
+  sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
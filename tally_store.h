@@ -0,0 +1,90 @@
+#ifndef TALLY_STORE
+#define TALLY_STORE
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Vote counts of all candidates at a single logical instant.
+struct TallySnapshot {
+    uint64_t epoch = 0;    // Number of tally updates before the snapshot.
+    int64_t turnout = 0;   // Sum of all counts at that instant.
+    std::vector<std::pair<std::string, int64_t>> counts;  // Sorted by candidate ID.
+
+    // Returns the count of a candidate, or 0 if it is not in the snapshot.
+    int64_t Find(const std::string& candidateID) const;
+};
+
+
+// Vote tally that readers can snapshot while votes are being cast.
+//
+// Counters live in an immutable layout (the sorted candidate IDs and one atomic
+// counter per ID) published through an atomically swapped shared pointer, so a
+// reader keeps the layout it loaded alive while candidates are added or
+// removed. Writers are serialised and bump a sequence number around each
+// update (a seqlock): a reader copies the counters and the turnout between two
+// reads of the sequence and retries if an update overlapped, so every
+// snapshot adds up to the turnout it reports without ever blocking a writer.
+class TallyStore {
+public:
+    TallyStore();
+
+    TallyStore(const TallyStore&) = delete;
+    TallyStore& operator=(const TallyStore&) = delete;
+
+    // Sets the count of a candidate, adding the candidate if needed.
+    //
+    // Args:
+    //   candidateID: The candidate to set.
+    //   votes: The new vote count.
+    void Set(const std::string& candidateID, int64_t votes);
+
+    // Adds votes to a candidate's count.
+    //
+    // Args:
+    //   candidateID: The candidate to add to; added with a zero count if new.
+    //   votes: The number of votes to add.
+    //
+    // Returns:
+    //   The candidate's new count.
+    int64_t Add(const std::string& candidateID, int64_t votes = 1);
+
+    // Removes a candidate and its votes from the tally.
+    void Remove(const std::string& candidateID);
+
+    // Returns the current count of a candidate, or 0 if it is not tallied.
+    int64_t Get(const std::string& candidateID) const;
+
+    // Copies all counts at a single logical instant, without stopping writers.
+    TallySnapshot Snapshot() const;
+
+    // Returns the number of tally updates completed so far, which changes
+    // whenever any count does.
+    uint64_t Epoch() const;
+
+private:
+    struct Layout {
+        std::vector<std::string> ids;                   // Sorted candidate IDs.
+        std::unique_ptr<std::atomic<int64_t>[]> counts;  // Parallel to ids.
+
+        long Find(const std::string& candidateID) const;
+    };
+
+    // Returns the slot of a candidate, publishing a layout with the candidate
+    // added if needed. Called by writers inside an update.
+    size_t Slot(const std::string& candidateID);
+
+    void BeginUpdate();
+    void EndUpdate();
+
+    std::shared_ptr<const Layout> layout;  // Accessed with std::atomic_load/store.
+    std::atomic<uint64_t> sequence{0};      // Odd while an update is in progress.
+    std::atomic<int64_t> turnout{0};
+    std::mutex writerMutex;
+};
+
+#endif
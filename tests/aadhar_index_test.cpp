@@ -0,0 +1,97 @@
+// Tests of Aadhar key packing, the radix sort order and interpolation search.
+
+#include "../aadhar_index.h"
+#include "test_check.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace {
+
+// The largest packed 12 digit Aadhar ID.
+const uint64_t kMaxKey = 999999999999ull;
+
+// Checks that an order sorts the keys, keeping equal keys in input order.
+void CheckSortOrder(const std::vector<uint64_t>& keys)
+{
+  std::vector<uint32_t> order = RadixSortOrder(keys);
+  CHECK_EQ(order.size(), keys.size());
+
+  std::vector<uint32_t> expected(keys.size());
+  for (size_t i = 0; i < expected.size(); i++) {
+    expected[i] = static_cast<uint32_t>(i);
+  }
+  std::stable_sort(expected.begin(), expected.end(),
+                   [&keys](uint32_t a, uint32_t b) { return keys[a] < keys[b]; });
+  CHECK(order == expected);
+}
+
+void TestPackAadhar()
+{
+  CHECK_EQ(PackAadhar("123456789124"), 123456789124ull);
+  CHECK_EQ(PackAadhar("999999999999"), kMaxKey);
+  CHECK(PackAadhar("223456789124") < PackAadhar("223456789125"));
+}
+
+void TestRadixSortOrder()
+{
+  CheckSortOrder({});
+  CheckSortOrder({42});
+  CheckSortOrder({5, 3, 5, 1, 3});
+
+  // Keys that differ only in their highest digit, so that the lower passes
+  // are skipped:
+  CheckSortOrder({kMaxKey, 0, uint64_t{1} << 40, kMaxKey, 0});
+
+  // Enough random keys, with duplicates, to take the parallel path:
+  std::mt19937_64 random(7);
+  std::uniform_int_distribution<uint64_t> aadhar(100000000000ull, kMaxKey);
+  std::vector<uint64_t> keys(200000);
+  for (size_t i = 0; i < keys.size(); i++) {
+    keys[i] = i % 10 == 0 && i > 0 ? keys[i / 2] : aadhar(random);
+  }
+  CheckSortOrder(keys);
+}
+
+void TestInterpolationSearch()
+{
+  CHECK_EQ(InterpolationSearch({}, 5), -1);
+  CHECK_EQ(InterpolationSearch({5}, 5), 0);
+  CHECK_EQ(InterpolationSearch({5}, 4), -1);
+  CHECK(InterpolationSearch({5, 5, 5}, 5) >= 0);
+
+  // Evenly spread keys are found by interpolation:
+  std::vector<uint64_t> uniform;
+  for (uint64_t key = 100000000000ull; key <= kMaxKey; key += 900000000ull) {
+    uniform.push_back(key);
+  }
+  for (size_t i = 0; i < uniform.size(); i++) {
+    CHECK_EQ(InterpolationSearch(uniform, uniform[i]), static_cast<long>(i));
+    CHECK_EQ(InterpolationSearch(uniform, uniform[i] + 1), -1);
+  }
+  CHECK_EQ(InterpolationSearch(uniform, 0), -1);
+  CHECK_EQ(InterpolationSearch(uniform, kMaxKey + 1), -1);
+
+  // Skewed keys fall back to bisection:
+  std::vector<uint64_t> skewed;
+  for (uint64_t key = 1; key <= 1000; key++) {
+    skewed.push_back(key);
+  }
+  skewed.push_back(kMaxKey);
+  for (size_t i = 0; i < skewed.size(); i++) {
+    CHECK_EQ(InterpolationSearch(skewed, skewed[i]), static_cast<long>(i));
+  }
+  CHECK_EQ(InterpolationSearch(skewed, 5000), -1);
+}
+
+}  // namespace
+
+int main()
+{
+  TestPackAadhar();
+  TestRadixSortOrder();
+  TestInterpolationSearch();
+  return TestResult("aadhar_index_test");
+}
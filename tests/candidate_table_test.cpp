@@ -0,0 +1,124 @@
+// Tests of the versioned candidate table: publishing edits, abandoned edits
+// and compare-and-swap retries when edits race.
+
+#include "../candidate_table.h"
+#include "test_check.h"
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Returns an edit that adds a candidate.
+std::function<bool(CandidateTable&)> AddCandidate(const std::string& id)
+{
+  return [id](CandidateTable& table) {
+    if (table.ids.count(id) != 0) {
+      return false;
+    }
+    table.candidates.push_back(Candidate(id, "Name", "S" + id, "R001", 0));
+    table.ids.insert(id);
+    table.symbols.insert("S" + id);
+    return true;
+  };
+}
+
+void TestEdits()
+{
+  VersionedCandidateTable table;
+  std::shared_ptr<const CandidateTable> empty = table.Current();
+  CHECK_EQ(empty->version, 0u);
+
+  CHECK(table.Edit(AddCandidate("C01")));
+  CHECK(table.Edit(AddCandidate("C02")));
+  std::shared_ptr<const CandidateTable> current = table.Current();
+  CHECK_EQ(current->version, 2u);
+  CHECK_EQ(current->candidates.size(), 2u);
+  CHECK(current->Find("C02") != nullptr);
+  CHECK(current->Find("C03") == nullptr);
+
+  // An abandoned edit publishes nothing:
+  CHECK(!table.Edit(AddCandidate("C01")));
+  CHECK(table.Current() == current);
+
+  // Readers keep the version they loaded:
+  CHECK_EQ(empty->candidates.size(), 0u);
+}
+
+// An edit that loses the race is reapplied to the newer version, so neither
+// change is lost.
+void TestRetryAfterLostRace()
+{
+  VersionedCandidateTable table;
+  CHECK(table.Edit(AddCandidate("C01")));
+
+  int attempts = 0;
+  CHECK(table.Edit([&table, &attempts](CandidateTable& copy) {
+    attempts++;
+    if (attempts == 1) {
+      // Another edit is published after this one took its copy:
+      CHECK(table.Edit(AddCandidate("C02")));
+    }
+    return AddCandidate("C03")(copy);
+  }));
+
+  CHECK_EQ(attempts, 2);
+  std::shared_ptr<const CandidateTable> current = table.Current();
+  CHECK_EQ(current->version, 3u);
+  CHECK_EQ(current->candidates.size(), 3u);
+  CHECK(current->Find("C02") != nullptr);
+  CHECK(current->Find("C03") != nullptr);
+}
+
+// Several threads edit the same candidate at once; every increment must
+// survive the compare-and-swap retries.
+void TestConcurrentEdits()
+{
+  const int kThreads = 4;
+  const int kEditsPerThread = 2000;
+
+  VersionedCandidateTable table;
+  CHECK(table.Edit(AddCandidate("C01")));
+
+  std::atomic<int> attempts{0};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; t++) {
+    threads.emplace_back([&table, &attempts, t]() {
+      for (int i = 0; i < kEditsPerThread; i++) {
+        table.Edit([&attempts](CandidateTable& copy) {
+          attempts++;
+          Candidate* candidate = copy.Find("C01");
+          candidate->SetVotes(candidate->GetNumOfVotes() + 1);
+          return true;
+        });
+        if (i % 500 == 0) {
+          table.Edit(AddCandidate("T" + std::to_string(t) + "-" + std::to_string(i)));
+        }
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  std::shared_ptr<const CandidateTable> current = table.Current();
+  const int kEdits = kThreads * kEditsPerThread;
+  const int kAdded = kThreads * (kEditsPerThread / 500);
+  CHECK_EQ(current->Find("C01")->GetNumOfVotes(), kEdits);
+  CHECK_EQ(current->candidates.size(), 1u + kAdded);
+  CHECK_EQ(current->version, 1u + kEdits + kAdded);
+  CHECK(attempts.load() >= kEdits);
+}
+
+}  // namespace
+
+int main()
+{
+  TestEdits();
+  TestRetryAfterLostRace();
+  TestConcurrentEdits();
+  return TestResult("candidate_table_test");
+}
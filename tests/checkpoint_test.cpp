@@ -0,0 +1,159 @@
+// Tests of background checkpoints: the files a checkpoint child writes, the
+// dirty state it sets aside, and putting that state back when it fails.
+
+#include "../election.h"
+#include "test_check.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+// Returns the whole contents of a file, or an empty string if it is missing.
+std::string ReadFile(const std::string& path)
+{
+  std::ifstream file(path);
+  std::stringstream contents;
+  contents << file.rdbuf();
+  return contents.str();
+}
+
+// Writes the data files of a small election into the current directory.
+void WriteElection()
+{
+  std::ofstream("Voter.csv") << "123456789124,0\n123456789125,0\n123456789126,1\n";
+  std::ofstream("Candidate.csv") << "C01,Deepak,Fire,R001,0\nC02,Ravi,Water,R002,2\n";
+  std::remove("Voter.delta");
+  std::remove("Candidate.delta");
+}
+
+// Feeds console input to a session and collects what it prints.
+struct Console {
+  std::istringstream input;
+  std::ostringstream output;
+  std::ostringstream errors;
+};
+
+// Casts a vote through the console.
+void Vote(ElectionSystem& election, Console& console, const std::string& candidate, const std::string& voter)
+{
+  console.input.str(candidate + "\n" + voter + "\n");
+  console.input.clear();
+  CHECK(election.CastVote());
+}
+
+// Calls CheckpointIfDue until the running checkpoint is collected, with a
+// time limit.
+void WaitForCheckpoint(ElectionSystem& election, Console& console)
+{
+  for (int i = 0; i < 500; i++) {
+    election.CheckpointIfDue();
+    std::string messages = console.output.str() + console.errors.str();
+    if (messages.find("Checkpoint written") != std::string::npos ||
+        messages.find("Checkpoint failed") != std::string::npos) {
+      return;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  CHECK(false);
+}
+
+void TestCheckpointReaped()
+{
+  WriteElection();
+  Console console;
+  {
+    ElectionSystem election;
+    election.SetConsole(console.input, console.output, console.errors);
+    election.SetCheckpointInterval(0.001);
+    CHECK(election.CandidateCsvCheck());
+    CHECK(election.VoterCsvCheck());
+
+    // Nothing changed, so no checkpoint is started:
+    election.CheckpointIfDue();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    election.CheckpointIfDue();
+    CHECK(console.output.str().find("Checkpoint") == std::string::npos);
+
+    Vote(election, console, "C01", "123456789124");
+    election.CheckpointIfDue();
+    WaitForCheckpoint(election, console);
+    CHECK(console.output.str().find("Checkpoint written") != std::string::npos);
+
+    // The files hold the election as of the fork, and the deltas they
+    // include are gone:
+    CHECK_EQ(ReadFile("Candidate.csv"), "C01,Deepak,Fire,R001,1\nC02,Ravi,Water,R002,2\n");
+    CHECK_EQ(ReadFile("result.csv"), "C02,2\nC01,1\n");
+    CHECK(access("Candidate.delta", F_OK) != 0);
+    CHECK(access("Voter.delta", F_OK) != 0);
+    CHECK(access("Candidate.csv.tmp", F_OK) != 0);
+
+    // A vote after the checkpoint is saved on exit:
+    Vote(election, console, "C01", "123456789125");
+  }
+  CHECK_EQ(ReadFile("Candidate.delta"), "C01,2\n");
+  CHECK_EQ(ReadFile("Candidate.csv"), "C01,Deepak,Fire,R001,1\nC02,Ravi,Water,R002,2\n");
+
+  // The next session starts from both:
+  {
+    ElectionSystem election;
+    election.SetConsole(console.input, console.output, console.errors);
+    CHECK(election.CandidateCsvCheck());
+    CHECK(election.VoterCsvCheck());
+    CHECK_EQ(election.VoterCount(), 3u);
+    Vote(election, console, "C02", "123456789124");
+  }
+  CHECK_EQ(ReadFile("Candidate.delta"), "C01,2\n");
+}
+
+// A checkpoint that cannot write its files hands the changes it covered back,
+// so they are saved on exit.
+void TestCheckpointFailed()
+{
+  WriteElection();
+  CHECK_EQ(mkdir("Candidate.csv.tmp", 0700), 0);
+  Console console;
+  {
+    ElectionSystem election;
+    election.SetConsole(console.input, console.output, console.errors);
+    election.SetCheckpointInterval(60);  // No second attempt in the test
+    CHECK(election.CandidateCsvCheck());
+    CHECK(election.VoterCsvCheck());
+
+    Vote(election, console, "C02", "123456789124");
+    election.CheckpointIfDue();
+    WaitForCheckpoint(election, console);
+    CHECK(console.errors.str().find("Checkpoint failed") != std::string::npos);
+    CHECK(console.output.str().find("Checkpoint written") == std::string::npos);
+    CHECK_EQ(ReadFile("Candidate.csv"), "C01,Deepak,Fire,R001,0\nC02,Ravi,Water,R002,2\n");
+    CHECK(rmdir("Candidate.csv.tmp") == 0);
+  }
+  CHECK_EQ(ReadFile("Candidate.delta"), "C02,3\n");
+  CHECK_EQ(ReadFile("Voter.delta"), "123456789124,1\n");
+}
+
+}  // namespace
+
+int main()
+{
+  char directory[] = "/tmp/checkpoint_test.XXXXXX";
+  if (mkdtemp(directory) == nullptr || chdir(directory) != 0) {
+    std::cerr << "Cannot create a test directory\n";
+    return 1;
+  }
+
+  TestCheckpointReaped();
+  TestCheckpointFailed();
+
+  std::system(("rm -rf " + std::string(directory)).c_str());
+  return TestResult("checkpoint_test");
+}
@@ -0,0 +1,104 @@
+// Tests of the admin password verification records: balloon hash known
+// answers, the text form and its rejection of malformed records.
+
+#include "../credential.h"
+#include "test_check.h"
+
+#include <string>
+
+namespace {
+
+// A record with a known salt and the hash an independent implementation of
+// the same balloon construction computes for the password.
+struct KnownAnswer {
+  const char* password;
+  const char* record;
+};
+
+const KnownAnswer kKnownAnswers[] = {
+  {"password",
+   "balloon$16$1$000102030405060708090a0b0c0d0e0f$"
+   "7ed50d196f536fae7248d90e616dd26e2ca8c42b0120434afbb2359aee7a93a3"},
+  {"correct horse battery",
+   "balloon$64$3$00112233445566778899aabbccddeeff$"
+   "69061a4c98d6c80acb3c938a101d9bb8727e90f283f44f1740651b4c960dfed6"},
+  {"",
+   "balloon$1$1$00000000000000000000000000000000$"
+   "b5243ad467ab8ce5f1e9a6fb316124d42b11cc50ec7bb89664cf9d1c73d685d8"},
+  // A password longer than one SHA-256 block:
+  {"xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx",
+   "balloon$8$2$a5a5a5a5a5a5a5a5a5a5a5a5a5a5a5a5$"
+   "9d9b7378eb24d5ad96248ef367f0f31976e32b3d0c8af9c9beb0354215f9b218"},
+};
+
+void TestKnownAnswers()
+{
+  for (const KnownAnswer& answer : kKnownAnswers) {
+    CredentialRecord record;
+    CHECK(CredentialRecord::Parse(answer.record, record));
+    CHECK(record.Verify(answer.password));
+    CHECK(!record.Verify(std::string(answer.password) + "!"));
+    CHECK_EQ(record.ToString(), answer.record);
+  }
+}
+
+void TestCreate()
+{
+  CredentialRecord record = CredentialRecord::Create("s3cret-pass", 32, 2);
+  CHECK(record.Verify("s3cret-pass"));
+  CHECK(!record.Verify("s3cret-pasS"));
+
+  // The text form reads back to the same record:
+  CredentialRecord parsed;
+  CHECK(CredentialRecord::Parse(record.ToString(), parsed));
+  CHECK_EQ(parsed.ToString(), record.ToString());
+  CHECK(parsed.Verify("s3cret-pass"));
+  CHECK_EQ(record.ToString().rfind("balloon$32$2$", 0), 0u);
+
+  // Every record has a fresh salt:
+  CHECK(CredentialRecord::Create("s3cret-pass", 32, 2).ToString() != record.ToString());
+
+  // Costs outside the limits are clamped, so the record still reads back:
+  CredentialRecord clamped = CredentialRecord::Create("s3cret-pass", 0, CredentialRecord::kMaxTimeCost + 1);
+  CHECK_EQ(clamped.ToString().rfind("balloon$1$64$", 0), 0u);
+  CHECK(CredentialRecord::Parse(clamped.ToString(), parsed));
+  CHECK(parsed.Verify("s3cret-pass"));
+}
+
+void TestParseRejects()
+{
+  const std::string salt = "000102030405060708090a0b0c0d0e0f";
+  const std::string hash = "7ed50d196f536fae7248d90e616dd26e2ca8c42b0120434afbb2359aee7a93a3";
+  CredentialRecord record;
+  CHECK(CredentialRecord::Parse("balloon$16$1$" + salt + "$" + hash, record));
+
+  CHECK(!CredentialRecord::Parse("", record));
+  CHECK(!CredentialRecord::Parse("admin", record));
+  CHECK(!CredentialRecord::Parse("argon2$16$1$" + salt + "$" + hash, record));
+  CHECK(!CredentialRecord::Parse("balloon$16$1$" + salt, record));
+  CHECK(!CredentialRecord::Parse("balloon$x$1$" + salt + "$" + hash, record));
+  CHECK(!CredentialRecord::Parse("balloon$0$1$" + salt + "$" + hash, record));
+  CHECK(!CredentialRecord::Parse("balloon$16$0$" + salt + "$" + hash, record));
+  CHECK(!CredentialRecord::Parse("balloon$16$1$" + salt.substr(2) + "$" + hash, record));
+  CHECK(!CredentialRecord::Parse("balloon$16$1$" + salt + "$" + hash + "00", record));
+  CHECK(!CredentialRecord::Parse("balloon$16$1$" + salt + "$" + hash.substr(0, 63) + "g", record));
+
+  // Costs above the limits are refused, and the limits themselves are not:
+  std::string maxSpace = std::to_string(CredentialRecord::kMaxSpaceCost);
+  std::string maxTime = std::to_string(CredentialRecord::kMaxTimeCost);
+  CHECK(CredentialRecord::Parse("balloon$" + maxSpace + "$" + maxTime + "$" + salt + "$" + hash, record));
+  CHECK(!CredentialRecord::Parse(
+      "balloon$" + std::to_string(CredentialRecord::kMaxSpaceCost + 1ul) + "$1$" + salt + "$" + hash, record));
+  CHECK(!CredentialRecord::Parse(
+      "balloon$16$" + std::to_string(CredentialRecord::kMaxTimeCost + 1) + "$" + salt + "$" + hash, record));
+}
+
+}  // namespace
+
+int main()
+{
+  TestKnownAnswers();
+  TestCreate();
+  TestParseRejects();
+  return TestResult("credential_test");
+}
@@ -0,0 +1,120 @@
+// Tests of the voter and candidate delta files: appending the changes of a
+// session, applying them on the next start and folding them back into the
+// CSV files.
+
+#include "../election.h"
+#include "test_check.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include <unistd.h>
+
+namespace {
+
+// Returns the whole contents of a file, or an empty string if it is missing.
+std::string ReadFile(const std::string& path)
+{
+  std::ifstream file(path);
+  std::stringstream contents;
+  contents << file.rdbuf();
+  return contents.str();
+}
+
+// Writes the data files of a small election into the current directory.
+void WriteElection()
+{
+  std::ofstream("Voter.csv") << "123456789124,0\n123456789125,0\n123456789126,1\n";
+  std::ofstream("Candidate.csv") << "C01,Deepak,Fire,R001,0\nC02,Ravi,Water,R002,2\n";
+  std::remove("Voter.delta");
+  std::remove("Candidate.delta");
+}
+
+// Runs one session that feeds the given console input to an action, and
+// returns the result file written at the end of the session. The prompts of
+// the session are discarded.
+template <typename Action>
+std::string RunSession(const std::string& input, Action action)
+{
+  std::istringstream console(input);
+  std::ostringstream prompts;
+  std::streambuf* savedInput = std::cin.rdbuf(console.rdbuf());
+  std::streambuf* savedOutput = std::cout.rdbuf(prompts.rdbuf());
+  {
+    ElectionSystem election;
+    CHECK(election.CandidateCsvCheck());
+    CHECK(election.VoterCsvCheck());
+    action(election);
+  }
+  std::cin.rdbuf(savedInput);
+  std::cout.rdbuf(savedOutput);
+  return ReadFile("result.csv");
+}
+
+void TestVotesAppendToDeltas()
+{
+  WriteElection();
+  RunSession("C01\n123456789124\n", [](ElectionSystem& e) { CHECK(e.CastVote()); });
+
+  // Only the changed rows were written, and the CSV files are untouched:
+  CHECK_EQ(ReadFile("Voter.delta"), "123456789124,1\n");
+  CHECK_EQ(ReadFile("Candidate.delta"), "C01,1\n");
+  CHECK_EQ(ReadFile("Voter.csv"), "123456789124,0\n123456789125,0\n123456789126,1\n");
+  CHECK_EQ(ReadFile("Candidate.csv"), "C01,Deepak,Fire,R001,0\nC02,Ravi,Water,R002,2\n");
+
+  // The next session starts from the counts in the deltas:
+  std::string results =
+      RunSession("C01\n123456789125\n", [](ElectionSystem& e) { CHECK(e.CastVote()); });
+  CHECK_EQ(ReadFile("Candidate.delta"), "C01,1\nC01,2\n");
+  CHECK(results.find("C01,2") != std::string::npos);
+
+  // A voter of an earlier session cannot vote again:
+  RunSession("C02\n123456789124\n", [](ElectionSystem& e) { e.CastVote(); });
+  CHECK_EQ(ReadFile("Candidate.delta"), "C01,1\nC01,2\n");
+}
+
+void TestStructuralChangeFoldsDelta()
+{
+  WriteElection();
+  RunSession("C01\n123456789124\n", [](ElectionSystem& e) { CHECK(e.CastVote()); });
+  RunSession("C02\n", [](ElectionSystem& e) { CHECK(e.RemoveCandidate()); });
+
+  // Removing a candidate writes the whole file, with the count from the delta:
+  CHECK_EQ(ReadFile("Candidate.csv"), "C01,Deepak,Fire,R001,1\n");
+  CHECK(access("Candidate.delta", F_OK) != 0);
+}
+
+void TestFullRewrite()
+{
+  WriteElection();
+  RunSession("C02\n123456789125\n", [](ElectionSystem& e) {
+    e.SetDeltaPersistence(false);
+    CHECK(e.CastVote());
+  });
+  CHECK_EQ(ReadFile("Candidate.csv"), "C01,Deepak,Fire,R001,0\nC02,Ravi,Water,R002,3\n");
+  CHECK_EQ(ReadFile("Voter.csv"), "123456789124,0\n123456789125,1\n123456789126,1\n");
+  CHECK(access("Candidate.delta", F_OK) != 0);
+  CHECK(access("Voter.delta", F_OK) != 0);
+}
+
+}  // namespace
+
+int main()
+{
+  char directory[] = "/tmp/delta_persistence_test.XXXXXX";
+  if (mkdtemp(directory) == nullptr || chdir(directory) != 0) {
+    std::cerr << "Cannot create a test directory\n";
+    return 1;
+  }
+
+  TestVotesAppendToDeltas();
+  TestStructuralChangeFoldsDelta();
+  TestFullRewrite();
+
+  std::system(("rm -rf " + std::string(directory)).c_str());
+  return TestResult("delta_persistence_test");
+}
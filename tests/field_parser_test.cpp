@@ -0,0 +1,100 @@
+// Tests of the data file field parser: splitting lines, counts and statuses.
+
+#include "../field_parser.h"
+#include "test_check.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+// Returns the fields of a line.
+std::vector<std::string> Split(std::string_view line, char separator = ',')
+{
+  CsvFields fields(line, separator);
+  std::vector<std::string> split;
+  std::string_view field;
+  while (fields.Next(field)) {
+    split.emplace_back(field);
+  }
+  return split;
+}
+
+void TestCsvFields()
+{
+  CHECK(Split("C01,Deepak,Fire,R001,12") ==
+        std::vector<std::string>({"C01", "Deepak", "Fire", "R001", "12"}));
+
+  // Empty fields are kept, but like std::getline an empty line has none and
+  // a trailing separator does not start another:
+  CHECK(Split("C01,,Fire,") == std::vector<std::string>({"C01", "", "Fire"}));
+  CHECK(Split(",5") == std::vector<std::string>({"", "5"}));
+  CHECK(Split("").empty());
+  CHECK(Split(",") == std::vector<std::string>({""}));
+
+  // A Windows line ending is dropped:
+  CHECK(Split("C01,12\r") == std::vector<std::string>({"C01", "12"}));
+  CHECK(Split("\r").empty());
+  CHECK(Split("C01\r,12") == std::vector<std::string>({"C01\r", "12"}));
+
+  CHECK(Split("balloon$16$1", '$') == std::vector<std::string>({"balloon", "16", "1"}));
+}
+
+void TestParseCount()
+{
+  int64_t value = -1;
+  CHECK(ParseCount("0", value));
+  CHECK_EQ(value, 0);
+  CHECK(ParseCount("1520", value));
+  CHECK_EQ(value, 1520);
+  CHECK(ParseCount("007", value));
+  CHECK_EQ(value, 7);
+
+  // Counts beyond 32 bits, up to the largest that fits in 63:
+  CHECK(ParseCount("4294967296", value));
+  CHECK_EQ(value, int64_t{4294967296});
+  CHECK(ParseCount("9223372036854775807", value));
+  CHECK_EQ(value, INT64_MAX);
+
+  // Overflow, signs, blanks and other characters are refused, and the value
+  // is left alone:
+  value = 42;
+  CHECK(!ParseCount("9223372036854775808", value));
+  CHECK(!ParseCount("99999999999999999999999", value));
+  CHECK(!ParseCount("", value));
+  CHECK(!ParseCount("-1", value));
+  CHECK(!ParseCount("+1", value));
+  CHECK(!ParseCount(" 1", value));
+  CHECK(!ParseCount("1 ", value));
+  CHECK(!ParseCount("1,000", value));
+  CHECK(!ParseCount("12a", value));
+  CHECK_EQ(value, 42);
+}
+
+void TestParseStatus()
+{
+  bool status = false;
+  CHECK(ParseStatus("1", status));
+  CHECK(status);
+  CHECK(ParseStatus("0", status));
+  CHECK(!status);
+
+  status = true;
+  CHECK(!ParseStatus("", status));
+  CHECK(!ParseStatus("2", status));
+  CHECK(!ParseStatus("01", status));
+  CHECK(!ParseStatus("yes", status));
+  CHECK(status);
+}
+
+}  // namespace
+
+int main()
+{
+  TestCsvFields();
+  TestParseCount();
+  TestParseStatus();
+  return TestResult("field_parser_test");
+}
@@ -0,0 +1,155 @@
+// Tests of hot reload: diffing edited Candidate.csv and Voter.csv files
+// against the rows last read and applying the added, removed and changed rows.
+
+#include "../election.h"
+#include "test_check.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include <unistd.h>
+
+namespace {
+
+// Returns the whole contents of a file, or an empty string if it is missing.
+std::string ReadFile(const std::string& path)
+{
+  std::ifstream file(path);
+  std::stringstream contents;
+  contents << file.rdbuf();
+  return contents.str();
+}
+
+// Writes the data files of a small election into the current directory.
+void WriteElection()
+{
+  std::ofstream("Voter.csv") << "123456789124,0\n123456789125,0\n123456789126,1\n";
+  std::ofstream("Candidate.csv") << "C01,Deepak,Fire,R001,0\nC02,Ravi,Water,R002,2\nC03,Asha,Earth,R001,1\n";
+  std::remove("Voter.delta");
+  std::remove("Candidate.delta");
+}
+
+// Runs one session with hot reload on that feeds the given console input to
+// an action, and returns what the session printed.
+template <typename Action>
+std::string RunSession(const std::string& input, Action action)
+{
+  std::istringstream console(input);
+  std::ostringstream prompts;
+  std::streambuf* savedInput = std::cin.rdbuf(console.rdbuf());
+  std::streambuf* savedOutput = std::cout.rdbuf(prompts.rdbuf());
+  {
+    ElectionSystem election;
+    election.SetHotReload(true);
+    CHECK(election.CandidateCsvCheck());
+    CHECK(election.VoterCsvCheck());
+    action(election);
+  }
+  std::cin.rdbuf(savedInput);
+  std::cout.rdbuf(savedOutput);
+  return prompts.str();
+}
+
+void TestCandidateDiff()
+{
+  WriteElection();
+  std::string output = RunSession("C01\n123456789124\n", [](ElectionSystem& e) {
+    CHECK(e.CastVote());
+
+    // Another tool drops C03, renames C02 and edits its count, adds C04
+    // and writes a row that is not valid. C01 still shows no votes:
+    std::ofstream("Candidate.csv") << "C01,Deepak,Fire,R001,0\nC02,Ravindra,Water,R002,9\n"
+                                   << "C04,Meena,Air,R002,4\nC05,,Sky,R001,0\n";
+    e.ReloadCandidates();
+  });
+  CHECK(output.find("Reloaded Candidate.csv: 1 added, 1 removed, 1 changed, 1 rows rejected, "
+                    "1 vote count edits ignored\n") != std::string::npos);
+
+  // The vote of the session and the tallied count of C02 are kept, and the
+  // dropped candidate folds Candidate.delta into the file:
+  CHECK_EQ(ReadFile("Candidate.csv"),
+           "C01,Deepak,Fire,R001,1\nC02,Ravindra,Water,R002,2\nC04,Meena,Air,R002,4\n");
+  CHECK(access("Candidate.delta", F_OK) != 0);
+}
+
+void TestUnchangedCandidates()
+{
+  WriteElection();
+  std::string output = RunSession("C02\n123456789125\n", [](ElectionSystem& e) {
+    CHECK(e.CastVote());
+
+    // The file is written again as it was; nothing changes:
+    std::ofstream("Candidate.csv") << "C01,Deepak,Fire,R001,0\nC02,Ravi,Water,R002,2\nC03,Asha,Earth,R001,1\n";
+    e.ReloadCandidates();
+  });
+  CHECK(output.find("Reloaded Candidate.csv: 0 added, 0 removed, 0 changed\n") != std::string::npos);
+
+  // Only the vote of the session went to the delta:
+  CHECK_EQ(ReadFile("Candidate.delta"), "C02,3\n");
+}
+
+void TestVoterDiff()
+{
+  WriteElection();
+  std::string output = RunSession("C01\n123456789124\n", [](ElectionSystem& e) {
+    e.SetDeltaPersistence(false);
+    CHECK(e.CastVote());
+
+    // Another tool drops one voter, clears the status of another, adds a
+    // voter and writes a malformed row. The row of the voter who just
+    // voted is as it was read:
+    std::ofstream("Voter.csv") << "123456789124,0\n123456789126,0\n123456789127,0\n12345,1\n";
+    e.ReloadVoters();
+    CHECK_EQ(e.VoterCount(), 3u);
+    CHECK(e.FindVoter("123456789125") < 0);
+    CHECK(e.FindVoter("123456789127") >= 0);
+  });
+  CHECK(output.find("Reloaded Voter.csv: 1 added, 1 removed, 1 changed, 1 rows rejected\n") !=
+        std::string::npos);
+  CHECK_EQ(ReadFile("Voter.csv"), "123456789124,1\n123456789126,0\n123456789127,0\n");
+}
+
+// More added voters than are inserted one by one are sorted in with the roll.
+void TestManyAddedVoters()
+{
+  WriteElection();
+  std::string output = RunSession("", [](ElectionSystem& e) {
+    e.SetDeltaPersistence(false);
+    std::ofstream file("Voter.csv");
+    file << "123456789124,0\n123456789125,0\n123456789126,1\n";
+    for (int i = 0; i < 200; i++) {
+      file << 200000000000ull + 7919 * (199 - i) << ",0\n";
+    }
+    file.close();
+    e.ReloadVoters();
+    CHECK_EQ(e.VoterCount(), 203u);
+    for (int i = 0; i < 200; i++) {
+      CHECK(e.FindVoter(std::to_string(200000000000ull + 7919 * i)) >= 0);
+    }
+    CHECK(e.FindVoter("123456789126") >= 0);
+  });
+  CHECK(output.find("Reloaded Voter.csv: 200 added, 0 removed, 0 changed\n") != std::string::npos);
+}
+
+}  // namespace
+
+int main()
+{
+  char directory[] = "/tmp/hot_reload_test.XXXXXX";
+  if (mkdtemp(directory) == nullptr || chdir(directory) != 0) {
+    std::cerr << "Cannot create a test directory\n";
+    return 1;
+  }
+
+  TestCandidateDiff();
+  TestUnchangedCandidates();
+  TestVoterDiff();
+  TestManyAddedVoters();
+
+  std::system(("rm -rf " + std::string(directory)).c_str());
+  return TestResult("hot_reload_test");
+}
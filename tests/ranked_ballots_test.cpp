@@ -0,0 +1,176 @@
+// Tests of the ballot store and of instant-runoff and STV counts.
+
+#include "../ranked_ballots.h"
+#include "test_check.h"
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+namespace {
+
+const int64_t kUnit = CountResult::kVoteScale;
+
+// Adds a number of copies of a ballot.
+void AddBallots(BallotStore& ballots, size_t copies, const std::vector<std::string>& ranking)
+{
+  for (size_t i = 0; i < copies; i++) {
+    CHECK(ballots.Add(ranking));
+  }
+}
+
+// Returns a candidate's tally in a round, or -1 if they are not continuing.
+int64_t Tally(const CountRound& round, const std::string& candidateID)
+{
+  for (const auto& entry : round.tallies) {
+    if (entry.first == candidateID) return entry.second;
+  }
+  return -1;
+}
+
+void TestBallotStore()
+{
+  BallotStore ballots;
+  CHECK(!ballots.Add({}));
+  CHECK(!ballots.Add({"A", "B", "A"}));
+  CHECK(ballots.Add({"B", "C"}));
+  CHECK(ballots.Add({"A"}));
+  CHECK_EQ(ballots.Size(), 2u);
+  CHECK_EQ(ballots.Find("C"), 2);
+  CHECK_EQ(ballots.Find("D"), -1);
+
+  size_t length = 0;
+  const BallotStore::Index* row = ballots.Row(0, length);
+  CHECK_EQ(length, 2u);
+  CHECK_EQ(ballots.CandidateID(row[0]), "B");
+  CHECK_EQ(ballots.CandidateID(row[1]), "C");
+
+  // Saving and loading keeps every ballot, and bad lines are counted:
+  std::string path = "/tmp/ranked_ballots_test." + std::to_string(getpid());
+  std::remove(path.c_str());
+  CHECK(ballots.Append(path, 0));
+  std::ofstream(path, std::ios::app) << "C,C\n\n";
+  BallotStore loaded;
+  CHECK_EQ(loaded.Load(path), 2u);
+  CHECK_EQ(loaded.Size(), 2u);
+  row = loaded.Row(1, length);
+  CHECK_EQ(length, 1u);
+  CHECK_EQ(loaded.CandidateID(row[0]), "A");
+  std::remove(path.c_str());
+
+  CHECK_EQ(BallotStore().Load(path), 0u);
+}
+
+void TestParseAndFormat()
+{
+  CountMethod method = CountMethod::kPlurality;
+  size_t seats = 0;
+  CHECK(ParseCountMethod("irv", method, seats));
+  CHECK(method == CountMethod::kInstantRunoff);
+  CHECK(ParseCountMethod("stv:3", method, seats));
+  CHECK(method == CountMethod::kSingleTransferable);
+  CHECK_EQ(seats, 3u);
+  CHECK(!ParseCountMethod("stv:0", method, seats));
+  CHECK(!ParseCountMethod("borda", method, seats));
+
+  CHECK_EQ(FormatVoteValue(1520 * kUnit), "1520");
+  CHECK_EQ(FormatVoteValue(1519 * kUnit + 67 * kUnit / 100), "1519.67");
+  CHECK_EQ(FormatVoteValue(0), "0");
+}
+
+void TestInstantRunoff()
+{
+  // C is excluded first and their ballots elect B, who trailed A at first:
+  BallotStore ballots;
+  AddBallots(ballots, 4, {"A", "B"});
+  AddBallots(ballots, 3, {"B", "A"});
+  AddBallots(ballots, 2, {"C", "B"});
+  AddBallots(ballots, 1, {"C"});
+  CountResult result = CountRankedBallots(ballots, {"A", "B", "C"}, CountMethod::kInstantRunoff, 1);
+  CHECK_EQ(result.rounds.size(), 2u);
+  CHECK_EQ(result.rounds[0].tallies[0].first, "A");
+  CHECK_EQ(Tally(result.rounds[0], "A"), 4 * kUnit);
+  CHECK_EQ(result.rounds[0].excluded, "C");
+  CHECK_EQ(Tally(result.rounds[1], "B"), 5 * kUnit);
+  CHECK_EQ(Tally(result.rounds[1], "C"), -1);
+  CHECK_EQ(result.rounds[1].exhausted, 1 * kUnit);
+  CHECK_EQ(result.winners.size(), 1u);
+  CHECK_EQ(result.winners[0], "B");
+
+  // Preferences for candidates not standing are skipped:
+  BallotStore withdrawn;
+  AddBallots(withdrawn, 3, {"X", "A"});
+  AddBallots(withdrawn, 2, {"B"});
+  result = CountRankedBallots(withdrawn, {"A", "B"}, CountMethod::kInstantRunoff, 1);
+  CHECK_EQ(result.rounds.size(), 1u);
+  CHECK_EQ(Tally(result.rounds[0], "A"), 3 * kUnit);
+  CHECK_EQ(result.winners[0], "A");
+
+  // Ties for exclusion go against fewer first preferences, then the higher ID:
+  BallotStore tied;
+  AddBallots(tied, 2, {"A"});
+  AddBallots(tied, 1, {"B"});
+  AddBallots(tied, 1, {"C", "B"});
+  result = CountRankedBallots(tied, {"A", "B", "C"}, CountMethod::kInstantRunoff, 1);
+  CHECK_EQ(result.rounds.size(), 3u);
+  CHECK_EQ(result.rounds[0].excluded, "C");
+  CHECK_EQ(result.rounds[1].excluded, "B");
+  CHECK_EQ(result.winners[0], "A");
+
+  // Without ballots the last candidate left after the tie breaks wins:
+  result = CountRankedBallots(BallotStore(), {"A", "B"}, CountMethod::kInstantRunoff, 1);
+  CHECK_EQ(result.winners.size(), 1u);
+  CHECK_EQ(result.winners[0], "A");
+}
+
+void TestSingleTransferable()
+{
+  // Quota floor(9 / 3) + 1 = 4: A's surplus of 2 moves to B at 2/6 a ballot,
+  // cut to whole vote units, so B ends just short of the quota and is
+  // elected as the last continuing candidate once C is excluded.
+  BallotStore ballots;
+  AddBallots(ballots, 6, {"A", "B"});
+  AddBallots(ballots, 2, {"B"});
+  AddBallots(ballots, 1, {"C"});
+  CountResult result = CountRankedBallots(ballots, {"A", "B", "C"}, CountMethod::kSingleTransferable, 2);
+  CHECK_EQ(result.quota, 4 * kUnit);
+  CHECK_EQ(result.rounds[0].elected.size(), 1u);
+  CHECK_EQ(result.rounds[0].elected[0], "A");
+  CHECK_EQ(Tally(result.rounds[1], "B"), 2 * kUnit + 6 * (2 * kUnit / 6));
+  CHECK_EQ(result.rounds[1].excluded, "C");
+  CHECK_EQ(result.winners.size(), 2u);
+  CHECK_EQ(result.winners[1], "B");
+
+  // A surplus of 2 over 5 ballots moves at exactly 2/5 a ballot, and a recount
+  // gives the same result:
+  BallotStore fifths;
+  AddBallots(fifths, 5, {"A", "B"});
+  AddBallots(fifths, 1, {"C"});
+  AddBallots(fifths, 1, {"D"});
+  result = CountRankedBallots(fifths, {"A", "B", "C", "D"}, CountMethod::kSingleTransferable, 2);
+  CHECK_EQ(result.quota, 3 * kUnit);
+  CHECK_EQ(Tally(result.rounds[1], "B"), 2 * kUnit);
+  CountResult again = CountRankedBallots(fifths, {"A", "B", "C", "D"}, CountMethod::kSingleTransferable, 2);
+  CHECK(again.winners == result.winners);
+  CHECK_EQ(again.rounds.size(), result.rounds.size());
+  CHECK_EQ(result.winners[0], "A");
+  CHECK_EQ(result.winners[1], "B");
+
+  // More seats than candidates elects everyone standing:
+  result = CountRankedBallots(ballots, {"A", "B", "C"}, CountMethod::kSingleTransferable, 5);
+  CHECK_EQ(result.winners.size(), 3u);
+}
+
+}  // namespace
+
+int main()
+{
+  TestBallotStore();
+  TestParseAndFormat();
+  TestInstantRunoff();
+  TestSingleTransferable();
+  return TestResult("ranked_ballots_test");
+}
@@ -0,0 +1,173 @@
+// Tests of the shared memory results board: what a reader sees as the tally
+// changes, grows and restarts, and that a read is never torn.
+
+#include "../results_board.h"
+#include "test_check.h"
+
+#include <atomic>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace {
+
+const std::string kBoard = "/results_board_test." + std::to_string(getpid());
+
+void AddCandidate(VersionedCandidateTable& table, TallyStore& tally, const std::string& id,
+                  const std::string& name)
+{
+  table.Edit([&](CandidateTable& edited) {
+    edited.candidates.emplace_back(id, name, "Symbol" + id, "R1");
+    edited.ids.insert(id);
+    return true;
+  });
+  tally.Add(id, 0);
+}
+
+// Reads until the board shows a turnout or a second passed.
+bool ReadUntil(ResultsBoardReader& reader, ResultsBoardView& view, int64_t turnout)
+{
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+  while (std::chrono::steady_clock::now() < deadline) {
+    if (reader.Read(view) && view.turnout == turnout) {
+      return true;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return false;
+}
+
+void TestPublish()
+{
+  ResultsBoardReader reader;
+  CHECK(!reader.Open(kBoard));
+
+  TallyStore tally;
+  VersionedCandidateTable table;
+  AddCandidate(table, tally, "C01", "Deepak");
+  AddCandidate(table, tally, "C02", std::string(40, 'x'));
+  tally.Add("C01", 3);
+
+  ResultsBoard board;
+  CHECK(board.Start(kBoard, std::chrono::milliseconds(1), tally, table));
+  CHECK(reader.Open(kBoard));
+  ResultsBoardView view;
+  CHECK(reader.Read(view));
+  CHECK_EQ(view.entries.size(), 2u);
+  CHECK_EQ(view.turnout, 3);
+  CHECK_EQ(std::string(view.entries[0].id), "C01");
+  CHECK_EQ(std::string(view.entries[0].name), "Deepak");
+  CHECK_EQ(std::string(view.entries[0].region), "R1");
+  CHECK_EQ(view.entries[0].votes, 3);
+  CHECK_EQ(std::string(view.entries[1].name), std::string(ResultsBoardEntry::kFieldBytes - 1, 'x'));
+
+  // Votes and renames reach the board:
+  tally.Add("C02", 2);
+  CHECK(ReadUntil(reader, view, 5));
+  CHECK_EQ(view.entries[1].votes, 2);
+  table.Edit([](CandidateTable& edited) {
+    edited.Find("C01")->SetCandidateName("Dilip");
+    return true;
+  });
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+  while (reader.Read(view) && std::string(view.entries[0].name) != "Dilip" &&
+         std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  CHECK_EQ(std::string(view.entries[0].name), "Dilip");
+
+  // More candidates than the board holds move the reader to a larger one:
+  for (int i = 0; i < 2 * static_cast<int>(ResultsBoard::kMinCapacity); i++) {
+    std::string id = "D" + std::to_string(1000 + i);
+    AddCandidate(table, tally, id, "Name" + id);
+    tally.Add(id, 1);
+  }
+  CHECK(ReadUntil(reader, view, 5 + 2 * ResultsBoard::kMinCapacity));
+  CHECK_EQ(view.entries.size(), 2 + 2 * size_t{ResultsBoard::kMinCapacity});
+  CHECK_EQ(std::string(view.entries.back().name), "NameD1127");
+
+  // Stopping publishes the last votes and leaves them on the board:
+  tally.Add("C01", 10);
+  board.Stop();
+  CHECK(reader.Read(view));
+  CHECK_EQ(view.turnout, 15 + 2 * ResultsBoard::kMinCapacity);
+
+  // A new run under the same name retires the old board, and the reader follows:
+  TallyStore restarted;
+  VersionedCandidateTable restartedTable;
+  AddCandidate(restartedTable, restarted, "C09", "Ravi");
+  restarted.Add("C09", 7);
+  CHECK(board.Start(kBoard, std::chrono::milliseconds(1), restarted, restartedTable));
+  CHECK(ReadUntil(reader, view, 7));
+  CHECK_EQ(view.entries.size(), 1u);
+  board.Stop();
+}
+
+// A reader racing the writer always sees counts that add up to the turnout.
+void TestConsistentReads()
+{
+  TallyStore tally;
+  VersionedCandidateTable table;
+  for (int i = 0; i < 8; i++) {
+    AddCandidate(table, tally, "C0" + std::to_string(i), "Name");
+  }
+  ResultsBoard board;
+  CHECK(board.Start(kBoard, std::chrono::milliseconds(0), tally, table));
+
+  std::atomic<bool> voting{true};
+  std::atomic<long> reads{0}, torn{0};
+  std::thread reading([&] {
+    ResultsBoardReader reader;
+    ResultsBoardView view;
+    if (!reader.Open(kBoard)) {
+      torn++;
+      return;
+    }
+    while (voting) {
+      if (!reader.Read(view)) continue;
+      int64_t sum = 0;
+      for (const ResultsBoardEntry& entry : view.entries) {
+        sum += entry.votes;
+      }
+      reads++;
+      torn += sum != view.turnout;
+    }
+  });
+  for (int i = 0; i < 200000; i++) {
+    tally.Add("C0" + std::to_string(i % 8));
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  voting = false;
+  reading.join();
+  board.Stop();
+  CHECK(reads > 0);
+  CHECK_EQ(torn.load(), 0);
+}
+
+void TestForeignSegment()
+{
+  // A segment that is not a board is refused:
+  shm_unlink(kBoard.c_str());
+  int fd = shm_open(kBoard.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+  CHECK(fd >= 0);
+  CHECK_EQ(ftruncate(fd, 4096), 0);
+  close(fd);
+  ResultsBoardReader reader;
+  CHECK(!reader.Open(kBoard));
+}
+
+}  // namespace
+
+int main()
+{
+  shm_unlink(kBoard.c_str());
+  TestPublish();
+  TestConsistentReads();
+  TestForeignSegment();
+  shm_unlink(kBoard.c_str());
+  return TestResult("results_board_test");
+}
@@ -0,0 +1,155 @@
+// Tests of the compressed voter roll archive: round trips over every gap
+// length and block boundary, lookups, and damaged files.
+
+#include "../roll_archive.h"
+#include "test_check.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+namespace {
+
+const std::string kPath = "/tmp/roll_archive_test." + std::to_string(getpid());
+
+struct Voter {
+  uint64_t key;
+  bool voted;
+};
+
+bool Write(const std::vector<Voter>& voters)
+{
+  RollArchiveWriter writer;
+  if (!writer.Open(kPath)) return false;
+  for (const Voter& voter : voters) {
+    writer.Add(voter.key, voter.voted);
+  }
+  return writer.Close() && writer.Size() == voters.size();
+}
+
+// Decodes every block and compares it with the voters written.
+void CheckRoundTrip(const std::vector<Voter>& voters)
+{
+  CHECK(Write(voters));
+  RollArchive archive;
+  CHECK(archive.Open(kPath));
+  CHECK_EQ(archive.Size(), voters.size());
+
+  std::vector<uint64_t> keys;
+  std::vector<uint8_t> statuses;
+  size_t next = 0;
+  for (size_t block = 0; block < archive.BlockCount(); block++) {
+    archive.DecodeBlock(block, keys, statuses);
+    CHECK(keys.size() <= RollArchiveWriter::kBlockVoters);
+    for (size_t i = 0; i < keys.size() && next < voters.size(); i++, next++) {
+      if (keys[i] != voters[next].key || statuses[i] != voters[next].voted) {
+        CHECK_EQ(keys[i], voters[next].key);
+        CHECK_EQ(statuses[i] != 0, voters[next].voted);
+        return;
+      }
+    }
+  }
+  CHECK_EQ(next, voters.size());
+
+  bool voted = false;
+  for (const Voter& voter : voters) {
+    if (!archive.Find(voter.key, voted) || voted != voter.voted) {
+      CHECK(archive.Find(voter.key, voted));
+      return;
+    }
+  }
+}
+
+void TestGapLengths()
+{
+  // Gaps of every encoded length and at each length's limits, with a gap
+  // too wide for four bytes that starts a new block:
+  const uint64_t gaps[] = {0, 1, 255, 256, 65535, 65536, (1u << 24) - 1, 1u << 24, UINT32_MAX,
+                           uint64_t{UINT32_MAX} + 1, 7, 0, 0};
+  std::vector<Voter> voters;
+  uint64_t key = 100000000000;
+  voters.push_back({key, true});
+  for (uint64_t gap : gaps) {
+    key += gap + 1;
+    voters.push_back({key, voters.size() % 3 == 0});
+  }
+  CheckRoundTrip(voters);
+
+  RollArchive archive;
+  CHECK(archive.Open(kPath));
+  CHECK_EQ(archive.BlockCount(), 2u);
+
+  // IDs before, between and after the voters are not found:
+  bool voted = false;
+  CHECK(!archive.Find(voters.front().key - 1, voted));
+  CHECK(!archive.Find(voters[3].key + 1, voted));
+  CHECK(!archive.Find(voters.back().key + 1, voted));
+}
+
+void TestBlockBoundaries()
+{
+  // Full blocks, then a last block whose gaps end in a partial control byte:
+  for (size_t count : {size_t{1}, size_t{2}, size_t{5}, RollArchiveWriter::kBlockVoters,
+                       RollArchiveWriter::kBlockVoters + 1, 3 * RollArchiveWriter::kBlockVoters + 6}) {
+    std::vector<Voter> voters;
+    uint64_t key = 123456789012;
+    for (size_t i = 0; i < count; i++) {
+      key += 1 + (i * 2654435761u) % 100000;
+      voters.push_back({key, i % 5 == 0});
+    }
+    CheckRoundTrip(voters);
+  }
+}
+
+void TestDamagedArchives()
+{
+  // An empty roll is a valid archive:
+  CHECK(Write({}));
+  RollArchive archive;
+  CHECK(archive.Open(kPath));
+  CHECK_EQ(archive.Size(), 0u);
+  bool voted = false;
+  CHECK(!archive.Find(123456789012, voted));
+
+  std::vector<Voter> voters;
+  for (uint64_t i = 0; i < 10000; i++) {
+    voters.push_back({200000000000 + 3 * i, i % 2 == 0});
+  }
+  CHECK(Write(voters));
+  std::string bytes;
+  {
+    std::ifstream file(kPath, std::ios::binary);
+    bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  }
+
+  // A flipped bit anywhere in the blocks or the index fails the checksum:
+  for (size_t offset : {size_t{4}, bytes.size() / 2, bytes.size() - 40}) {
+    std::string damaged = bytes;
+    damaged[offset] ^= 0x10;
+    std::ofstream(kPath, std::ios::binary | std::ios::trunc) << damaged;
+    CHECK(!archive.Open(kPath));
+  }
+
+  // So do a cut short file and a missing one:
+  std::ofstream(kPath, std::ios::binary | std::ios::trunc) << bytes.substr(0, bytes.size() - 1);
+  CHECK(!archive.Open(kPath));
+  std::ofstream(kPath, std::ios::binary | std::ios::trunc) << bytes.substr(0, 10);
+  CHECK(!archive.Open(kPath));
+  std::remove(kPath.c_str());
+  CHECK(!archive.Open(kPath));
+}
+
+}  // namespace
+
+int main()
+{
+  TestGapLengths();
+  TestBlockBoundaries();
+  TestDamagedArchives();
+  std::remove(kPath.c_str());
+  return TestResult("roll_archive_test");
+}
@@ -0,0 +1,33 @@
+#!/bin/sh
+# Builds and runs the tests: every tests/*_test.cpp is compiled against the
+# library sources (everything but main.cpp), and every tests/*_test.sh is run
+# against a freshly built election_system.
+#
+# Usage: tests/run_tests.sh [BUILD_DIR]
+
+set -u
+cd "$(dirname "$0")/.." || exit 1
+build=${1:-/tmp/election_tests}
+mkdir -p "$build"
+
+CXX=${CXX:-g++}
+CXXFLAGS=${CXXFLAGS:--std=c++17 -O2 -Wall -pthread}
+sources=$(ls *.cpp | grep -v '^main\.cpp$')
+
+$CXX $CXXFLAGS main.cpp $sources -o "$build/election_system" || exit 1
+
+failed=0
+for test in tests/*_test.cpp; do
+    name=$(basename "$test" .cpp)
+    if ! $CXX $CXXFLAGS "$test" $sources -o "$build/$name"; then
+        echo "$name: did not build"
+        failed=1
+        continue
+    fi
+    "$build/$name" || failed=1
+done
+for test in tests/*_test.sh; do
+    [ -e "$test" ] || continue
+    sh "$test" "$build/election_system" || failed=1
+done
+exit $failed
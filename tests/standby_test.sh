@@ -0,0 +1,66 @@
+#!/bin/sh
+# Runs a primary and a warm standby on one data directory, kills the primary
+# in the middle of the election and checks that the standby takes over with
+# every vote the primary acknowledged.
+#
+# Usage: tests/standby_test.sh ELECTION_SYSTEM
+
+set -u
+bin=$1
+dir=$(mktemp -d /tmp/standby_test.XXXXXX)
+trap 'kill -9 $primary $standby 2>/dev/null; rm -rf "$dir"' EXIT
+primary=
+standby=
+
+fail() {
+    echo "standby_test: FAILED: $1"
+    for log in "$dir"/*.out; do
+        echo "--- $log"
+        tail -n 20 "$log"
+    done
+    exit 1
+}
+
+# Waits up to five seconds for a line in a log.
+await() {
+    tries=0
+    while ! grep -q "$2" "$1"; do
+        tries=$((tries + 1))
+        [ $tries -le 50 ] || fail "no '$2' in $1"
+        sleep 0.1
+    done
+}
+
+cp "$(dirname "$0")/../Admin.csv" "$dir/"
+printf 'C01,Deepak,Fire,R001,0\nC02,Ravi,Water,R002,2\n' > "$dir/Candidate.csv"
+printf '123456789124,0\n123456789125,0\n123456789126,0\n' > "$dir/Voter.csv"
+mkfifo "$dir/primary.in" "$dir/standby.in"
+
+"$bin" --data-dir="$dir" --replicate < "$dir/primary.in" > "$dir/primary.out" 2>&1 &
+primary=$!
+exec 3> "$dir/primary.in"
+await "$dir/primary.out" "Enter your choice"
+
+"$bin" --data-dir="$dir" --standby --replicate < "$dir/standby.in" > "$dir/standby.out" 2>&1 &
+standby=$!
+exec 4> "$dir/standby.in"
+await "$dir/standby.out" "Standby: following"
+
+printf '2\nC01\n123456789124\n2\nC01\n123456789125\n2\nC02\n123456789126\n' >&3
+await "$dir/primary.out" "Candidate ID: C02"
+
+# The primary dies without saving, so only the log carries the votes:
+kill -9 $primary
+wait $primary 2>/dev/null
+exec 3>&-
+await "$dir/standby.out" "taking over"
+
+# Every voter the primary took a vote from is refused a second one:
+printf '2\nC01\n123456789124\n2\nC01\n123456789125\n2\nC01\n123456789126\n5\n' >&4
+exec 4>&-
+wait $standby || fail "the standby did not exit cleanly"
+
+grep -q '^C01,Deepak,Fire,R001,2$' "$dir/Candidate.csv" || fail "C01 does not have 2 votes"
+grep -q '^C02,Ravi,Water,R002,3$' "$dir/Candidate.csv" || fail "C02 does not have 3 votes"
+[ "$(grep -c 'Voter Already Voted' "$dir/standby.out")" -eq 3 ] || fail "a voter could vote twice"
+echo "standby_test: passed"
@@ -0,0 +1,175 @@
+// Tests of the tally aggregator: hand-made datagrams for retries and
+// restarts, then district processes reporting to one aggregator.
+
+#include "../tally_aggregator.h"
+#include "test_check.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+const std::string kSocket = "/tmp/tally_aggregator_test." + std::to_string(getpid()) + ".sock";
+
+// Returns a merged count, or -1 if the key is not tallied.
+int64_t Lookup(const std::vector<std::pair<std::string, int64_t>>& totals, const std::string& key)
+{
+  for (const auto& entry : totals) {
+    if (entry.first == key) return entry.second;
+  }
+  return -1;
+}
+
+void SendDatagram(const std::string& datagram)
+{
+  int fd = socket(AF_UNIX, SOCK_DGRAM, 0);
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  kSocket.copy(address.sun_path, sizeof(address.sun_path) - 1);
+  sendto(fd, datagram.data(), datagram.size(), 0, reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+  close(fd);
+}
+
+// Receives until the aggregator has applied a number of datagrams or a second passed.
+void ReceiveAll(TallyAggregator& aggregator, size_t datagrams)
+{
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+  size_t applied = 0;
+  while (applied < datagrams && std::chrono::steady_clock::now() < deadline) {
+    applied += aggregator.Receive(std::chrono::milliseconds(10));
+  }
+  aggregator.Receive(std::chrono::milliseconds(10));
+}
+
+void TestRetriesAndRestarts()
+{
+  TallyAggregator aggregator;
+  CHECK(aggregator.Open(kSocket));
+
+  SendDatagram("tally,a,5,1\nC01,R1,Fire,10\nC02,R2,Water,3\n");
+  SendDatagram("tally,a,5,1\nC01,R1,Fire,10\n");  // Repeated.
+  SendDatagram("tally,a,5,3\nC01,R1,Fire,12\n");  // A lost datagram in between is fine.
+  SendDatagram("tally,a,5,2\nC02,R2,Water,99\n");  // Late retry.
+  ReceiveAll(aggregator, 2);
+  CHECK_EQ(aggregator.Total(), 15);
+  CHECK_EQ(Lookup(aggregator.CandidateTotals(), "C01"), 12);
+  CHECK_EQ(Lookup(aggregator.CandidateTotals(), "C02"), 3);
+  CHECK_EQ(aggregator.Duplicates(), 2u);
+
+  // Another node adds to the same candidate, in another region:
+  SendDatagram("tally,b,7,1\nC01,R9,Fire,4\n");
+  ReceiveAll(aggregator, 1);
+  CHECK_EQ(Lookup(aggregator.CandidateTotals(), "C01"), 16);
+  CHECK_EQ(Lookup(aggregator.RegionTotals(), "R9"), 4);
+  CHECK_EQ(aggregator.NodeCount(), 2u);
+
+  // A new generation of a replaces everything a sent, and an old one is ignored:
+  SendDatagram("tally,a,6,1\nC02,R2,Water,1\n");
+  SendDatagram("tally,a,5,4\nC01,R1,Fire,50\n");
+  ReceiveAll(aggregator, 1);
+  CHECK_EQ(aggregator.Total(), 5);
+  CHECK_EQ(Lookup(aggregator.CandidateTotals(), "C01"), 4);
+  CHECK_EQ(Lookup(aggregator.RegionTotals(), "R1"), -1);
+  CHECK_EQ(aggregator.Duplicates(), 3u);
+
+  // A malformed datagram changes nothing, and a removal drops the candidate:
+  SendDatagram("tally,b,7,2\nC01,R9,Fire,-1\nbad\n");
+  SendDatagram("tally,b,7,2\nC01,,,-1\n");
+  ReceiveAll(aggregator, 1);
+  CHECK_EQ(aggregator.Rejected(), 1u);
+  CHECK_EQ(Lookup(aggregator.CandidateTotals(), "C01"), -1);
+  CHECK_EQ(aggregator.Total(), 1);
+  CHECK_EQ(aggregator.CandidateList().size(), 1u);
+}
+
+// Runs a district in a child process: reports votes for its candidates,
+// then stops, which sends the final report.
+pid_t RunDistrict(const std::string& node, const std::string& region, int64_t votes)
+{
+  pid_t child = fork();
+  if (child != 0) {
+    return child;
+  }
+  TallyStore tally;
+  VersionedCandidateTable table;
+  table.Edit([&](CandidateTable& edited) {
+    edited.candidates = {Candidate("C01", "Deepak", "Fire", region), Candidate("C02", "Ravi", "Water", region)};
+    edited.ids = {"C01", "C02"};
+    return true;
+  });
+  TallyReporter reporter;
+  if (!reporter.Start(kSocket, node, std::chrono::milliseconds(5), tally, table)) {
+    _exit(1);
+  }
+  for (int64_t i = 0; i < votes; i++) {
+    tally.Add(i % 3 == 0 ? "C02" : "C01");
+    if (i % 100 == 0) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+  reporter.Stop();
+  _exit(0);
+}
+
+// Keeps receiving while a district runs, as a live aggregator would, and
+// returns whether the district exited cleanly.
+bool Succeeded(TallyAggregator& aggregator, pid_t child)
+{
+  int status = 0;
+  pid_t exited = 0;
+  while ((exited = waitpid(child, &status, WNOHANG)) == 0) {
+    aggregator.Receive(std::chrono::milliseconds(1));
+  }
+  return exited == child && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+// Receives until the national total reaches a value or two seconds passed.
+void ReceiveUntil(TallyAggregator& aggregator, int64_t total)
+{
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+  while (aggregator.Total() != total && std::chrono::steady_clock::now() < deadline) {
+    aggregator.Receive(std::chrono::milliseconds(10));
+  }
+}
+
+void TestDistrictProcesses()
+{
+  TallyAggregator aggregator;
+  CHECK(aggregator.Open(kSocket));
+
+  pid_t north = RunDistrict("north", "R1", 3000);
+  pid_t south = RunDistrict("south", "R2", 1500);
+  CHECK(Succeeded(aggregator, north));
+  CHECK(Succeeded(aggregator, south));
+  ReceiveUntil(aggregator, 4500);
+  CHECK_EQ(aggregator.Total(), 4500);
+  CHECK_EQ(Lookup(aggregator.CandidateTotals(), "C01"), 2000 + 1000);
+  CHECK_EQ(Lookup(aggregator.CandidateTotals(), "C02"), 1000 + 500);
+  CHECK_EQ(Lookup(aggregator.RegionTotals(), "R1"), 3000);
+  CHECK_EQ(Lookup(aggregator.RegionTotals(), "R2"), 1500);
+  CHECK_EQ(aggregator.NodeCount(), 2u);
+
+  // A restarted district replaces its earlier counts instead of adding to them:
+  pid_t restarted = RunDistrict("north", "R1", 300);
+  CHECK(Succeeded(aggregator, restarted));
+  ReceiveUntil(aggregator, 1800);
+  CHECK_EQ(aggregator.Total(), 1800);
+  CHECK_EQ(Lookup(aggregator.RegionTotals(), "R1"), 300);
+  CHECK_EQ(aggregator.NodeCount(), 2u);
+  CHECK_EQ(aggregator.Rejected(), 0u);
+}
+
+}  // namespace
+
+int main()
+{
+  TestRetriesAndRestarts();
+  TestDistrictProcesses();
+  return TestResult("tally_aggregator_test");
+}
@@ -0,0 +1,130 @@
+// Tests of the vote tally: updates, and snapshots taken while writers add
+// votes and candidates.
+
+#include "../tally_store.h"
+#include "test_check.h"
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Returns the sum of the counts in a snapshot.
+int64_t Sum(const TallySnapshot& snapshot)
+{
+  int64_t sum = 0;
+  for (const auto& entry : snapshot.counts) {
+    sum += entry.second;
+  }
+  return sum;
+}
+
+void TestUpdates()
+{
+  TallyStore tally;
+  CHECK_EQ(tally.Get("C01"), 0);
+  CHECK_EQ(tally.Snapshot().counts.size(), 0u);
+
+  tally.Set("C02", 5);
+  CHECK_EQ(tally.Add("C01"), 1);
+  CHECK_EQ(tally.Add("C01", 3), 4);
+  tally.Set("C03", 2);
+  tally.Set("C02", 1);
+  CHECK_EQ(tally.Get("C02"), 1);
+
+  TallySnapshot snapshot = tally.Snapshot();
+  CHECK_EQ(snapshot.turnout, 7);
+  CHECK_EQ(snapshot.counts.size(), 3u);
+  CHECK_EQ(snapshot.counts[0].first, "C01");
+  CHECK_EQ(snapshot.counts[2].first, "C03");
+  CHECK_EQ(snapshot.Find("C01"), 4);
+  CHECK_EQ(snapshot.Find("C04"), 0);
+  CHECK_EQ(snapshot.epoch, 5u);
+
+  // Removing a candidate takes its votes out of the turnout:
+  tally.Remove("C02");
+  tally.Remove("C09");
+  snapshot = tally.Snapshot();
+  CHECK_EQ(snapshot.turnout, 6);
+  CHECK_EQ(snapshot.counts.size(), 2u);
+  CHECK_EQ(snapshot.Find("C01"), 4);
+  CHECK_EQ(snapshot.Find("C03"), 2);
+  CHECK_EQ(tally.Get("C02"), 0);
+}
+
+// Readers snapshot the tally while writers cast votes and add and remove
+// candidates. Every snapshot must add up to its turnout, and the epochs and
+// turnouts a reader sees must never go backwards while only votes are added.
+void TestConcurrentSnapshots()
+{
+  const int kWriters = 4;
+  const int kVotesPerWriter = 20000;
+  const int kReaders = 2;
+
+  TallyStore tally;
+  for (int i = 0; i < 8; i++) {
+    tally.Set("C0" + std::to_string(i), 0);
+  }
+
+  std::atomic<bool> done{false};
+  std::atomic<int> inconsistent{0};
+  std::atomic<int> backwards{0};
+  std::vector<std::thread> readers;
+  for (int r = 0; r < kReaders; r++) {
+    readers.emplace_back([&]() {
+      uint64_t lastEpoch = 0;
+      int64_t lastTurnout = 0;
+      while (!done.load()) {
+        TallySnapshot snapshot = tally.Snapshot();
+        if (Sum(snapshot) != snapshot.turnout) {
+          inconsistent++;
+        }
+        if (snapshot.epoch < lastEpoch || snapshot.turnout < lastTurnout) {
+          backwards++;
+        }
+        lastEpoch = snapshot.epoch;
+        lastTurnout = snapshot.turnout;
+      }
+    });
+  }
+
+  std::vector<std::thread> writers;
+  for (int w = 0; w < kWriters; w++) {
+    writers.emplace_back([&tally, w]() {
+      for (int i = 0; i < kVotesPerWriter; i++) {
+        tally.Add("C0" + std::to_string((i + w) % 8));
+
+        // New candidates publish a new layout under the readers:
+        if (i % 1000 == 0) {
+          tally.Add("N" + std::to_string(w) + "-" + std::to_string(i), 0);
+        }
+      }
+    });
+  }
+  for (std::thread& writer : writers) {
+    writer.join();
+  }
+  done = true;
+  for (std::thread& reader : readers) {
+    reader.join();
+  }
+
+  CHECK_EQ(inconsistent.load(), 0);
+  CHECK_EQ(backwards.load(), 0);
+  TallySnapshot snapshot = tally.Snapshot();
+  CHECK_EQ(snapshot.turnout, int64_t{kWriters} * kVotesPerWriter);
+  CHECK_EQ(Sum(snapshot), snapshot.turnout);
+  CHECK_EQ(snapshot.counts.size(), 8u + kWriters * (kVotesPerWriter / 1000));
+}
+
+}  // namespace
+
+int main()
+{
+  TestUpdates();
+  TestConcurrentSnapshots();
+  return TestResult("tally_store_test");
+}
@@ -0,0 +1,41 @@
+#ifndef TEST_CHECK
+#define TEST_CHECK
+
+#include <iostream>
+
+// Minimal checks for the test programs under tests/. A failed check is
+// printed with its location, and the program exits non-zero at the end.
+
+inline int& FailedChecks()
+{
+    static int failed = 0;
+    return failed;
+}
+
+#define CHECK(condition)                                                                   \
+    do {                                                                                   \
+        if (!(condition)) {                                                                \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: " #condition "\n"; \
+            FailedChecks()++;                                                              \
+        }                                                                                  \
+    } while (false)
+
+#define CHECK_EQ(actual, expected)                                                                   \
+    do {                                                                                             \
+        auto actualValue = (actual);                                                                 \
+        auto expectedValue = (expected);                                                             \
+        if (!(actualValue == expectedValue)) {                                                       \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: " #actual " == " #expected \
+                      << " (" << actualValue << " vs " << expectedValue << ")\n";                 \
+            FailedChecks()++;                                                                        \
+        }                                                                                            \
+    } while (false)
+
+// Returns the exit status of a test program.
+inline int TestResult(const char* name)
+{
+    std::cout << name << (FailedChecks() == 0 ? ": passed\n" : ": FAILED\n");
+    return FailedChecks() == 0 ? 0 : 1;
+}
+
+#endif
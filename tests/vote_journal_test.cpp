@@ -0,0 +1,117 @@
+// Tests of the vote journal and its parallel recount.
+
+#include "../vote_journal.h"
+#include "test_check.h"
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include <unistd.h>
+
+namespace {
+
+const std::string kPath = "/tmp/vote_journal_test." + std::to_string(getpid());
+
+void TestRecords()
+{
+  std::remove(kPath.c_str());
+  {
+    VoteJournal journal;
+    bool created = false;
+    CHECK(journal.Open(kPath, created));
+    CHECK(created);
+    journal.RecordCarry("C01", 5);
+    journal.RecordVote("C01");
+    journal.RecordVote("C02");
+    journal.RecordRemoval("C02");
+    journal.RecordVote("C03");
+  }
+  {
+    VoteJournal journal;
+    bool created = true;
+    CHECK(journal.Open(kPath, created));
+    CHECK(!created);
+    journal.RecordRemoval("C03");
+    journal.RecordVote("C03");  // Standing again, from zero.
+  }
+
+  JournalRecount recount;
+  CHECK(RecountJournal(kPath, 1, recount));
+  CHECK_EQ(recount.records, 7u);
+  CHECK_EQ(recount.votesCast, 9);  // Removals keep the votes cast.
+  CHECK_EQ(recount.candidates["C01"].votes, 6);
+  CHECK_EQ(recount.candidates["C02"].votes, 0);
+  CHECK(!recount.candidates["C02"].standing);
+  CHECK_EQ(recount.candidates["C02"].lastLine, 4u);
+  CHECK_EQ(recount.candidates["C03"].votes, 1);
+  CHECK(recount.candidates["C03"].standing);
+  CHECK(recount.problems.empty());
+
+  // Malformed lines are reported with their line numbers, and a record cut
+  // short at the end is incomplete:
+  std::ofstream(kPath, std::ios::app) << "vote\nvote,C01,2\ncarry,C01,x\ntally,C01\nvote,C01\nvote,C0";
+  CHECK(RecountJournal(kPath, 1, recount));
+  CHECK_EQ(recount.candidates["C01"].votes, 7);
+  CHECK_EQ(recount.problems.size(), 5u);
+  CHECK_EQ(recount.problems[0].line, 8u);
+  CHECK_EQ(recount.problems[3].line, 11u);
+  CHECK_EQ(recount.problems[4].line, 13u);
+  CHECK_EQ(recount.problems[4].message, "incomplete record");
+
+  // An empty journal recounts to nothing, and a missing one is an error:
+  std::ofstream(kPath, std::ios::trunc);
+  CHECK(RecountJournal(kPath, 4, recount));
+  CHECK_EQ(recount.records, 0u);
+  std::remove(kPath.c_str());
+  CHECK(!RecountJournal(kPath, 1, recount));
+}
+
+// Every thread count gives the sequential result, with removals, carries and
+// bad lines falling on either side of the slice boundaries.
+void TestParallelRecount()
+{
+  std::remove(kPath.c_str());
+  {
+    std::ofstream journal(kPath);
+    for (int i = 0; i < 400000; i++) {
+      journal << "vote,C" << i % 7 << '\n';
+      if (i % 50000 == 49999) journal << "remove,C" << i % 3 << '\n';
+      if (i % 70001 == 0) journal << "carry,C6," << i << '\n';
+      if (i % 90001 == 0) journal << "bad line " << i << '\n';
+    }
+  }
+
+  JournalRecount sequential;
+  CHECK(RecountJournal(kPath, 1, sequential));
+  CHECK_EQ(sequential.threads, 1u);
+  CHECK_EQ(sequential.problems.size(), 5u);
+  for (size_t threads : {2, 3, 8, 64}) {
+    JournalRecount parallel;
+    CHECK(RecountJournal(kPath, threads, parallel));
+    CHECK(parallel.threads > 1);
+    CHECK_EQ(parallel.records, sequential.records);
+    CHECK_EQ(parallel.votesCast, sequential.votesCast);
+    CHECK_EQ(parallel.candidates.size(), sequential.candidates.size());
+    for (const auto& entry : sequential.candidates) {
+      const JournalTotal& total = parallel.candidates[entry.first];
+      CHECK_EQ(total.votes, entry.second.votes);
+      CHECK_EQ(total.standing, entry.second.standing);
+      CHECK_EQ(total.lastLine, entry.second.lastLine);
+    }
+    CHECK_EQ(parallel.problems.size(), sequential.problems.size());
+    for (size_t i = 0; i < sequential.problems.size() && i < parallel.problems.size(); i++) {
+      CHECK_EQ(parallel.problems[i].line, sequential.problems[i].line);
+    }
+  }
+  std::remove(kPath.c_str());
+}
+
+}  // namespace
+
+int main()
+{
+  TestRecords();
+  TestParallelRecount();
+  return TestResult("vote_journal_test");
+}
@@ -0,0 +1,98 @@
+// Tests of the fixed-width voter file: writing, mapping, lookups and
+// in-place status updates.
+
+#include "../voter_record_file.h"
+#include "test_check.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+namespace {
+
+// Returns the whole contents of a file.
+std::string ReadFile(const std::string& path)
+{
+  std::ifstream file(path);
+  std::stringstream contents;
+  contents << file.rdbuf();
+  return contents.str();
+}
+
+void TestRoundTrip(const std::string& path)
+{
+  std::vector<Voter> voters = {
+    Voter("923456789124", true),
+    Voter("123456789125"),
+    Voter("523456789126", true),
+  };
+  CHECK(VoterRecordFile::Write(path, voters));
+
+  // The records are sorted and have a fixed width:
+  CHECK_EQ(ReadFile(path), "123456789125,0\n523456789126,1\n923456789124,1\n");
+
+  VoterRecordFile file;
+  CHECK(file.Open(path));
+  CHECK(file.IsOpen());
+  CHECK_EQ(file.Size(), 3u);
+  CHECK_EQ(file.GetAadharID(0), "123456789125");
+  CHECK_EQ(file.GetAadharID(2), "923456789124");
+  CHECK(!file.GetVotingStatus(0));
+  CHECK(file.GetVotingStatus(1));
+
+  CHECK_EQ(file.Find("123456789125"), 0);
+  CHECK_EQ(file.Find("523456789126"), 1);
+  CHECK_EQ(file.Find("923456789124"), 2);
+  CHECK_EQ(file.Find("723456789124"), -1);
+  CHECK_EQ(file.Find("999999999999"), -1);
+
+  // A status change is stored in the file itself:
+  file.SetVotingStatus(0, true);
+  file.SetVotingStatus(2, false);
+  file.Close();
+  CHECK(!file.IsOpen());
+  CHECK_EQ(ReadFile(path), "123456789125,1\n523456789126,1\n923456789124,0\n");
+}
+
+void TestRejectsOtherFormats(const std::string& path)
+{
+  VoterRecordFile file;
+
+  // Unsorted records cannot be searched:
+  std::ofstream(path) << "523456789126,1\n123456789125,0\n";
+  CHECK(!file.Open(path));
+
+  // Nor can rows of another width or with a bad status:
+  std::ofstream(path) << "123456789125,0\n23456789126,1\n";
+  CHECK(!file.Open(path));
+  std::ofstream(path) << "123456789125,2\n";
+  CHECK(!file.Open(path));
+
+  std::remove(path.c_str());
+  CHECK(!file.Open(path));
+  CHECK(!file.IsOpen());
+}
+
+void TestEmptyRoll(const std::string& path)
+{
+  CHECK(VoterRecordFile::Write(path, {}));
+  CHECK_EQ(ReadFile(path), "");
+}
+
+}  // namespace
+
+int main()
+{
+  std::string path = "/tmp/voter_record_file_test." + std::to_string(getpid());
+
+  TestRoundTrip(path);
+  TestRejectsOtherFormats(path);
+  TestEmptyRoll(path);
+
+  std::remove(path.c_str());
+  return TestResult("voter_record_file_test");
+}
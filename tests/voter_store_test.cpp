@@ -0,0 +1,249 @@
+// Tests of the out-of-core voter roll: bulk loading an unsorted roll, page
+// cache eviction, the overlay of added and removed voters, and unreadable
+// pages.
+
+#include "../voter_store.h"
+#include "test_check.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <unistd.h>
+
+namespace {
+
+// Returns the whole contents of a file.
+std::string ReadFile(const std::string& path)
+{
+  std::ifstream file(path);
+  std::stringstream contents;
+  contents << file.rdbuf();
+  return contents.str();
+}
+
+// Checks that a file holds sorted fixed-width records.
+bool IsSortedRecordFile(const std::string& path)
+{
+  std::string contents = ReadFile(path);
+  const size_t size = VoterRecordFile::kRecordSize;
+  if (contents.size() % size != 0) {
+    return false;
+  }
+  for (size_t offset = size; offset < contents.size(); offset += size) {
+    if (contents.compare(offset - size, VoterRecordFile::kAadharLength, contents, offset,
+                         VoterRecordFile::kAadharLength) >= 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Writes a roll in a random order: enough voters for more bulk load runs than
+// one merge pass takes, with a repeated voter and rows that are not valid.
+std::vector<std::string> WriteUnsortedRoll(const std::string& path)
+{
+  std::mt19937_64 random(11);
+  std::uniform_int_distribution<uint64_t> aadhar(100000000000ull, 999999999999ull);
+  std::set<std::string> unique;
+  while (unique.size() < 70000) {
+    unique.insert(std::to_string(aadhar(random)));
+  }
+  std::vector<std::string> voters(unique.begin(), unique.end());
+  std::shuffle(voters.begin(), voters.end(), random);
+
+  std::ofstream file(path);
+  for (size_t i = 0; i < voters.size(); i++) {
+    file << voters[i] << "," << (i % 3 == 0 ? "1" : "0") << "\n";
+    if (i == 100) {
+      file << voters[0] << ",0\n";    // Repeats the first voter.
+      file << "012345678901,0\n";     // Leading zero.
+      file << "12345678901,0\n";      // Too short.
+      file << voters[1] << ",2\n";    // Bad status.
+      file << voters[2] << "\n";      // No status.
+    }
+  }
+  return voters;
+}
+
+void TestBulkLoad(const std::string& path)
+{
+  std::vector<std::string> voters = WriteUnsortedRoll(path);
+
+  VoterStore store;
+  std::vector<std::pair<std::string, std::string>> invalid;
+  CHECK(store.Open(path, 0, invalid));
+  CHECK_EQ(store.Size(), voters.size());
+  CHECK(IsSortedRecordFile(path));
+
+  // The later copy of a repeated voter and the malformed rows are reported:
+  CHECK_EQ(invalid.size(), 5u);
+  std::set<std::pair<std::string, std::string>> reported(invalid.begin(), invalid.end());
+  CHECK_EQ(reported.count({voters[0], "0"}), 1u);
+  CHECK_EQ(reported.count({"012345678901", "0"}), 1u);
+  CHECK_EQ(reported.count({voters[1], "2"}), 1u);
+  CHECK_EQ(reported.count({voters[2], ""}), 1u);
+
+  // The first row of each voter is kept:
+  bool status = false;
+  CHECK(store.GetVotingStatus(voters[0], status));
+  CHECK(status);
+  for (size_t i = 0; i < voters.size(); i += 997) {
+    CHECK(store.GetVotingStatus(voters[i], status));
+    CHECK_EQ(status, i % 3 == 0);
+  }
+  CHECK(store.Close());
+
+  // A sorted roll opens without another bulk load:
+  std::string sorted = ReadFile(path);
+  invalid.clear();
+  CHECK(store.Open(path, 0, invalid));
+  CHECK(invalid.empty());
+  CHECK_EQ(store.Size(), voters.size());
+  CHECK(store.Close());
+  CHECK_EQ(ReadFile(path), sorted);
+}
+
+// Writes a sorted roll of voters 100000000000, 100000000001, ...
+void WriteSortedRoll(const std::string& path, size_t voters)
+{
+  std::ofstream file(path);
+  for (size_t i = 0; i < voters; i++) {
+    file << 100000000000ull + i << ",0\n";
+  }
+}
+
+std::string VoterID(size_t i)
+{
+  return std::to_string(100000000000ull + i);
+}
+
+void TestEviction(const std::string& path)
+{
+  const size_t kVoters = 20 * VoterStore::kRecordsPerPage;
+  WriteSortedRoll(path, kVoters);
+
+  // The smallest cache holds two pages:
+  VoterStore store;
+  std::vector<std::pair<std::string, std::string>> invalid;
+  CHECK(store.Open(path, 0, invalid));
+
+  // Marking a voter on every page evicts dirty pages:
+  for (size_t i = 0; i < kVoters; i += VoterStore::kRecordsPerPage) {
+    CHECK(store.SetVotingStatus(VoterID(i + 1), true));
+  }
+  CHECK_EQ(store.CacheMisses(), 20u);
+
+  // Voters on a cached page hit the cache:
+  uint64_t hits = store.CacheHits();
+  bool status = true;
+  CHECK(store.GetVotingStatus(VoterID(kVoters - 2), status));
+  CHECK(!status);
+  CHECK_EQ(store.CacheMisses(), 20u);
+  CHECK(store.CacheHits() > hits);
+
+  // An evicted page is read again, with the status written back:
+  CHECK(store.GetVotingStatus(VoterID(1), status));
+  CHECK(status);
+  CHECK_EQ(store.CacheMisses(), 21u);
+  CHECK(store.Close());
+
+  CHECK(store.Open(path, 0, invalid));
+  for (size_t i = 0; i < kVoters; i += VoterStore::kRecordsPerPage) {
+    CHECK(store.GetVotingStatus(VoterID(i + 1), status));
+    CHECK(status);
+    CHECK(store.GetVotingStatus(VoterID(i + 2), status));
+    CHECK(!status);
+  }
+  CHECK(store.Close());
+}
+
+void TestOverlay(const std::string& path)
+{
+  WriteSortedRoll(path, 1000);
+
+  VoterStore store;
+  std::vector<std::pair<std::string, std::string>> invalid;
+  CHECK(store.Open(path, 0, invalid));
+  CHECK(!store.Insert(VoterID(10), false));
+  CHECK(store.Insert("999999999999", true));
+  CHECK(!store.Insert(VoterID(500), true));
+  CHECK(store.Insert("150000000000", false));
+  CHECK(store.Erase(VoterID(20)));
+  CHECK(!store.Erase(VoterID(20)));
+  CHECK(!store.Erase("200000000000"));
+  CHECK_EQ(store.Size(), 1001u);
+
+  // Overlay voters are looked up and updated before the file:
+  bool status = false;
+  CHECK(store.GetVotingStatus("999999999999", status));
+  CHECK(status);
+  CHECK(store.SetVotingStatus("150000000000", true));
+  CHECK(!store.Contains(VoterID(20)));
+  CHECK(!store.SetVotingStatus(VoterID(20), true));
+
+  // An erased voter can register again:
+  CHECK(store.Insert(VoterID(20), false));
+  CHECK(store.Erase(VoterID(20)));
+  CHECK_EQ(store.Size(), 1001u);
+  CHECK(store.Close());
+
+  // Close merged the overlay into the sorted file:
+  CHECK(IsSortedRecordFile(path));
+  CHECK(store.Open(path, 0, invalid));
+  CHECK(invalid.empty());
+  CHECK_EQ(store.Size(), 1001u);
+  CHECK(store.GetVotingStatus("150000000000", status));
+  CHECK(status);
+  CHECK(store.Contains("999999999999"));
+  CHECK(!store.Contains(VoterID(20)));
+  CHECK(store.Contains(VoterID(999)));
+  CHECK(store.Close());
+}
+
+// A page that cannot be read is reported and not cached as zeros.
+void TestUnreadablePage(const std::string& path)
+{
+  const size_t kVoters = 4 * VoterStore::kRecordsPerPage;
+  WriteSortedRoll(path, kVoters);
+
+  VoterStore store;
+  std::vector<std::pair<std::string, std::string>> invalid;
+  CHECK(store.Open(path, 0, invalid));
+  CHECK_EQ(truncate(path.c_str(), VoterStore::kPageSize * 2), 0);
+
+  bool status = false;
+  std::string lost = VoterID(3 * VoterStore::kRecordsPerPage);
+  CHECK(!store.GetVotingStatus(lost, status));
+  CHECK(!store.SetVotingStatus(lost, true));
+  CHECK(!store.Insert(lost, false));
+  uint64_t misses = store.CacheMisses();
+  CHECK(!store.GetVotingStatus(lost, status));
+  CHECK_EQ(store.CacheMisses(), misses + 1);
+
+  // Pages that are still there read as before:
+  CHECK(store.GetVotingStatus(VoterID(1), status));
+  CHECK(!status);
+  store.Close();
+}
+
+}  // namespace
+
+int main()
+{
+  std::string path = "/tmp/voter_store_test." + std::to_string(getpid());
+
+  TestBulkLoad(path);
+  TestEviction(path);
+  TestOverlay(path);
+  TestUnreadablePage(path);
+
+  std::remove(path.c_str());
+  return TestResult("voter_store_test");
+}
@@ -0,0 +1,131 @@
+#include "turnout_series.h"
+
+#include <algorithm>
+
+namespace {
+
+// Minute tags keep the low bits of the minute, enough to tell the minutes in
+// a ring apart for decades.
+const uint64_t kTagMask = (uint64_t{1} << 24) - 1;
+
+}  // namespace
+
+TurnoutSeries::TurnoutSeries() : index(std::make_shared<Index>()) {}
+
+// Returns the minute a time falls in, counted from the epoch.
+int64_t TurnoutSeries::MinuteOf(std::chrono::system_clock::time_point time)
+{
+  return std::chrono::duration_cast<std::chrono::minutes>(time.time_since_epoch()).count();
+}
+
+// Records a vote.
+void TurnoutSeries::Record(const std::string& candidateID, const std::string& region, int64_t minute)
+{
+  uint64_t tag = static_cast<uint64_t>(minute) & kTagMask;
+  for (Ring* ring : {&Find(false, candidateID), &Find(true, region)})
+  {
+    std::atomic<uint64_t>& bucket = ring->buckets[static_cast<uint64_t>(minute) % kBuckets];
+    if (bucket.load(std::memory_order_relaxed) >> kCountBits == tag)
+    {
+      bucket.fetch_add(1, std::memory_order_relaxed);
+    }
+    else
+    {
+      // The bucket still counts an earlier pass of the ring:
+      bucket.store(tag << kCountBits | 1, std::memory_order_relaxed);
+    }
+  }
+}
+
+// Returns the votes cast in the last minutes.
+int64_t TurnoutSeries::Recent(Scope scope, const std::string& key, size_t minutes, int64_t now) const
+{
+  int64_t total = 0;
+  for (int64_t count : Counts(scope, key, minutes, now))
+  {
+    total += count;
+  }
+  return total;
+}
+
+// Returns the cumulative votes at the end of each of the last minutes.
+std::vector<int64_t> TurnoutSeries::Curve(Scope scope, const std::string& key, size_t minutes, int64_t now) const
+{
+  std::vector<int64_t> curve = Counts(scope, key, minutes, now);
+  for (size_t i = 1; i < curve.size(); i++)
+  {
+    curve[i] += curve[i - 1];
+  }
+  return curve;
+}
+
+// Returns the candidate IDs or regions that have votes recorded, sorted.
+std::vector<std::string> TurnoutSeries::Keys(Scope scope) const
+{
+  std::shared_ptr<const Index> current = std::atomic_load(&index);
+  std::vector<std::string> keys;
+  for (const auto& entry : scope == Scope::kCandidate ? current->candidates : current->regions)
+  {
+    keys.push_back(entry.first);
+  }
+  return keys;
+}
+
+// Returns the per-minute counts of a query over a window, oldest first.
+std::vector<int64_t> TurnoutSeries::Counts(Scope scope, const std::string& key, size_t minutes, int64_t now) const
+{
+  minutes = std::min(minutes, kBuckets);
+  std::vector<int64_t> counts(minutes, 0);
+  std::shared_ptr<const Index> current = std::atomic_load(&index);
+
+  // Every vote is in exactly one region ring, so they add up to all votes:
+  std::vector<const Ring*> selected;
+  if (scope == Scope::kAll)
+  {
+    for (const auto& entry : current->regions)
+    {
+      selected.push_back(entry.second);
+    }
+  }
+  else
+  {
+    const auto& rings = scope == Scope::kCandidate ? current->candidates : current->regions;
+    auto it = rings.find(key);
+    if (it != rings.end())
+    {
+      selected.push_back(it->second);
+    }
+  }
+
+  for (const Ring* ring : selected)
+  {
+    for (size_t i = 0; i < minutes; i++)
+    {
+      int64_t minute = now - static_cast<int64_t>(minutes - 1 - i);
+      uint64_t bucket = ring->buckets[static_cast<uint64_t>(minute) % kBuckets].load(std::memory_order_relaxed);
+      if (bucket >> kCountBits == (static_cast<uint64_t>(minute) & kTagMask))
+      {
+        counts[i] += static_cast<int64_t>(bucket & kCountMask);
+      }
+    }
+  }
+  return counts;
+}
+
+// Returns a key's ring, publishing an index with a new ring if needed.
+TurnoutSeries::Ring& TurnoutSeries::Find(bool region, const std::string& key)
+{
+  const auto& existing = region ? index->regions : index->candidates;
+  auto it = existing.find(key);
+  if (it != existing.end())
+  {
+    return *it->second;
+  }
+
+  // Readers still holding the old index keep it alive until they finish:
+  rings.push_back(std::make_unique<Ring>());
+  auto next = std::make_shared<Index>(*index);
+  (region ? next->regions : next->candidates)[key] = rings.back().get();
+  std::atomic_store(&index, std::shared_ptr<const Index>(std::move(next)));
+  return *rings.back();
+}
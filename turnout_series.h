@@ -0,0 +1,96 @@
+#ifndef TURNOUT_SERIES
+#define TURNOUT_SERIES
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Per-minute vote counters for live turnout curves.
+//
+// Every candidate and every region has a ring of kBuckets per-minute buckets.
+// A bucket packs the minute it counts above the count itself in one 64 bit
+// atomic, so recording a vote costs one relaxed increment per ring, and a
+// reader always sees a minute together with its own count. A bucket still
+// holding a minute that has left the ring is restarted by the next vote that
+// falls on it, so nothing ever sweeps the rings. Queries read at most one
+// bucket per minute asked for, and never look at voters or the journal.
+//
+// Rings are found through an index published as immutable versions, like the
+// TallyStore layout; a reader keeps the version it loaded alive while rings
+// are added. Writers are serialised by the caller.
+class TurnoutSeries {
+public:
+    static constexpr size_t kBuckets = 1024;  // About 17 hours of minutes.
+
+    // What a query counts.
+    enum class Scope { kCandidate, kRegion, kAll };
+
+    TurnoutSeries();
+
+    TurnoutSeries(const TurnoutSeries&) = delete;
+    TurnoutSeries& operator=(const TurnoutSeries&) = delete;
+
+    // Returns the minute a time falls in, counted from the epoch.
+    static int64_t MinuteOf(std::chrono::system_clock::time_point time);
+
+    // Records a vote.
+    //
+    // Args:
+    //   candidateID: The candidate voted for.
+    //   region: The candidate's region.
+    //   minute: The minute the vote was cast in.
+    void Record(const std::string& candidateID, const std::string& region, int64_t minute);
+
+    // Returns the votes cast in the last minutes.
+    //
+    // Args:
+    //   scope: Whether key names a candidate or a region, or kAll for every vote.
+    //   key: The candidate ID or region.
+    //   minutes: The length of the window, at most kBuckets.
+    //   now: The last minute of the window.
+    int64_t Recent(Scope scope, const std::string& key, size_t minutes, int64_t now) const;
+
+    // Returns the cumulative votes at the end of each of the last minutes,
+    // counted from the start of the window, oldest minute first. The last
+    // entry equals Recent().
+    //
+    // Args:
+    //   scope: Whether key names a candidate or a region, or kAll for every vote.
+    //   key: The candidate ID or region.
+    //   minutes: The length of the window, at most kBuckets.
+    //   now: The last minute of the window.
+    std::vector<int64_t> Curve(Scope scope, const std::string& key, size_t minutes, int64_t now) const;
+
+    // Returns the candidate IDs or regions that have votes recorded, sorted.
+    std::vector<std::string> Keys(Scope scope) const;
+
+private:
+    static const int kCountBits = 40;
+    static const uint64_t kCountMask = (uint64_t{1} << kCountBits) - 1;
+
+    struct Ring {
+        std::atomic<uint64_t> buckets[kBuckets] = {};  // Minute tag << kCountBits | count.
+    };
+
+    struct Index {
+        std::map<std::string, Ring*> candidates;
+        std::map<std::string, Ring*> regions;
+    };
+
+    // Returns a key's ring, publishing an index with a new ring if needed.
+    // Called by writers.
+    Ring& Find(bool region, const std::string& key);
+
+    // Returns the per-minute counts of a query over a window, oldest first.
+    std::vector<int64_t> Counts(Scope scope, const std::string& key, size_t minutes, int64_t now) const;
+
+    std::vector<std::unique_ptr<Ring>> rings;  // Owned rings; never freed before the series.
+    std::shared_ptr<const Index> index;        // Accessed with std::atomic_load/store.
+};
+
+#endif
@@ -0,0 +1,211 @@
+#include "vote_journal.h"
+#include "field_parser.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string_view>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+// Slices smaller than this are not worth a thread of their own.
+const size_t kMinSliceBytes = 1 << 20;
+
+// Recounted votes of one candidate within a slice.
+struct SliceTotal {
+  int64_t votes = 0;
+  bool reset = false;    // A removal in the slice drops the votes before it.
+  bool standing = true;
+  size_t lastLine = 0;   // Line within the slice.
+};
+
+// A slice of whole journal lines and its recount, with slice line numbers.
+struct Slice {
+  const char* begin = nullptr;
+  const char* end = nullptr;
+  std::unordered_map<std::string, SliceTotal> candidates;
+  int64_t votesCast = 0;
+  size_t records = 0;
+  size_t lines = 0;
+  std::vector<JournalProblem> problems;
+};
+
+// Recounts the records of a slice.
+void RecountSlice(Slice& slice)
+{
+  std::string candidateID;
+  const char* position = slice.begin;
+  while (position < slice.end)
+  {
+    size_t line = ++slice.lines;
+    const char* newline = static_cast<const char*>(std::memchr(position, '\n', slice.end - position));
+    if (newline == nullptr)
+    {
+      // Only the last line can lack its end, when a write was cut short:
+      slice.problems.push_back(JournalProblem{line, "incomplete record"});
+      break;
+    }
+    std::string_view text(position, newline - position);
+    position = newline + 1;
+
+    CsvFields fields(text);
+    std::string_view tag, id, count, extra;
+    fields.Next(tag);
+    bool hasID = fields.Next(id) && !id.empty();
+    bool hasCount = fields.Next(count);
+    bool hasExtra = fields.Next(extra);
+    int64_t votes = 1;
+    bool valid = hasID && !hasExtra &&
+                 ((tag == "vote" && !hasCount) || (tag == "remove" && !hasCount) ||
+                  (tag == "carry" && ParseCount(count, votes)));
+    if (!valid)
+    {
+      slice.problems.push_back(JournalProblem{line, "not a journal record: \"" + std::string(text) + "\""});
+      continue;
+    }
+
+    candidateID.assign(id);
+    SliceTotal& total = slice.candidates[candidateID];
+    total.lastLine = line;
+    if (tag == "remove")
+    {
+      total.votes = 0;
+      total.reset = true;
+      total.standing = false;
+    }
+    else
+    {
+      total.votes += votes;
+      total.standing = true;
+      slice.votesCast += votes;
+    }
+    slice.records++;
+  }
+}
+
+}  // namespace
+
+// Opens a journal for appending, creating it if needed.
+bool VoteJournal::Open(const std::string& path, bool& created)
+{
+  struct stat info;
+  created = stat(path.c_str(), &info) != 0 || info.st_size == 0;
+  file.open(path, std::ios::app);
+  return file.is_open();
+}
+
+bool VoteJournal::IsOpen() const { return file.is_open(); }
+
+// Records a vote for a candidate.
+void VoteJournal::RecordVote(const std::string& candidateID)
+{
+  Write("vote," + candidateID + "\n");
+}
+
+// Records votes a candidate already had.
+void VoteJournal::RecordCarry(const std::string& candidateID, int64_t votes)
+{
+  Write("carry," + candidateID + "," + std::to_string(votes) + "\n");
+}
+
+// Records the removal of a candidate and their votes.
+void VoteJournal::RecordRemoval(const std::string& candidateID)
+{
+  Write("remove," + candidateID + "\n");
+}
+
+void VoteJournal::Write(const std::string& record)
+{
+  if (file.is_open())
+  {
+    file << record << std::flush;
+  }
+}
+
+// Recounts a journal with one slice of whole lines per thread.
+bool RecountJournal(const std::string& path, size_t threads, JournalRecount& recount)
+{
+  recount = JournalRecount();
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+  {
+    return false;
+  }
+  struct stat info;
+  if (fstat(fd, &info) != 0)
+  {
+    close(fd);
+    return false;
+  }
+  size_t size = info.st_size;
+  if (size == 0)
+  {
+    close(fd);
+    return true;
+  }
+  void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED)
+  {
+    return false;
+  }
+  madvise(mapping, size, MADV_SEQUENTIAL);
+  const char* data = static_cast<const char*>(mapping);
+
+  // Cut the file into slices that end at line ends:
+  threads = std::max<size_t>(1, std::min(threads, size / kMinSliceBytes + 1));
+  recount.threads = threads;
+  std::vector<Slice> slices(threads);
+  const char* start = data;
+  for (size_t i = 0; i < threads; i++)
+  {
+    const char* end = data + size * (i + 1) / threads;
+    if (end < data + size)
+    {
+      const char* newline = static_cast<const char*>(std::memchr(end, '\n', data + size - end));
+      end = newline == nullptr ? data + size : newline + 1;
+    }
+    slices[i].begin = start;
+    slices[i].end = std::max(start, end);
+    start = slices[i].end;
+  }
+
+  std::vector<std::thread> workers;
+  for (size_t i = 1; i < threads; i++)
+  {
+    workers.emplace_back(RecountSlice, std::ref(slices[i]));
+  }
+  RecountSlice(slices[0]);
+  for (std::thread& worker : workers)
+  {
+    worker.join();
+  }
+  munmap(mapping, size);
+
+  // Combine the slices in file order:
+  size_t firstLine = 0;
+  for (Slice& slice : slices)
+  {
+    for (auto& entry : slice.candidates)
+    {
+      JournalTotal& total = recount.candidates[entry.first];
+      total.votes = entry.second.reset ? entry.second.votes : total.votes + entry.second.votes;
+      total.standing = entry.second.standing;
+      total.lastLine = firstLine + entry.second.lastLine;
+    }
+    for (JournalProblem& problem : slice.problems)
+    {
+      problem.line += firstLine;
+      recount.problems.push_back(std::move(problem));
+    }
+    recount.votesCast += slice.votesCast;
+    recount.records += slice.records;
+    firstLine += slice.lines;
+  }
+  return true;
+}
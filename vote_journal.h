@@ -0,0 +1,87 @@
+#ifndef VOTE_JOURNAL
+#define VOTE_JOURNAL
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Append-only journal of every change to the vote tallies, from which the
+// stored totals can be recounted independently.
+//
+// Each line is one record:
+//   vote,<candidate ID>           A vote was cast for the candidate.
+//   carry,<candidate ID>,<votes>  Votes the candidate had when the journal was
+//                                 started, or brought in by a repaired row.
+//   remove,<candidate ID>         The candidate was removed with their votes.
+// Records name the candidate only, never the voter, so the journal keeps the
+// ballot secret. Every record is flushed as soon as it is written.
+class VoteJournal {
+public:
+    // Opens a journal for appending, creating it if needed.
+    //
+    // Args:
+    //   path: The journal file.
+    //   created: Receives true if the journal did not exist or was empty.
+    //
+    // Returns:
+    //   true if the journal is open, false otherwise.
+    bool Open(const std::string& path, bool& created);
+
+    bool IsOpen() const;
+
+    // Records a vote for a candidate.
+    void RecordVote(const std::string& candidateID);
+
+    // Records votes a candidate already had.
+    void RecordCarry(const std::string& candidateID, int64_t votes);
+
+    // Records the removal of a candidate and their votes.
+    void RecordRemoval(const std::string& candidateID);
+
+private:
+    void Write(const std::string& record);
+
+    std::ofstream file;
+};
+
+
+// Recounted votes of one candidate.
+struct JournalTotal {
+    int64_t votes = 0;
+    bool standing = true;  // false if the candidate's last record removed them.
+    size_t lastLine = 0;   // 1-based line of the candidate's last record.
+};
+
+// A journal line that is not a valid record.
+struct JournalProblem {
+    size_t line;  // 1-based.
+    std::string message;
+};
+
+// Outcome of a journal recount.
+struct JournalRecount {
+    std::unordered_map<std::string, JournalTotal> candidates;
+    int64_t votesCast = 0;  // Vote records plus carried votes; removals keep them.
+    size_t records = 0;     // Valid records.
+    size_t threads = 0;     // Threads the recount ran on.
+    std::vector<JournalProblem> problems;  // In line order.
+};
+
+// Recounts a journal. The file is mapped and split into one slice of whole
+// lines per thread; every thread recounts its slice on its own, and the
+// slices are then combined in file order, so the result is the same as a
+// sequential recount for any number of threads.
+//
+// Args:
+//   path: The journal file.
+//   threads: The number of threads to recount with.
+//   recount: Receives the recounted totals.
+//
+// Returns:
+//   true if the journal was read, false if it could not be opened.
+bool RecountJournal(const std::string& path, size_t threads, JournalRecount& recount);
+
+#endif
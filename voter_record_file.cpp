@@ -0,0 +1,177 @@
+#include "voter_record_file.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+VoterRecordFile::~VoterRecordFile() { Close(); }
+
+// Maps a voter file for in-place updates.
+//
+// Args:
+//   path: The voter file to map.
+//
+// Returns:
+//   true if the file consists of sorted fixed-width records, false otherwise.
+bool VoterRecordFile::Open(const std::string& path)
+{
+  Close();
+
+  fd = open(path.c_str(), O_RDWR);
+  if (fd < 0)
+  {
+    return false;
+  }
+
+  struct stat info;
+  if (fstat(fd, &info) != 0 || info.st_size == 0 ||
+      static_cast<size_t>(info.st_size) % kRecordSize != 0)
+  {
+    Close();
+    return false;
+  }
+
+  void* mapping = mmap(nullptr, info.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (mapping == MAP_FAILED)
+  {
+    Close();
+    return false;
+  }
+  base = static_cast<char*>(mapping);
+  records = info.st_size / kRecordSize;
+
+  // Check the layout and the ordering, which the lookups rely on:
+  for (size_t i = 0; i < records; i++)
+  {
+    const char* record = base + i * kRecordSize;
+    bool layout = record[kAadharLength] == ',' && record[kRecordSize - 1] == '\n' &&
+                  (record[kStatusOffset] == '0' || record[kStatusOffset] == '1');
+    bool sorted = i == 0 || std::memcmp(record - kRecordSize, record, kAadharLength) < 0;
+    if (!layout || !sorted)
+    {
+      Close();
+      return false;
+    }
+  }
+  return true;
+}
+
+// Flushes and unmaps the file.
+void VoterRecordFile::Close()
+{
+  if (base != nullptr)
+  {
+    msync(base, records * kRecordSize, MS_SYNC);
+    munmap(base, records * kRecordSize);
+    base = nullptr;
+  }
+  if (fd >= 0)
+  {
+    close(fd);
+    fd = -1;
+  }
+  records = 0;
+}
+
+bool VoterRecordFile::IsOpen() const { return base != nullptr; }
+size_t VoterRecordFile::Size() const { return records; }
+
+// Finds the record of a voter.
+//
+// Args:
+//   aadhar: The voter's Aadhar ID.
+//
+// Returns:
+//   The record number, or -1 if the voter is not in the file.
+long VoterRecordFile::Find(const std::string& aadhar) const
+{
+  if (base == nullptr || aadhar.length() != kAadharLength)
+  {
+    return -1;
+  }
+
+  size_t low = 0, high = records;
+  while (low < high)
+  {
+    size_t mid = low + (high - low) / 2;
+    int order = std::memcmp(base + mid * kRecordSize, aadhar.data(), kAadharLength);
+    if (order == 0)
+    {
+      return static_cast<long>(mid);
+    }
+    if (order < 0)
+    {
+      low = mid + 1;
+    }
+    else
+    {
+      high = mid;
+    }
+  }
+  return -1;
+}
+
+std::string VoterRecordFile::GetAadharID(size_t record) const
+{
+  return std::string(base + record * kRecordSize, kAadharLength);
+}
+
+bool VoterRecordFile::GetVotingStatus(size_t record) const
+{
+  return base[record * kRecordSize + kStatusOffset] == '1';
+}
+
+// Updates the status byte of a record in place.
+void VoterRecordFile::SetVotingStatus(size_t record, bool status)
+{
+  base[record * kRecordSize + kStatusOffset] = status ? '1' : '0';
+}
+
+// Writes voters as sorted fixed-width records.
+//
+// Args:
+//   path: The file to write.
+//   voters: The voters to write, in any order.
+//
+// Returns:
+//   true if the file was written, false otherwise.
+bool VoterRecordFile::Write(const std::string& path, const std::vector<Voter>& voters)
+{
+  std::ofstream outputFile(path, std::ios::binary);
+  if (!outputFile.is_open())
+  {
+    return false;
+  }
+
+  std::vector<size_t> order(voters.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&voters](size_t a, size_t b) {
+    return voters[a].GetAadharID() < voters[b].GetAadharID();
+  });
+
+  // Emit the records through a fixed-size buffer:
+  std::string buffer;
+  buffer.reserve(4096 * kRecordSize);
+  for (size_t index : order)
+  {
+    buffer += voters[index].GetAadharID();
+    buffer += ',';
+    buffer += voters[index].GetVotingStatus() ? '1' : '0';
+    buffer += '\n';
+    if (buffer.size() >= 4096 * kRecordSize)
+    {
+      outputFile.write(buffer.data(), buffer.size());
+      buffer.clear();
+    }
+  }
+  outputFile.write(buffer.data(), buffer.size());
+
+  outputFile.close();
+  return static_cast<bool>(outputFile);
+}
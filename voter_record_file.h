@@ -0,0 +1,76 @@
+#ifndef VOTER_RECORD_FILE
+#define VOTER_RECORD_FILE
+
+#include "voter.h"
+#include "field_rules.h"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Fixed-width, sorted on-disk voter roll.
+//
+// Every record is "aadhaar,status\n", so record i starts at byte i * kRecordSize
+// and its status byte sits at a computable offset. Records are sorted by Aadhar
+// ID, which makes the file its own index: lookups binary search the mapped
+// records and a status change is a single byte store into the mapped page.
+// The format is a valid Voter.csv.
+class VoterRecordFile {
+public:
+    static const size_t kAadharLength = ActiveRules::kAadhar.maxLength;
+    static const size_t kRecordSize = kAadharLength + 3;  // aadhaar + ',' + status + '\n'
+    static const size_t kStatusOffset = kAadharLength + 1;
+
+    VoterRecordFile() = default;
+    ~VoterRecordFile();
+
+    VoterRecordFile(const VoterRecordFile&) = delete;
+    VoterRecordFile& operator=(const VoterRecordFile&) = delete;
+
+    // Maps a voter file for in-place updates.
+    //
+    // Args:
+    //   path: The voter file to map.
+    //
+    // Returns:
+    //   true if the file consists of sorted fixed-width records, false otherwise.
+    bool Open(const std::string& path);
+
+    // Flushes and unmaps the file.
+    void Close();
+
+    bool IsOpen() const;
+    size_t Size() const;
+
+    // Finds the record of a voter.
+    //
+    // Args:
+    //   aadhar: The voter's Aadhar ID.
+    //
+    // Returns:
+    //   The record number, or -1 if the voter is not in the file.
+    long Find(const std::string& aadhar) const;
+
+    std::string GetAadharID(size_t record) const;
+    bool GetVotingStatus(size_t record) const;
+
+    // Updates the status byte of a record in place.
+    void SetVotingStatus(size_t record, bool status);
+
+    // Writes voters as sorted fixed-width records.
+    //
+    // Args:
+    //   path: The file to write.
+    //   voters: The voters to write, in any order.
+    //
+    // Returns:
+    //   true if the file was written, false otherwise.
+    static bool Write(const std::string& path, const std::vector<Voter>& voters);
+
+private:
+    int fd = -1;
+    char* base = nullptr;
+    size_t records = 0;
+};
+
+#endif
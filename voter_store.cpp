@@ -0,0 +1,640 @@
+#include "voter_store.h"
+#include "aadhar_index.h"
+#include "field_rules.h"
+#include "field_parser.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <queue>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const size_t kAadharLength = VoterRecordFile::kAadharLength;
+const size_t kRecordSize = VoterRecordFile::kRecordSize;
+const size_t kStatusOffset = VoterRecordFile::kStatusOffset;
+
+// Sequential I/O is done in blocks of this many pages.
+const size_t kBlockPages = 256;
+
+// Bulk load runs merged at once; more runs are merged in several passes, so a
+// large roll never needs a file descriptor per run.
+const size_t kMaxFanIn = 64;
+
+// A voter row of a bulk load run: the packed Aadhar ID, then the row number
+// times two plus the voting status, so equal IDs sort in file order.
+struct RunEntry {
+  uint64_t key;
+  uint64_t order;
+};
+
+bool operator<(const RunEntry& a, const RunEntry& b)
+{
+  return a.key != b.key ? a.key < b.key : a.order < b.order;
+}
+
+// Formats a packed Aadhar ID as a fixed-width record.
+void FormatRecord(uint64_t key, bool status, char* record)
+{
+  for (size_t i = kAadharLength; i-- > 0; key /= 10)
+  {
+    record[i] = static_cast<char>('0' + key % 10);
+  }
+  record[kAadharLength] = ',';
+  record[kStatusOffset] = status ? '1' : '0';
+  record[kRecordSize - 1] = '\n';
+}
+
+bool IsRecord(const char* record)
+{
+  return record[kAadharLength] == ',' && record[kRecordSize - 1] == '\n' &&
+         (record[kStatusOffset] == '0' || record[kStatusOffset] == '1') &&
+         std::all_of(record, record + kAadharLength, [](char c) { return c >= '0' && c <= '9'; });
+}
+
+// Merges sorted bulk load runs.
+//
+// Args:
+//   runs: The run files.
+//   emit: Called with every entry in order; returns false to stop on an error.
+//
+// Returns:
+//   true if every run was read and emitted, false otherwise.
+bool MergeRuns(const std::vector<std::string>& runs, const std::function<bool(const RunEntry&)>& emit)
+{
+  std::vector<std::ifstream> runFiles;
+  using Head = std::pair<RunEntry, size_t>;
+  auto later = [](const Head& a, const Head& b) { return b.first < a.first; };
+  std::priority_queue<Head, std::vector<Head>, decltype(later)> heads(later);
+  for (const std::string& runPath : runs)
+  {
+    runFiles.emplace_back(runPath, std::ios::binary);
+    if (!runFiles.back().is_open())
+    {
+      return false;
+    }
+  }
+  auto advance = [&](size_t index) {
+    RunEntry entry;
+    if (runFiles[index].read(reinterpret_cast<char*>(&entry), sizeof(entry)))
+    {
+      heads.emplace(entry, index);
+    }
+  };
+  for (size_t i = 0; i < runFiles.size(); i++)
+  {
+    advance(i);
+  }
+
+  while (!heads.empty())
+  {
+    RunEntry entry = heads.top().first;
+    size_t index = heads.top().second;
+    heads.pop();
+    advance(index);
+    if (!emit(entry))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+VoterStore::~VoterStore() { Close(); }
+
+// Opens a voter roll, converting it to the sorted record format first if needed.
+bool VoterStore::Open(const std::string& path, size_t cacheBytes,
+                      std::vector<std::pair<std::string, std::string>>& invalid)
+{
+  Close();
+  this->path = path;
+  this->cacheBytes = std::max(cacheBytes, 2 * kPageSize);
+  cachePages = this->cacheBytes / kPageSize;
+
+  if (!Scan() && !BulkLoad(invalid))
+  {
+    return false;
+  }
+
+  fd = open(path.c_str(), O_RDWR);
+  count = records;
+  return fd >= 0;
+}
+
+// Writes back dirty pages, merges the overlay into the file and closes it.
+bool VoterStore::Close()
+{
+  if (fd < 0)
+  {
+    return true;
+  }
+
+  bool written = true;
+  for (Page& page : pages)
+  {
+    written = WriteBack(page) && written;
+  }
+  pages.clear();
+  pageIndex.clear();
+  close(fd);
+  fd = -1;
+
+  if (!overlay.empty())
+  {
+    written = MergeOverlay() && written;
+    overlay.clear();
+  }
+  pageKeys.clear();
+  records = count = 0;
+  return written;
+}
+
+bool VoterStore::IsOpen() const { return fd >= 0; }
+
+// Returns the number of registered voters.
+size_t VoterStore::Size() const { return count; }
+
+// Returns the number of voters marked as voted.
+size_t VoterStore::CountVoted()
+{
+  size_t voted = 0;
+  Visit([&voted](std::string_view, bool status) { voted += status; });
+  return voted;
+}
+
+// Calls a function for every registered voter in Aadhar ID order, by one
+// sequential pass over the file merged with the overlay.
+void VoterStore::Visit(const std::function<void(std::string_view aadhar, bool status)>& visitor)
+{
+  // Status changes still in the cache must be in the file for the pass:
+  for (Page& page : pages)
+  {
+    WriteBack(page);
+  }
+
+  // The overlay decides for the voters in it; its IDs are sorted like the file:
+  auto overlaid = overlay.begin();
+  auto visitOverlaid = [&](const std::string& aadhar, int value) {
+    if (value != kErased)
+    {
+      visitor(aadhar, value == 1);
+    }
+  };
+  std::vector<char> block(kBlockPages * kPageSize);
+  for (size_t offset = 0; offset < records * kRecordSize; offset += block.size())
+  {
+    size_t length = std::min(block.size(), records * kRecordSize - offset);
+    if (pread(fd, block.data(), length, offset) != static_cast<ssize_t>(length))
+    {
+      break;
+    }
+    for (const char* record = block.data(); record < block.data() + length; record += kRecordSize)
+    {
+      while (overlaid != overlay.end() && std::memcmp(overlaid->first.data(), record, kAadharLength) < 0)
+      {
+        visitOverlaid(overlaid->first, overlaid->second);
+        overlaid++;
+      }
+      if (overlaid != overlay.end() && std::memcmp(overlaid->first.data(), record, kAadharLength) == 0)
+      {
+        visitOverlaid(overlaid->first, overlaid->second);
+        overlaid++;
+        continue;
+      }
+      visitor(std::string_view(record, kAadharLength), record[kStatusOffset] == '1');
+    }
+  }
+  for (; overlaid != overlay.end(); overlaid++)
+  {
+    visitOverlaid(overlaid->first, overlaid->second);
+  }
+}
+
+bool VoterStore::Contains(const std::string& aadhar)
+{
+  bool status;
+  return GetVotingStatus(aadhar, status);
+}
+
+// Looks up the voting status of a voter.
+bool VoterStore::GetVotingStatus(const std::string& aadhar, bool& status)
+{
+  auto it = overlay.find(aadhar);
+  if (it != overlay.end())
+  {
+    status = it->second == 1;
+    return it->second != kErased;
+  }
+  long record = FindRecord(aadhar);
+  const char* data = record < 0 ? nullptr : Record(record, false);
+  if (data == nullptr)
+  {
+    return false;
+  }
+  status = data[kStatusOffset] == '1';
+  return true;
+}
+
+// Updates the voting status of a registered voter.
+bool VoterStore::SetVotingStatus(const std::string& aadhar, bool status)
+{
+  auto it = overlay.find(aadhar);
+  if (it != overlay.end())
+  {
+    if (it->second == kErased)
+    {
+      return false;
+    }
+    it->second = status;
+    return true;
+  }
+  long record = FindRecord(aadhar);
+  char* data = record < 0 ? nullptr : Record(record, true);
+  if (data == nullptr)
+  {
+    return false;
+  }
+  data[kStatusOffset] = status ? '1' : '0';
+  return true;
+}
+
+// Registers a voter.
+bool VoterStore::Insert(const std::string& aadhar, bool status)
+{
+  // A voter whose page cannot be read may already be registered:
+  auto it = overlay.find(aadhar);
+  if (it != overlay.end() ? it->second != kErased : FindRecord(aadhar) != kNotFound)
+  {
+    return false;
+  }
+  overlay[aadhar] = status;
+  count++;
+  return true;
+}
+
+// Removes a voter.
+bool VoterStore::Erase(const std::string& aadhar)
+{
+  if (!Contains(aadhar))
+  {
+    return false;
+  }
+  overlay[aadhar] = kErased;
+  count--;
+  return true;
+}
+
+uint64_t VoterStore::CacheHits() const { return hits; }
+uint64_t VoterStore::CacheMisses() const { return misses; }
+
+// Checks that the file holds sorted records and builds the page keys.
+bool VoterStore::Scan()
+{
+  std::ifstream inputFile(path, std::ios::binary);
+  if (!inputFile.is_open())
+  {
+    return false;
+  }
+
+  pageKeys.clear();
+  records = 0;
+  std::vector<char> block(kBlockPages * kPageSize);
+  char previous[kAadharLength] = {};
+  while (inputFile)
+  {
+    inputFile.read(block.data(), block.size());
+    size_t length = inputFile.gcount();
+    if (length % kRecordSize != 0)
+    {
+      return false;
+    }
+    for (size_t offset = 0; offset < length; offset += kRecordSize, records++)
+    {
+      const char* record = block.data() + offset;
+      if (!IsRecord(record) || !MatchesField<ActiveRules::kAadhar>(std::string_view(record, kAadharLength)) ||
+          (records > 0 && std::memcmp(previous, record, kAadharLength) >= 0))
+      {
+        return false;
+      }
+      if (records % kRecordsPerPage == 0)
+      {
+        pageKeys.push_back(PackAadhar(std::string(record, kAadharLength)));
+      }
+      std::memcpy(previous, record, kAadharLength);
+    }
+  }
+  return records > 0;
+}
+
+// Converts the file to sorted records with an external merge sort.
+bool VoterStore::BulkLoad(std::vector<std::pair<std::string, std::string>>& invalid)
+{
+  std::ifstream inputFile(path);
+  if (!inputFile.is_open())
+  {
+    return false;
+  }
+
+  // Write sorted runs of at most the cache size:
+  std::vector<std::string> runs;
+  size_t runNames = 0;
+  std::vector<RunEntry> run;
+  size_t runLength = std::max<size_t>(cacheBytes / sizeof(RunEntry), 1024);
+  run.reserve(runLength);
+  auto flushRun = [&]() {
+    if (run.empty())
+    {
+      return true;
+    }
+    std::sort(run.begin(), run.end());
+    runs.push_back(path + ".run" + std::to_string(runNames++));
+    std::ofstream runFile(runs.back(), std::ios::binary);
+    runFile.write(reinterpret_cast<const char*>(run.data()), run.size() * sizeof(RunEntry));
+    run.clear();
+    return static_cast<bool>(runFile);
+  };
+
+  bool written = true;
+  uint64_t row = 0;
+  std::string line;
+  while (written && std::getline(inputFile, line))
+  {
+    CsvFields fields(line);
+    std::string_view aadhar, status;
+    bool voted = false;
+    if (!fields.Next(aadhar))
+    {
+      continue;  // Aadhar is essential.
+    }
+    if (!fields.Next(status))
+    {
+      if (!aadhar.empty())
+      {
+        invalid.emplace_back(aadhar, "");
+      }
+      continue;
+    }
+    if (!MatchesField<ActiveRules::kAadhar>(aadhar) || !ParseStatus(status, voted))
+    {
+      invalid.emplace_back(aadhar, status);
+      continue;
+    }
+    run.push_back({PackAadhar(aadhar), row++ * 2 + voted});
+    if (run.size() == runLength)
+    {
+      written = flushRun();
+    }
+  }
+  written = written && flushRun();
+  inputFile.close();
+
+  // Merge at most kMaxFanIn runs at a time until a single pass is left:
+  while (runs.size() > kMaxFanIn)
+  {
+    std::vector<std::string> merged;
+    for (size_t first = 0; first < runs.size(); first += kMaxFanIn)
+    {
+      std::vector<std::string> group(runs.begin() + first,
+                                     runs.begin() + std::min(first + kMaxFanIn, runs.size()));
+      if (written)
+      {
+        merged.push_back(path + ".run" + std::to_string(runNames++));
+        std::ofstream runFile(merged.back(), std::ios::binary);
+        written = MergeRuns(group, [&runFile](const RunEntry& entry) {
+          runFile.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+          return static_cast<bool>(runFile);
+        });
+        runFile.close();
+        written = written && static_cast<bool>(runFile);
+      }
+      for (const std::string& runPath : group)
+      {
+        std::remove(runPath.c_str());
+      }
+    }
+    runs.swap(merged);
+  }
+
+  // Merge the runs into the record file, keeping the first row of each ID:
+  std::string temporary = path + ".tmp";
+  std::ofstream outputFile(temporary, std::ios::binary);
+  std::vector<char> block;
+  block.reserve(kBlockPages * kPageSize);
+  pageKeys.clear();
+  records = 0;
+  uint64_t lastKey = 0;
+  written = written && MergeRuns(runs, [&](const RunEntry& entry) {
+    char record[kRecordSize];
+    FormatRecord(entry.key, entry.order & 1, record);
+    if (records > 0 && entry.key == lastKey)
+    {
+      invalid.emplace_back(std::string(record, kAadharLength), (entry.order & 1) ? "1" : "0");
+      return true;
+    }
+    if (records % kRecordsPerPage == 0)
+    {
+      pageKeys.push_back(entry.key);
+    }
+    block.insert(block.end(), record, record + kRecordSize);
+    if (block.size() >= kBlockPages * kPageSize)
+    {
+      outputFile.write(block.data(), block.size());
+      block.clear();
+    }
+    lastKey = entry.key;
+    records++;
+    return static_cast<bool>(outputFile);
+  });
+  outputFile.write(block.data(), block.size());
+  outputFile.close();
+  written = written && static_cast<bool>(outputFile);
+
+  for (const std::string& runPath : runs)
+  {
+    std::remove(runPath.c_str());
+  }
+  if (!written || std::rename(temporary.c_str(), path.c_str()) != 0)
+  {
+    std::remove(temporary.c_str());
+    return false;
+  }
+  return true;
+}
+
+// Rewrites the file with the overlay merged in, in one sequential pass.
+bool VoterStore::MergeOverlay()
+{
+  std::ifstream inputFile(path, std::ios::binary);
+  std::string temporary = path + ".tmp";
+  std::ofstream outputFile(temporary, std::ios::binary);
+  if (!inputFile.is_open() || !outputFile.is_open())
+  {
+    return false;
+  }
+
+  // Record IDs are fixed-width digits, so string order is key order:
+  auto change = overlay.begin();
+  auto emit = [&outputFile](const std::string& aadhar, int status) {
+    outputFile << aadhar << ',' << status << '\n';
+  };
+  std::vector<char> block(kBlockPages * kPageSize);
+  while (inputFile)
+  {
+    inputFile.read(block.data(), block.size());
+    size_t length = inputFile.gcount();
+    for (size_t offset = 0; offset + kRecordSize <= length; offset += kRecordSize)
+    {
+      std::string aadhar(block.data() + offset, kAadharLength);
+      for (; change != overlay.end() && change->first < aadhar; ++change)
+      {
+        if (change->second != kErased)
+        {
+          emit(change->first, change->second);
+        }
+      }
+      if (change != overlay.end() && change->first == aadhar)
+      {
+        if (change->second != kErased)
+        {
+          emit(aadhar, change->second);
+        }
+        ++change;
+      }
+      else
+      {
+        outputFile.write(block.data() + offset, kRecordSize);
+      }
+    }
+  }
+  for (; change != overlay.end(); ++change)
+  {
+    if (change->second != kErased)
+    {
+      emit(change->first, change->second);
+    }
+  }
+
+  outputFile.close();
+  if (!outputFile || std::rename(temporary.c_str(), path.c_str()) != 0)
+  {
+    std::remove(temporary.c_str());
+    return false;
+  }
+  return true;
+}
+
+// Returns the record number of a voter in the file, kNotFound or kUnreadable.
+long VoterStore::FindRecord(const std::string& aadhar)
+{
+  if (records == 0 || !MatchesField<ActiveRules::kAadhar>(aadhar))
+  {
+    return kNotFound;
+  }
+
+  // The in-memory page keys select the only page that can hold the voter:
+  uint64_t key = PackAadhar(aadhar);
+  auto next = std::upper_bound(pageKeys.begin(), pageKeys.end(), key);
+  if (next == pageKeys.begin())
+  {
+    return kNotFound;
+  }
+  size_t page = (next - pageKeys.begin()) - 1;
+
+  const Page* cached = LoadPage(page);
+  if (cached == nullptr)
+  {
+    return kUnreadable;
+  }
+  const char* data = cached->data.data();
+  size_t low = 0;
+  size_t high = std::min(kRecordsPerPage, records - page * kRecordsPerPage);
+  while (low < high)
+  {
+    size_t mid = low + (high - low) / 2;
+    int order = std::memcmp(data + mid * kRecordSize, aadhar.data(), kAadharLength);
+    if (order == 0)
+    {
+      return page * kRecordsPerPage + mid;
+    }
+    if (order < 0)
+    {
+      low = mid + 1;
+    }
+    else
+    {
+      high = mid;
+    }
+  }
+  return kNotFound;
+}
+
+// Returns the start of a record in its cached page, or nullptr if the page
+// could not be read.
+char* VoterStore::Record(size_t record, bool write)
+{
+  Page* page = LoadPage(record / kRecordsPerPage);
+  if (page == nullptr)
+  {
+    return nullptr;
+  }
+  page->dirty = page->dirty || write;
+  return page->data.data() + (record % kRecordsPerPage) * kRecordSize;
+}
+
+// Returns a page from the cache, reading it on a miss, or nullptr if it could
+// not be read. A page that fails to read is not cached.
+VoterStore::Page* VoterStore::LoadPage(uint64_t number)
+{
+  auto cached = pageIndex.find(number);
+  if (cached != pageIndex.end())
+  {
+    hits++;
+    pages.splice(pages.begin(), pages, cached->second);
+    return &pages.front();
+  }
+  misses++;
+
+  // Reuse the least recently used page once the cache is full:
+  if (pages.size() >= cachePages)
+  {
+    WriteBack(pages.back());
+    pageIndex.erase(pages.back().number);
+    pages.splice(pages.begin(), pages, std::prev(pages.end()));
+  }
+  else
+  {
+    pages.push_front(Page{0, std::vector<char>(kPageSize), false});
+  }
+
+  Page& page = pages.front();
+  page.number = number;
+  page.dirty = false;
+  size_t length = std::min(kRecordsPerPage, records - number * kRecordsPerPage) * kRecordSize;
+  // A page that fails to read is dropped, so the next lookup reads it again:
+  if (pread(fd, page.data.data(), length, number * kPageSize) != static_cast<ssize_t>(length))
+  {
+    pages.pop_front();
+    return nullptr;
+  }
+  pageIndex[number] = pages.begin();
+  return &page;
+}
+
+bool VoterStore::WriteBack(Page& page)
+{
+  if (!page.dirty)
+  {
+    return true;
+  }
+  page.dirty = false;
+  size_t length = std::min(kRecordsPerPage, records - page.number * kRecordsPerPage) * kRecordSize;
+  return pwrite(fd, page.data.data(), length, page.number * kPageSize) == static_cast<ssize_t>(length);
+}
@@ -0,0 +1,161 @@
+#ifndef VOTER_STORE
+#define VOTER_STORE
+
+#include "voter_record_file.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <map>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Out-of-core voter roll with a bounded resident size.
+//
+// The roll stays on disk as sorted fixed-width records (the VoterRecordFile
+// format, so the file is still a valid Voter.csv). The records are grouped into
+// pages, and the first key of every page is kept in memory as a sparse index.
+// A lookup therefore binary searches the in-memory keys and then reads at most
+// one page, through an LRU page cache of a fixed size. Status changes are
+// written into the cached pages and written back on eviction or Close.
+// Voters added or removed in a session are kept in a small overlay that Close
+// merges into the file in one sequential pass.
+//
+// A roll that is not yet in the sorted format is bulk loaded with an external
+// merge sort: sorted runs of at most the cache size are written out, then
+// merged sequentially into the record file, a bounded number of runs per pass.
+class VoterStore {
+public:
+    static constexpr size_t kRecordsPerPage = 4096 / VoterRecordFile::kRecordSize;
+    static constexpr size_t kPageSize = kRecordsPerPage * VoterRecordFile::kRecordSize;
+
+    VoterStore() = default;
+    ~VoterStore();
+
+    VoterStore(const VoterStore&) = delete;
+    VoterStore& operator=(const VoterStore&) = delete;
+
+    // Opens a voter roll, converting it to the sorted record format first if
+    // needed.
+    //
+    // Args:
+    //   path: The voter file.
+    //   cacheBytes: The page cache size, which also bounds the bulk load runs.
+    //   invalid: Receives the rows that are malformed or duplicate Aadhar IDs
+    //            during a bulk load; they are not kept in the converted file.
+    //
+    // Returns:
+    //   true if the roll is open, false if it could not be read or converted.
+    bool Open(const std::string& path, size_t cacheBytes, std::vector<std::pair<std::string, std::string>>& invalid);
+
+    // Writes back dirty pages, merges the overlay into the file and closes it.
+    //
+    // Returns:
+    //   true if everything was written, false otherwise.
+    bool Close();
+
+    bool IsOpen() const;
+
+    // Returns the number of registered voters.
+    size_t Size() const;
+
+    // Returns the number of voters marked as voted, by one sequential pass
+    // over the file that bypasses the page cache.
+    size_t CountVoted();
+
+    // Calls a function for every registered voter in Aadhar ID order, by one
+    // sequential pass over the file merged with the overlay.
+    //
+    // Args:
+    //   visitor: Called with the Aadhar ID and voting status of each voter.
+    void Visit(const std::function<void(std::string_view aadhar, bool status)>& visitor);
+
+    bool Contains(const std::string& aadhar);
+
+    // Looks up the voting status of a voter.
+    //
+    // Args:
+    //   aadhar: The voter's Aadhar ID.
+    //   status: Receives the voting status.
+    //
+    // Returns:
+    //   true if the voter is registered, false otherwise.
+    bool GetVotingStatus(const std::string& aadhar, bool& status);
+
+    // Updates the voting status of a registered voter.
+    //
+    // Returns:
+    //   true if the voter is registered, false otherwise.
+    bool SetVotingStatus(const std::string& aadhar, bool status);
+
+    // Registers a voter.
+    //
+    // Returns:
+    //   true if the voter was added, false if the Aadhar ID is already registered
+    //   or its page could not be read.
+    bool Insert(const std::string& aadhar, bool status);
+
+    // Removes a voter.
+    //
+    // Returns:
+    //   true if the voter was removed, false if the Aadhar ID is not registered.
+    bool Erase(const std::string& aadhar);
+
+    // Reads and writes of the page cache that hit and missed.
+    uint64_t CacheHits() const;
+    uint64_t CacheMisses() const;
+
+private:
+    static const int kErased = -1;  // Overlay value of a removed voter.
+    static const long kNotFound = -1;    // FindRecord: the voter is not in the file.
+    static const long kUnreadable = -2;  // FindRecord: the voter's page could not be read.
+
+    struct Page {
+        uint64_t number;
+        std::vector<char> data;
+        bool dirty;
+    };
+
+    // Checks that the file holds sorted records and builds the page keys.
+    bool Scan();
+
+    // Converts the file to sorted records with an external merge sort.
+    bool BulkLoad(std::vector<std::pair<std::string, std::string>>& invalid);
+
+    // Rewrites the file with the overlay merged in, in one sequential pass.
+    bool MergeOverlay();
+
+    // Returns the record number of a voter in the file, kNotFound or kUnreadable.
+    long FindRecord(const std::string& aadhar);
+
+    // Returns the start of a record in its cached page, or nullptr if the page
+    // could not be read.
+    char* Record(size_t record, bool write);
+
+    // Returns a page from the cache, reading it on a miss, or nullptr if it
+    // could not be read. A page that fails to read is not cached.
+    Page* LoadPage(uint64_t number);
+    bool WriteBack(Page& page);
+
+    std::string path;
+    size_t cacheBytes = 0;
+    size_t cachePages = 0;
+    int fd = -1;
+    size_t records = 0;  // Records in the file.
+    size_t count = 0;    // Registered voters, with the overlay applied.
+    std::vector<uint64_t> pageKeys;  // Packed Aadhar ID of the first record of each page.
+
+    std::list<Page> pages;  // Cached pages, most recently used first.
+    std::unordered_map<uint64_t, std::list<Page>::iterator> pageIndex;
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+
+    // Aadhar ID -> status of a voter added or changed in the overlay, or kErased.
+    std::map<std::string, int> overlay;
+};
+
+#endif